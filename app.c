@@ -68,9 +68,8 @@ static uint8_t lpnCount = 0;
 
 
 //Storage types for peristent data
-float high_temp = 0;
+int32_t high_temp = INT32_MIN;
 uint8_t authorized_personnel = 0;
-static uint8_t buttonPressed = 0;
 
 
 /// Flag for indicating that initialization was performed
@@ -94,6 +93,8 @@ static void initiate_factory_reset(void)
 
   /* perform a factory reset by erasing PS storage. This removes all the keys and other settings
      that have been configured for this node */
+  psCacheDiscard();
+  countersReset();
   BTSTACK_CHECK_RESPONSE(gecko_cmd_flash_ps_erase_all());
   // reboot after a small delay
   BTSTACK_CHECK_RESPONSE(gecko_cmd_hardware_set_soft_timer(2 * 32768, TIMER_ID_FACTORY_RESET, 1));
@@ -110,7 +111,7 @@ static void set_device_name(bd_addr *pAddr)
   char name[20];
   uint16_t res;
   // create unique device name using the last two bytes of the Bluetooth address
-  sprintf(name, "5823Sub %02x:%02x", pAddr->addr[1], pAddr->addr[0]);
+  fmtSnprintf(name, sizeof(name), "5823Sub %02x:%02x", pAddr->addr[1], pAddr->addr[0]);
 
   LOG_INFO("Device name: '%s", name);
 
@@ -145,6 +146,7 @@ void gecko_bgapi_classes_init(void)
   //gecko_bgapi_class_mesh_proxy_client_init();
   //gecko_bgapi_class_mesh_generic_client_init();
   gecko_bgapi_class_mesh_generic_server_init();
+  gecko_bgapi_class_mesh_sensor_client_init();
 //  gecko_bgapi_class_mesh_vendor_model_init();
   //gecko_bgapi_class_mesh_health_client_init();
   //gecko_bgapi_class_mesh_health_server_init();
@@ -169,6 +171,7 @@ void handle_ecen5823_gecko_event(uint32_t evt_id, struct gecko_cmd_packet *evt)
 {
 	  uint16_t result;
 	  char buf[30];
+	  lpn_entry_t *lpn;
 
 	  if (NULL == evt)
 	  {
@@ -188,13 +191,18 @@ void handle_ecen5823_gecko_event(uint32_t evt_id, struct gecko_cmd_packet *evt)
 	        struct gecko_msg_system_get_bt_address_rsp_t *pAddr = gecko_cmd_system_get_bt_address();
 
 	        set_device_name(&pAddr->address);
+	        historyExportInit();
+	        telemetryInit();
+#if ENERGY_REPORT_S
+	        BTSTACK_CHECK_RESPONSE(gecko_cmd_hardware_set_soft_timer(ENERGY_REPORT_S * 32768UL, TIMER_ID_ENERGY_REPORT, 0));
+#endif
 
 	        // Initialize Mesh stack in Node operation mode, it will generate initialized event
 	        result = gecko_cmd_mesh_node_init()->result;
 
 	        if (result)
 	        {
-	          sprintf(buf, "init failed (0x%x)", result);
+	          fmtSnprintf(buf, sizeof(buf), "init failed (0x%x)", result);
 	          displayPrintf(DISPLAY_ROW_TEMPERATURE, buf);
 	        }
 	      }
@@ -208,14 +216,35 @@ void handle_ecen5823_gecko_event(uint32_t evt_id, struct gecko_cmd_packet *evt)
 				break;
 	        case TIMER_ID_FACTORY_RESET:
 	          // reset the device to finish factory reset
+	          journalFlush();
+	          logFlush();
 	          gecko_cmd_system_reset(0);
 	          break;
 
 	        case TIMER_ID_RESTART:
 	          // restart timer expires, reset the device
+	          psCacheFlush();
+	          journalFlush();
+	          logFlush();
 	          gecko_cmd_system_reset(0);
 	          break;
 
+	        case TIMER_ID_PS_FLUSH:
+	          psCacheFlush();
+	          break;
+
+	        case TIMER_ID_HISTORY_EXPORT:
+	          historyExportPump();
+	          break;
+
+	        case TIMER_ID_TELEMETRY:
+	          telemetryTimer();
+	          break;
+
+	        case TIMER_ID_ENERGY_REPORT:
+	          energyReport();
+	          break;
+
 	        case TIMER_ID_PROVISIONING:
 	          // toggle LED to indicate the provisioning state
 	          if (!init_done)
@@ -239,12 +268,25 @@ void handle_ecen5823_gecko_event(uint32_t evt_id, struct gecko_cmd_packet *evt)
 	      {
 	        LOG_INFO("mesh_generic_server_init failed, code 0x%x", result);
 	      }
+	      // Sensor client receives the Sensor Status published by the patient LPNs
+	      result = gecko_cmd_mesh_sensor_client_init()->result;
+	      if (result)
+	      {
+	        LOG_INFO("mesh_sensor_client_init failed, code 0x%x", result);
+	      }
 
-	      psDataLoad(BUTTON_COUNT, &buttonPressed, sizeof(buttonPressed));
-	      LOG_INFO("******ALERTS CLEARED******** %d ***********", buttonPressed);
-	      psDataLoad(MAX_TEMP, &high_temp, sizeof(high_temp));
-	      LOG_INFO("******HIGHEST TEMPERATURE RECORDED******** %f ***********", high_temp);
-	      psDataLoad(AUTHORIZED_PERSONNEL, &authorized_personnel, sizeof(authorized_personnel));
+	      psCacheInit();
+	      countersInit();
+	      if(counterCreated(COUNTER_ALERTS_CLEARED))
+	      {
+	    	  uint8_t legacy_count = 0;
+	    	  psCacheRead(BUTTON_COUNT, &legacy_count, sizeof(legacy_count)); //Count kept in a PS key before the NVM3 counters
+	    	  counterSet(COUNTER_ALERTS_CLEARED, legacy_count);
+	      }
+	      LOG_INFO("******ALERTS CLEARED******** %"PRIu32" ***********", counterGet(COUNTER_ALERTS_CLEARED));
+	      psCacheRead(MAX_TEMP, &high_temp, sizeof(high_temp));
+	      LOG_INFO("******HIGHEST TEMPERATURE RECORDED******** %"PRId32" (0.01 C) ***********", high_temp);
+	      psCacheRead(AUTHORIZED_PERSONNEL, &authorized_personnel, sizeof(authorized_personnel));
 	      if(authorized_personnel)
 	      {
 	    	  LOG_INFO("Authorized personnel present in room");
@@ -259,7 +301,7 @@ void handle_ecen5823_gecko_event(uint32_t evt_id, struct gecko_cmd_packet *evt)
 
 	      if (pData->provisioned)
 	      {
-	        LOG_INFO("node is provisioned. address:%x, ivi:%ld", pData->address, pData->ivi);
+	        LOG_INFO("node is provisioned. address:%x, ivi:%"PRIu32"", pData->address, pData->ivi);
 
 	        _my_address = pData->address;
 	        enable_button_interrupts();
@@ -317,63 +359,13 @@ void handle_ecen5823_gecko_event(uint32_t evt_id, struct gecko_cmd_packet *evt)
 	      mesh_lib_generic_server_event_handler(evt);
 	      break;
 
-	      case gecko_evt_system_external_signal_id:
-	      {
-//	    	  	  struct mesh_generic_state req;
-					if ((evt->data.evt_system_external_signal.extsignals) == 0x01)
-					{
-//						LOG_INFO("In external signal 0x01");
-						state(); //Calling state machine implementation
-						Hum_Buffer(); //Loading humidity buffer with appropriate values
-					}
-					else if (((evt->data.evt_system_external_signal.extsignals) >= 0x02) && ((evt->data.evt_system_external_signal.extsignals) <= 0x06))
-					{
-//						LOG_INFO("In external signal 0x02-0x06");
-						state(); //Calling state machine implementation
-					}
-					if ((evt->data.evt_system_external_signal.extsignals) == 0x40)
-					{
-						clearAlert();
-//						  req.kind = mesh_generic_state_on_off;
-						  if(GPIO_PinInGet(PB0_Port, PB0_Pin) == 0)
-						  {
-//							  req.on_off.on = MESH_GENERIC_ON_OFF_STATE_ON;
-							  displayPrintf(DISPLAY_ROW_ALERT_CARETAKER,"Alert Cleared");
-							  displayPrintf(DISPLAY_ROW_ALERT_PATIENT,"Alert Cleared");
-							  buttonPressed++;
-							  psDataSave(BUTTON_COUNT, &buttonPressed, sizeof(buttonPressed));
-							  LOG_INFO("Alert cleared");
-						  }
-/*Code to Publish data (Not supported by SDK)*/
-/*						  mesh_lib_generic_server_update(MESH_GENERIC_ON_OFF_SERVER_MODEL_ID,
-																   0,
-																   NULL,
-																   &req,
-																   0);
-						  uint16_t resp = mesh_lib_generic_server_publish(MESH_GENERIC_ON_OFF_SERVER_MODEL_ID, 0, mesh_generic_state_on_off);
-						  LOG_INFO("\n\r**************parameter data = %d**********************\n\r", req.on_off.on);
-
-						  if (resp)
-						  {
-							  LOG_INFO("gecko_cmd_mesh_generic_client_publish failed, code 0x%x\r\n", resp);
-						  }	*/
-
-					}
-					if ((evt->data.evt_system_external_signal.extsignals) == 0x50)
-					{
-						if (authorized_personnel)
-						{
-							clearAlert();
-						}
-						else
-						{
-							redAlert();
-							displayPrintf(DISPLAY_ROW_ALERT_CARETAKER, "Unauthorized person");
-						}
-						LOG_INFO("******************HUMAN DETECTED*********************");
-					}
-	      }
-					break;
+	    case gecko_evt_system_external_signal_id:
+	      signalDispatch(evt->data.evt_system_external_signal.extsignals);
+	      break;
+
+	    case gecko_evt_mesh_sensor_client_status_id:
+	      sensor_status(&evt->data.evt_mesh_sensor_client_status);
+	      break;
 
 	    case gecko_evt_mesh_generic_server_state_changed_id:
 	      mesh_lib_generic_server_event_handler(evt);
@@ -391,8 +383,19 @@ void handle_ecen5823_gecko_event(uint32_t evt_id, struct gecko_cmd_packet *evt)
 	      break;
 
 	    case gecko_evt_mesh_friend_friendship_established_id:
-	      printf("evt gecko_evt_mesh_friend_friendship_established, lpn_address=%x\r\n", evt->data.evt_mesh_friend_friendship_established.lpn_address);
+	      LOG_INFO("evt gecko_evt_mesh_friend_friendship_established, lpn_address=%x", evt->data.evt_mesh_friend_friendship_established.lpn_address);
+	      lpn = lpnRegistryAdd(evt->data.evt_mesh_friend_friendship_established.lpn_address);
+	      if(lpn == NULL)
+	      {
+	    	  LOG_ERROR("Invalid LPN address");
+	      }
+	      else if((lpn->role == LPN_ROLE_CARETAKER) && (lpn->messages == 0))
+	      {
+	    	  lpn->present = authorized_personnel; //Presence persisted before a reset
+	      }
 	      lpnCount++;
+	      counterIncrement(COUNTER_FRIENDSHIPS_ESTABLISHED);
+	      journalAppend(JOURNAL_FRIENDSHIP, evt->data.evt_mesh_friend_friendship_established.lpn_address, 1, 0);
 	      LOG_INFO("Number of LPNs in mesh - %d",lpnCount);
 	      displayPrintf(DISPLAY_ROW_FRIEND, "FRIEND -- %d LPNs", lpnCount);
 			/*	Initialize timer	*/
@@ -401,8 +404,10 @@ void handle_ecen5823_gecko_event(uint32_t evt_id, struct gecko_cmd_packet *evt)
 	      break;
 
 	    case gecko_evt_mesh_friend_friendship_terminated_id:
-	      printf("evt gecko_evt_mesh_friend_friendship_terminated, reason=%x\r\n", evt->data.evt_mesh_friend_friendship_terminated.reason);
+	      LOG_INFO("evt gecko_evt_mesh_friend_friendship_terminated, reason=%x", evt->data.evt_mesh_friend_friendship_terminated.reason);
 	      lpnCount--;
+	      counterIncrement(COUNTER_FRIENDSHIPS_TERMINATED);
+	      journalAppend(JOURNAL_FRIENDSHIP, JOURNAL_ADDRESS_LOCAL, 0, evt->data.evt_mesh_friend_friendship_terminated.reason);
 	      LOG_INFO("Number of LPNs in mesh - %d",lpnCount);
 	      displayPrintf(DISPLAY_ROW_FRIEND,"FRIEND -- %d LPNs", lpnCount);
 	      break;
@@ -422,17 +427,33 @@ void handle_ecen5823_gecko_event(uint32_t evt_id, struct gecko_cmd_packet *evt)
 
 	    case gecko_evt_le_connection_parameters_id:
 	      LOG_INFO("evt:gecko_evt_le_connection_parameters_id");
+	      historyExportConnectionParameters(evt->data.evt_le_connection_parameters.connection,
+	                                        evt->data.evt_le_connection_parameters.interval);
+	      break;
+
+	    case gecko_evt_gatt_mtu_exchanged_id:
+	      historyExportMtu(evt->data.evt_gatt_mtu_exchanged.connection, evt->data.evt_gatt_mtu_exchanged.mtu);
+	      break;
+
+	    case gecko_evt_gatt_server_characteristic_status_id:
+	      historyExportStatus(&evt->data.evt_gatt_server_characteristic_status);
+	      telemetryStatus(&evt->data.evt_gatt_server_characteristic_status);
 	      break;
 
 	    case gecko_evt_le_connection_closed_id:
 	      /* Check if need to boot to dfu mode */
 	      if (boot_to_dfu) {
 	        /* Enter to DFU OTA mode */
+	        psCacheFlush();
+	        journalFlush();
+	        logFlush();
 	        gecko_cmd_system_reset(2);
 	      }
 
 	      LOG_INFO("evt:conn closed, reason 0x%x", evt->data.evt_le_connection_closed.reason);
 	      conn_handle = 0xFF;
+	      historyExportConnectionClosed(evt->data.evt_le_connection_closed.connection);
+	      telemetryConnectionClosed(evt->data.evt_le_connection_closed.connection);
 	      if (num_connections > 0) {
 	        if (--num_connections == 0) {
 	        	displayPrintf(DISPLAY_ROW_CONNECTION, "");
@@ -452,6 +473,18 @@ void handle_ecen5823_gecko_event(uint32_t evt_id, struct gecko_cmd_packet *evt)
 	        /* Close connection to enter to DFU OTA mode */
 	        BTSTACK_CHECK_RESPONSE(gecko_cmd_le_connection_close(evt->data.evt_gatt_server_user_write_request.connection));
 	      }
+	      else if (evt->data.evt_gatt_server_user_write_request.characteristic == gattdb_history_control) {
+	        historyExportControl(&evt->data.evt_gatt_server_user_write_request);
+	      }
+	      else if (evt->data.evt_gatt_server_user_write_request.characteristic == gattdb_event_profile) {
+	        profileControl(&evt->data.evt_gatt_server_user_write_request);
+	      }
+	      break;
+
+	    case gecko_evt_gatt_server_user_read_request_id:
+	      if (evt->data.evt_gatt_server_user_read_request.characteristic == gattdb_event_profile) {
+	        profileRead(&evt->data.evt_gatt_server_user_read_request);
+	      }
 	      break;
 
 
@@ -462,56 +495,85 @@ void handle_ecen5823_gecko_event(uint32_t evt_id, struct gecko_cmd_packet *evt)
 }
 
 /*
- * @brief	Initialize server register handles
+ * @brief	I2C transfer finished, advance the humidity state machine
  */
-void init_all_models()
+static void i2c_signal_handler(void)
 {
-	LOG_INFO("***********Initializing all models************");
-	errorcode_t mesh_reg_response = mesh_lib_generic_server_register_handler(MESH_GENERIC_ON_OFF_SERVER_MODEL_ID, 0, onoff_request,NULL, NULL);
-	if(mesh_reg_response != 0)
-	{
-		LOG_ERROR("Handler register failed with %d response",mesh_reg_response);
-	}
-	mesh_reg_response = mesh_lib_generic_server_register_handler(MESH_GENERIC_LEVEL_SERVER_MODEL_ID, 0, level_request, 0, NULL);
-	if(mesh_reg_response != 0)
-	{
-		LOG_ERROR("Handler register failed with %d response",mesh_reg_response);
-	}
+	state(HUM_EVENT_I2C_DONE); //Calling state machine implementation
 }
 
 /*
- * @brief	Store data in persistent memory
- *
+ * @brief	LETIMER period expired, start a humidity measurement
  */
-void psDataSave(uint16_t key, void *value, uint8_t size)
+static void period_signal_handler(void)
 {
-	struct gecko_msg_flash_ps_save_rsp_t *resp;
-
-	resp = gecko_cmd_flash_ps_save(key, size, value);
+	state(HUM_EVENT_PERIOD); //Calling state machine implementation
+}
 
-	if(resp->result != 0)
+/*
+ * @brief	Clear alerts when PB0 is pressed
+ */
+static void button_signal_handler(void)
+{
+	clearAlert();
+	telemetryAlertsClear();
+	if(GPIO_PinInGet(PB0_Port, PB0_Pin) == 0)
 	{
-		LOG_ERROR("Error saving data\r\n");
+		displayPrintf(DISPLAY_ROW_ALERT_CARETAKER,"Alert Cleared");
+		displayPrintf(DISPLAY_ROW_ALERT_PATIENT,"Alert Cleared");
+		journalAppend(JOURNAL_ALERTS_CLEARED, JOURNAL_ADDRESS_LOCAL, counterIncrement(COUNTER_ALERTS_CLEARED), 0);
+		LOG_INFO("Alert cleared");
 	}
-
 }
 
 /*
- * @brief	Load data from persistent memory
+ * @brief	Raise an alert when the PIR detects someone without the caretaker present
  */
-void psDataLoad(uint16_t key, void *value, uint8_t size)
+static void motion_signal_handler(void)
 {
-	struct gecko_msg_flash_ps_load_rsp_t *resp;
+	if (authorized_personnel)
+	{
+		clearAlert();
+		telemetryAlertsClear();
+	}
+	else
+	{
+		redAlert();
+		telemetryAlertSet(TELEMETRY_ALERT_INTRUSION);
+		counterIncrement(COUNTER_INTRUSIONS);
+		journalAppend(JOURNAL_INTRUSION, JOURNAL_ADDRESS_LOCAL, 0, 0);
+		displayPrintf(DISPLAY_ROW_ALERT_CARETAKER, "Unauthorized person");
+	}
+	LOG_INFO("******************HUMAN DETECTED*********************");
+}
 
-	resp = gecko_cmd_flash_ps_load(key);
+/*
+ * @brief	Register handlers for external signals
+ */
+void init_signal_handlers(void)
+{
+	signalHandlerRegister(SIGNAL_I2C_DONE, i2c_signal_handler);
+	signalHandlerRegister(SIGNAL_LETIMER_COMP1, timerProcessExpired);
+	signalHandlerRegister(SIGNAL_LETIMER_UF, period_signal_handler);
+	signalHandlerRegister(SIGNAL_PB0, button_signal_handler);
+	signalHandlerRegister(SIGNAL_PIR, motion_signal_handler);
+}
 
-	if(resp->result == 0)
+/*
+ * @brief	Initialize server register handles
+ */
+void init_all_models()
+{
+	LOG_INFO("***********Initializing all models************");
+	errorcode_t mesh_reg_response = mesh_lib_generic_server_register_handler(MESH_GENERIC_ON_OFF_SERVER_MODEL_ID, 0, onoff_request,NULL, NULL);
+	if(mesh_reg_response != 0)
 	{
-		memcpy(value, resp->value.data, resp->value.len);
+		LOG_ERROR("Handler register failed with %d response",mesh_reg_response);
 	}
-	else
+	mesh_reg_response = mesh_lib_generic_server_register_handler(MESH_GENERIC_LEVEL_SERVER_MODEL_ID, 0, level_request, 0, NULL);
+	if(mesh_reg_response != 0)
 	{
-		LOG_ERROR("Error loading data\r\n");
+		LOG_ERROR("Handler register failed with %d response",mesh_reg_response);
 	}
 }
 
@@ -521,11 +583,12 @@ void psDataLoad(uint16_t key, void *value, uint8_t size)
 void friendInit(void)
 {
 	static uint16_t result = 0;
-    mesh_lib_init(malloc, free, 11);
+    lpnRegistryInit();
+    mesh_lib_init(NULL, NULL, MESH_LIB_STATIC_MODELS); //Static registrations, no heap
     result = gecko_cmd_mesh_friend_init()->result;
     if (result)
     {
-      printf("*******************Friend init failed 0x%x\r\n", result);
+      LOG_ERROR("*******************Friend init failed 0x%x", result);
     }
 }
 
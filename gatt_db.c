@@ -38,11 +38,75 @@ GATT_DATA(const uint8_t bg_gattdb_data_uuidtable_128_map [])=
 {
 0xf0, 0x19, 0x21, 0xb4, 0x47, 0x8f, 0xa4, 0xbf, 0xa1, 0x4f, 0x63, 0xfd, 0xee, 0xd6, 0x14, 0x1d, 
 0x63, 0x60, 0x32, 0xe0, 0x37, 0x5e, 0xa4, 0x88, 0x53, 0x4e, 0x6d, 0xfb, 0x64, 0x35, 0xbf, 0xf7, 
+0x10, 0x4c, 0x7d, 0x2e, 0x5a, 0x0b, 0x61, 0x9f, 0x8d, 0x4e, 0x2b, 0x7c, 0x01, 0x00, 0x4c, 0x3a, 
+0x10, 0x4c, 0x7d, 0x2e, 0x5a, 0x0b, 0x61, 0x9f, 0x8d, 0x4e, 0x2b, 0x7c, 0x02, 0x00, 0x4c, 0x3a, 
+0x10, 0x4c, 0x7d, 0x2e, 0x5a, 0x0b, 0x61, 0x9f, 0x8d, 0x4e, 0x2b, 0x7c, 0x03, 0x00, 0x4c, 0x3a, 
+0x10, 0x4c, 0x7d, 0x2e, 0x5a, 0x0b, 0x61, 0x9f, 0x8d, 0x4e, 0x2b, 0x7c, 0x10, 0x00, 0x4c, 0x3a, 
+0x10, 0x4c, 0x7d, 0x2e, 0x5a, 0x0b, 0x61, 0x9f, 0x8d, 0x4e, 0x2b, 0x7c, 0x11, 0x00, 0x4c, 0x3a, 
+0x10, 0x4c, 0x7d, 0x2e, 0x5a, 0x0b, 0x61, 0x9f, 0x8d, 0x4e, 0x2b, 0x7c, 0x20, 0x00, 0x4c, 0x3a, 
+0x10, 0x4c, 0x7d, 0x2e, 0x5a, 0x0b, 0x61, 0x9f, 0x8d, 0x4e, 0x2b, 0x7c, 0x21, 0x00, 0x4c, 0x3a, 
 };
 
 
 
 
+GATT_DATA(const struct bg_gattdb_attribute_chrvalue	bg_gattdb_data_attribute_field_43 ) = {
+	.properties=0x0a,
+	.index=12,
+	.max_len=0,
+	.data=NULL,
+};
+
+GATT_DATA(const struct bg_gattdb_buffer_with_len	bg_gattdb_data_attribute_field_42 ) = {
+	.len=19,
+	.data={0x0a,0x2c,0x00,0x10,0x4c,0x7d,0x2e,0x5a,0x0b,0x61,0x9f,0x8d,0x4e,0x2b,0x7c,0x21,0x00,0x4c,0x3a,}
+};
+GATT_DATA(const struct bg_gattdb_buffer_with_len	bg_gattdb_data_attribute_field_41 ) = {
+	.len=16,
+	.data={0x10,0x4c,0x7d,0x2e,0x5a,0x0b,0x61,0x9f,0x8d,0x4e,0x2b,0x7c,0x20,0x00,0x4c,0x3a,}
+};
+uint8_t bg_gattdb_data_attribute_field_39_data[15]={0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,};
+GATT_DATA(const struct bg_gattdb_attribute_chrvalue	bg_gattdb_data_attribute_field_39 ) = {
+	.properties=0x12,
+	.index=11,
+	.max_len=15,
+	.data=bg_gattdb_data_attribute_field_39_data,
+};
+
+GATT_DATA(const struct bg_gattdb_buffer_with_len	bg_gattdb_data_attribute_field_38 ) = {
+	.len=19,
+	.data={0x12,0x28,0x00,0x10,0x4c,0x7d,0x2e,0x5a,0x0b,0x61,0x9f,0x8d,0x4e,0x2b,0x7c,0x11,0x00,0x4c,0x3a,}
+};
+GATT_DATA(const struct bg_gattdb_buffer_with_len	bg_gattdb_data_attribute_field_37 ) = {
+	.len=16,
+	.data={0x10,0x4c,0x7d,0x2e,0x5a,0x0b,0x61,0x9f,0x8d,0x4e,0x2b,0x7c,0x10,0x00,0x4c,0x3a,}
+};
+GATT_DATA(const struct bg_gattdb_attribute_chrvalue	bg_gattdb_data_attribute_field_35 ) = {
+	.properties=0x10,
+	.index=10,
+	.max_len=0,
+	.data=NULL,
+};
+
+GATT_DATA(const struct bg_gattdb_buffer_with_len	bg_gattdb_data_attribute_field_34 ) = {
+	.len=19,
+	.data={0x10,0x24,0x00,0x10,0x4c,0x7d,0x2e,0x5a,0x0b,0x61,0x9f,0x8d,0x4e,0x2b,0x7c,0x03,0x00,0x4c,0x3a,}
+};
+GATT_DATA(const struct bg_gattdb_attribute_chrvalue	bg_gattdb_data_attribute_field_33 ) = {
+	.properties=0x08,
+	.index=9,
+	.max_len=0,
+	.data=NULL,
+};
+
+GATT_DATA(const struct bg_gattdb_buffer_with_len	bg_gattdb_data_attribute_field_32 ) = {
+	.len=19,
+	.data={0x08,0x22,0x00,0x10,0x4c,0x7d,0x2e,0x5a,0x0b,0x61,0x9f,0x8d,0x4e,0x2b,0x7c,0x02,0x00,0x4c,0x3a,}
+};
+GATT_DATA(const struct bg_gattdb_buffer_with_len	bg_gattdb_data_attribute_field_31 ) = {
+	.len=16,
+	.data={0x10,0x4c,0x7d,0x2e,0x5a,0x0b,0x61,0x9f,0x8d,0x4e,0x2b,0x7c,0x01,0x00,0x4c,0x3a,}
+};
 GATT_DATA(const struct bg_gattdb_attribute_chrvalue	bg_gattdb_data_attribute_field_30 ) = {
 	.properties=0x08,
 	.index=8,
@@ -221,6 +285,19 @@ GATT_DATA(const struct bg_gattdb_attribute bg_gattdb_data_attributes_map[])={
     {.uuid=0x0000,.permissions=0x801,.caps=0x04,.datatype=0x00,.constdata=&bg_gattdb_data_attribute_field_28},
     {.uuid=0x0002,.permissions=0x801,.caps=0x04,.datatype=0x00,.constdata=&bg_gattdb_data_attribute_field_29},
     {.uuid=0x8001,.permissions=0x802,.caps=0x04,.datatype=0x07,.dynamicdata=&bg_gattdb_data_attribute_field_30},
+    {.uuid=0x0000,.permissions=0x801,.caps=0x04,.datatype=0x00,.constdata=&bg_gattdb_data_attribute_field_31},
+    {.uuid=0x0002,.permissions=0x801,.caps=0x04,.datatype=0x00,.constdata=&bg_gattdb_data_attribute_field_32},
+    {.uuid=0x8003,.permissions=0x802,.caps=0x04,.datatype=0x07,.dynamicdata=&bg_gattdb_data_attribute_field_33},
+    {.uuid=0x0002,.permissions=0x801,.caps=0x04,.datatype=0x00,.constdata=&bg_gattdb_data_attribute_field_34},
+    {.uuid=0x8004,.permissions=0x800,.caps=0x04,.datatype=0x07,.dynamicdata=&bg_gattdb_data_attribute_field_35},
+    {.uuid=0x0012,.permissions=0x807,.caps=0x04,.datatype=0x03,.configdata={.flags=0x01,.index=0x0a,.clientconfig_index=0x03}},
+    {.uuid=0x0000,.permissions=0x801,.caps=0x04,.datatype=0x00,.constdata=&bg_gattdb_data_attribute_field_37},
+    {.uuid=0x0002,.permissions=0x801,.caps=0x04,.datatype=0x00,.constdata=&bg_gattdb_data_attribute_field_38},
+    {.uuid=0x8006,.permissions=0x801,.caps=0x04,.datatype=0x01,.dynamicdata=&bg_gattdb_data_attribute_field_39},
+    {.uuid=0x0012,.permissions=0x807,.caps=0x04,.datatype=0x03,.configdata={.flags=0x01,.index=0x0b,.clientconfig_index=0x04}},
+    {.uuid=0x0000,.permissions=0x801,.caps=0x04,.datatype=0x00,.constdata=&bg_gattdb_data_attribute_field_41},
+    {.uuid=0x0002,.permissions=0x801,.caps=0x04,.datatype=0x00,.constdata=&bg_gattdb_data_attribute_field_42},
+    {.uuid=0x8008,.permissions=0x803,.caps=0x04,.datatype=0x07,.dynamicdata=&bg_gattdb_data_attribute_field_43},
 };
 
 GATT_DATA(const uint16_t bg_gattdb_data_attributes_dynamic_mapping_map[])={
@@ -233,18 +310,22 @@ GATT_DATA(const uint16_t bg_gattdb_data_attributes_dynamic_mapping_map[])={
 	0x0019,
 	0x001b,
 	0x001f,
+	0x0022,
+	0x0024,
+	0x0028,
+	0x002c,
 };
 
 GATT_DATA(const uint8_t bg_gattdb_data_adv_uuid16_map[])={0x0};
 GATT_DATA(const uint8_t bg_gattdb_data_adv_uuid128_map[])={0x0};
 GATT_HEADER(const struct bg_gattdb_def bg_gattdb_data)={
     .attributes=bg_gattdb_data_attributes_map,
-    .attributes_max=31,
+    .attributes_max=44,
     .uuidtable_16_size=19,
     .uuidtable_16=bg_gattdb_data_uuidtable_16_map,
-    .uuidtable_128_size=2,
+    .uuidtable_128_size=9,
     .uuidtable_128=bg_gattdb_data_uuidtable_128_map,
-    .attributes_dynamic_max=9,
+    .attributes_dynamic_max=13,
     .attributes_dynamic_mapping=bg_gattdb_data_attributes_dynamic_mapping_map,
     .adv_uuid16=bg_gattdb_data_adv_uuid16_map,
     .adv_uuid16_num=0,
@@ -18,6 +18,10 @@ extern const struct bg_gattdb_def bg_gattdb_data;
 #define gattdb_client_support_features          8
 #define gattdb_device_name                     11
 #define gattdb_ota_control                     31
+#define gattdb_history_control                 34
+#define gattdb_history_data                    36
+#define gattdb_live_telemetry                  40
+#define gattdb_event_profile                   44
 
 typedef enum
 {
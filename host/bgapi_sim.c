@@ -0,0 +1,497 @@
+/*
+ * @filename	: bgapi_sim.c
+ * @description	: This file contains the BGAPI stack model of the host simulation
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * The inline gecko_cmd_ functions of native_gecko.h fill gecko_cmd_msg_buf and
+ * call the sli_bt_cmd_ handler of the command through
+ * sli_bt_cmd_handler_delegate(), which the stack library provides on target.
+ * Here the handlers that the application depends on are modelled: soft
+ * timers, PS keys, notifications with a per interval budget, the ATT MTU of
+ * read responses and reset.  Every
+ * other command succeeds without doing anything.
+ *
+ * gecko_wait_event() is where the virtual time moves.  With no event queued it
+ * jumps to the next script line, swarm action, soft timer or LETIMER0
+ * interrupt, and returns NULL once the script is done and nothing is queued.
+ * While a trace is replayed it jumps to the next trace record or LETIMER0
+ * interrupt.  The node sleeps through each jump, see simSleep().
+ *
+ * gecko_stack_init() gives the SLEEP driver the stack callbacks and blocks
+ * EM3, as the stack keeps its sleep clock running.
+ */
+
+#include "sim.h"
+#include "native_gecko.h"
+#include "log.h"
+#include "sleep.h"
+#include <string.h>
+
+#define SIM_EVENT_QUEUE		64
+#define SIM_PACKET_MAX		(sizeof(struct gecko_cmd_packet) + 256)	//Room for a uint8array of 255 bytes
+#define SIM_RSP_CLEAR		64
+#define SIM_SOFT_TIMERS		256
+#define SIM_PS_KEYS			64
+#define SIM_PS_VALUE_MAX	256
+#define SIM_CONNECTIONS		8
+#define SIM_DEFAULT_MTU		23
+
+typedef union
+{
+	struct gecko_cmd_packet packet;
+	uint8_t raw[SIM_PACKET_MAX];
+}sim_packet_t;
+
+typedef struct
+{
+	bool active;
+	bool single_shot;
+	uint64_t deadline;
+	uint32_t period;
+}sim_soft_timer_t;
+
+typedef struct
+{
+	bool used;
+	uint16_t key;
+	uint8_t len;
+	uint8_t value[SIM_PS_VALUE_MAX];
+}sim_ps_key_t;
+
+sim_stats_t sim_stats;
+
+static sim_packet_t sim_cmd;
+static sim_packet_t sim_rsp;
+void *gecko_cmd_msg_buf = &sim_cmd;
+void *gecko_rsp_msg_buf = &sim_rsp;
+
+static sim_packet_t sim_queue[SIM_EVENT_QUEUE];
+static uint16_t sim_queue_head = 0;
+static uint16_t sim_queue_count = 0;
+static sim_packet_t sim_event;					//Event handed to the application
+static uint32_t sim_signals = 0;				//Posted with gecko_external_signal(), not delivered yet
+
+static sim_soft_timer_t sim_timers[SIM_SOFT_TIMERS];
+static uint16_t sim_timers_used = 0;			//Highest handle set plus one
+static sim_ps_key_t sim_ps[SIM_PS_KEYS];
+static uint16_t sim_notify_budget = SIM_NOTIFY_UNLIMITED;
+static uint16_t sim_notify_sent = 0;
+static uint16_t sim_mtu[SIM_CONNECTIONS];		//0 until exchanged
+static bool sim_reset = false;
+
+/*******************************************************************************
+ * Events
+ ******************************************************************************/
+
+void simEventPush(uint32_t id, const void *data, uint16_t len)
+{
+	sim_packet_t *slot;
+
+	if((sim_queue_count == SIM_EVENT_QUEUE) || (len > (SIM_PACKET_MAX - BGLIB_MSG_HEADER_LEN)))
+	{
+		LOG_ERROR("Simulated event 0x%08lx dropped", (unsigned long)id);
+		return;
+	}
+	slot = &sim_queue[(sim_queue_head + sim_queue_count) % SIM_EVENT_QUEUE];
+	slot->packet.header = id | ((uint32_t)(len & 0xFF) << 8) | ((len >> 8) & 0x7);
+	if(len)
+	{
+		memcpy(&slot->packet.data, data, len);
+	}
+	sim_queue_count++;
+}
+
+void gecko_external_signal(uint32 signals)
+{
+	if(!simReplayActive())	//A replay has the signal events in the trace
+	{
+		sim_signals |= signals;
+	}
+}
+
+int gecko_event_pending(void)
+{
+	return (sim_queue_count != 0) || (sim_signals != 0);
+}
+
+struct gecko_cmd_packet *gecko_peek_event(void)
+{
+	const sim_packet_t *slot;
+
+	if(sim_queue_count)
+	{
+		slot = &sim_queue[sim_queue_head];
+		memcpy(&sim_event, slot, BGLIB_MSG_HEADER_LEN + BGLIB_MSG_LEN(slot->packet.header));
+		sim_queue_head = (sim_queue_head + 1) % SIM_EVENT_QUEUE;
+		sim_queue_count--;
+	}
+	else if(sim_signals)
+	{
+		sim_event.packet.header = gecko_evt_system_external_signal_id |
+								  (sizeof(struct gecko_msg_system_external_signal_evt_t) << 8);
+		sim_event.packet.data.evt_system_external_signal.extsignals = sim_signals;
+		sim_signals = 0;
+		sim_stats.signal_events++;
+	}
+	else
+	{
+		return NULL;
+	}
+	sim_stats.events++;
+	return &sim_event.packet;
+}
+
+/* Earliest soft timer deadline */
+static uint64_t simTimerNext(void)
+{
+	uint64_t next = SIM_NEVER;
+	uint16_t i;
+
+	for(i = 0; i < sim_timers_used; i++)
+	{
+		if(sim_timers[i].active && (sim_timers[i].deadline < next))
+		{
+			next = sim_timers[i].deadline;
+		}
+	}
+	return next;
+}
+
+/* Queue the events of the soft timers due now */
+static void simTimerRun(void)
+{
+	struct gecko_msg_hardware_soft_timer_evt_t evt;
+	uint64_t now = simNow();
+	uint16_t i;
+
+	for(i = 0; i < sim_timers_used; i++)
+	{
+		if(!sim_timers[i].active || (sim_timers[i].deadline > now))
+		{
+			continue;
+		}
+		if(sim_timers[i].single_shot)
+		{
+			sim_timers[i].active = false;
+		}
+		else
+		{
+			sim_timers[i].deadline += sim_timers[i].period;
+		}
+		evt.handle = (uint8)i;
+		simEventPush(gecko_evt_hardware_soft_timer_id, &evt, sizeof(evt));
+		sim_stats.timer_events++;
+	}
+}
+
+/* Move the virtual time, the stack gets buffers back as time passes */
+static void simAdvance(uint64_t tick)
+{
+	if(tick > simNow())
+	{
+		simSleep(tick);
+		sim_notify_sent = 0;
+	}
+}
+
+struct gecko_cmd_packet *gecko_wait_event(void)
+{
+	struct gecko_cmd_packet *evt;
+	uint64_t script, swarm, hardware, timer;
+
+	while((evt = gecko_peek_event()) == NULL)
+	{
+		if(simReplayActive())
+		{
+			/* LETIMER0 still interrupts, its handler keeps state the signal handlers read */
+			script = simReplayNext();
+			if(sim_reset || (script == SIM_NEVER))
+			{
+				return NULL;
+			}
+			hardware = simLetimerNextIrq();
+			if(hardware <= script)
+			{
+				simAdvance(hardware);
+				simLetimerIrq();
+			}
+			else
+			{
+				simAdvance(script);
+				simReplayStep();
+			}
+			continue;
+		}
+		script = simScriptNext();
+		if(sim_reset || (script == SIM_NEVER))
+		{
+			return NULL;
+		}
+		swarm = simSwarmNext();
+		hardware = simLetimerNextIrq();
+		timer = simTimerNext();
+		if((script <= swarm) && (script <= hardware) && (script <= timer))
+		{
+			simAdvance(script);
+			simScriptStep();
+		}
+		else if((swarm <= hardware) && (swarm <= timer))
+		{
+			simAdvance(swarm);
+			simSwarmStep();
+		}
+		else if(hardware <= timer)
+		{
+			simAdvance(hardware);
+			simLetimerIrq();
+		}
+		else
+		{
+			simAdvance(timer);
+			simTimerRun();
+		}
+	}
+	return evt;
+}
+
+void simNotifyBudget(uint16_t notifications)
+{
+	sim_notify_budget = notifications;
+}
+
+bool simResetRequested(void)
+{
+	return sim_reset;
+}
+
+/*******************************************************************************
+ * Commands
+ ******************************************************************************/
+
+void sli_bt_cmd_handler_delegate(uint32_t header, gecko_cmd_handler handler, const void *payload)
+{
+	(void)header;
+	sim_stats.commands++;
+	handler(payload);
+}
+
+/* Response of a command without a model, success and zeros */
+static void simCommandDefault(void)
+{
+	memset(&sim_rsp.packet.data, 0, SIM_RSP_CLEAR);
+}
+
+void sli_bt_cmd_system_reset(const void *payload)
+{
+	LOG_INFO("Simulated reset, dfu %d", ((const struct gecko_msg_system_reset_cmd_t *)payload)->dfu);
+	sim_reset = true;
+}
+
+void sli_bt_cmd_hardware_set_soft_timer(const void *payload)
+{
+	const struct gecko_msg_hardware_set_soft_timer_cmd_t *cmd = payload;
+	sim_soft_timer_t *timer = &sim_timers[cmd->handle];
+
+	timer->active = cmd->time != 0;
+	timer->single_shot = cmd->single_shot != 0;
+	timer->period = cmd->time;
+	timer->deadline = simNow() + cmd->time;
+	if(cmd->handle >= sim_timers_used)
+	{
+		sim_timers_used = cmd->handle + 1;
+	}
+	sim_rsp.packet.data.rsp_hardware_set_soft_timer.result = bg_err_success;
+}
+
+static sim_ps_key_t *simPsFind(uint16_t key, bool create)
+{
+	uint8_t i;
+
+	for(i = 0; i < SIM_PS_KEYS; i++)
+	{
+		if(sim_ps[i].used && (sim_ps[i].key == key))
+		{
+			return &sim_ps[i];
+		}
+	}
+	for(i = 0; create && (i < SIM_PS_KEYS); i++)
+	{
+		if(!sim_ps[i].used)
+		{
+			sim_ps[i].used = true;
+			sim_ps[i].key = key;
+			return &sim_ps[i];
+		}
+	}
+	return NULL;
+}
+
+void sli_bt_cmd_flash_ps_save(const void *payload)
+{
+	const struct gecko_msg_flash_ps_save_cmd_t *cmd = payload;
+	sim_ps_key_t *ps = simPsFind(cmd->key, true);
+
+	if(ps == NULL)
+	{
+		sim_rsp.packet.data.rsp_flash_ps_save.result = bg_err_hardware_ps_store_full;
+		return;
+	}
+	ps->len = cmd->value.len;
+	memcpy(ps->value, cmd->value.data, cmd->value.len);
+	sim_rsp.packet.data.rsp_flash_ps_save.result = bg_err_success;
+}
+
+void sli_bt_cmd_flash_ps_load(const void *payload)
+{
+	const struct gecko_msg_flash_ps_load_cmd_t *cmd = payload;
+	sim_ps_key_t *ps = simPsFind(cmd->key, false);
+
+	if(ps == NULL)
+	{
+		sim_rsp.packet.data.rsp_flash_ps_load.result = bg_err_hardware_ps_key_not_found;
+		sim_rsp.packet.data.rsp_flash_ps_load.value.len = 0;
+		return;
+	}
+	sim_rsp.packet.data.rsp_flash_ps_load.result = bg_err_success;
+	sim_rsp.packet.data.rsp_flash_ps_load.value.len = ps->len;
+	memcpy(sim_rsp.packet.data.rsp_flash_ps_load.value.data, ps->value, ps->len);
+}
+
+void sli_bt_cmd_flash_ps_erase(const void *payload)
+{
+	const struct gecko_msg_flash_ps_erase_cmd_t *cmd = payload;
+	sim_ps_key_t *ps = simPsFind(cmd->key, false);
+
+	if(ps != NULL)
+	{
+		ps->used = false;
+	}
+	sim_rsp.packet.data.rsp_flash_ps_erase.result = bg_err_success;
+}
+
+void sli_bt_cmd_flash_ps_erase_all(const void *payload)
+{
+	(void)payload;
+	memset(sim_ps, 0, sizeof(sim_ps));
+	sim_rsp.packet.data.rsp_flash_ps_erase_all.result = bg_err_success;
+}
+
+void sli_bt_cmd_gatt_server_send_characteristic_notification(const void *payload)
+{
+	struct gecko_msg_gatt_server_send_characteristic_notification_rsp_t *rsp =
+		&sim_rsp.packet.data.rsp_gatt_server_send_characteristic_notification;
+
+	(void)payload;
+	if((sim_notify_budget != SIM_NOTIFY_UNLIMITED) && (sim_notify_sent >= sim_notify_budget))
+	{
+		sim_stats.notifications_refused++;
+		rsp->result = bg_err_out_of_memory;
+		return;
+	}
+	sim_notify_sent++;
+	sim_stats.notifications++;
+	rsp->result = bg_err_success;
+	rsp->sent_len = 0;
+}
+
+void simMtuSet(uint8_t connection, uint16_t mtu)
+{
+	if(connection < SIM_CONNECTIONS)
+	{
+		sim_mtu[connection] = mtu;
+	}
+}
+
+static uint16_t simMtu(uint8_t connection)
+{
+	return ((connection < SIM_CONNECTIONS) && sim_mtu[connection]) ? sim_mtu[connection] : SIM_DEFAULT_MTU;
+}
+
+void sli_bt_cmd_gatt_server_get_mtu(const void *payload)
+{
+	const struct gecko_msg_gatt_server_get_mtu_cmd_t *cmd = payload;
+
+	sim_rsp.packet.data.rsp_gatt_server_get_mtu.result = bg_err_success;
+	sim_rsp.packet.data.rsp_gatt_server_get_mtu.mtu = simMtu(cmd->connection);
+}
+
+/* The stack sends at most ATT_MTU - 1 bytes of a read response */
+void sli_bt_cmd_gatt_server_send_user_read_response(const void *payload)
+{
+	const struct gecko_msg_gatt_server_send_user_read_response_cmd_t *cmd = payload;
+
+	sim_rsp.packet.data.rsp_gatt_server_send_user_read_response.result =
+		(cmd->value.len < simMtu(cmd->connection)) ? bg_err_success : bg_err_invalid_param;
+}
+
+/* Commands that succeed without a model */
+#define SIM_COMMAND(name)	void sli_bt_cmd_##name(const void *payload) { (void)payload; simCommandDefault(); }
+
+SIM_COMMAND(system_get_bt_address)
+SIM_COMMAND(le_connection_close)
+SIM_COMMAND(gatt_server_set_max_mtu)
+SIM_COMMAND(gatt_server_write_attribute_value)
+SIM_COMMAND(gatt_server_send_user_write_response)
+SIM_COMMAND(mesh_node_init)
+SIM_COMMAND(mesh_node_start_unprov_beaconing)
+SIM_COMMAND(mesh_friend_init)
+SIM_COMMAND(mesh_generic_server_init)
+SIM_COMMAND(mesh_generic_server_response)
+SIM_COMMAND(mesh_generic_server_update)
+SIM_COMMAND(mesh_generic_server_publish)
+SIM_COMMAND(mesh_generic_client_get)
+SIM_COMMAND(mesh_generic_client_set)
+SIM_COMMAND(mesh_generic_client_publish)
+SIM_COMMAND(mesh_sensor_client_init)
+SIM_COMMAND(mesh_sensor_server_init)
+
+/*******************************************************************************
+ * Stack library functions
+ ******************************************************************************/
+
+void bg_pre_sleep(SLEEP_EnergyMode_t emode)
+{
+	(void)emode;
+}
+
+void bg_post_wakeup(SLEEP_EnergyMode_t emode)
+{
+	(void)emode;
+}
+
+errorcode_t gecko_stack_init(const gecko_configuration_t *config)
+{
+	(void)config;
+	SLEEP_Init(bg_pre_sleep, bg_post_wakeup);
+	SLEEP_SleepBlockBegin(sleepEM3);
+	return bg_err_success;
+}
+
+bool mesh_bgapi_listener(struct gecko_cmd_packet *evt)
+{
+	(void)evt;
+	return true;
+}
+
+#define SIM_CLASS(name)	void gecko_bgapi_class_##name##_init(void) { }
+
+SIM_CLASS(dfu)
+SIM_CLASS(system)
+SIM_CLASS(le_gap)
+SIM_CLASS(le_connection)
+SIM_CLASS(gatt_server)
+SIM_CLASS(hardware)
+SIM_CLASS(flash)
+SIM_CLASS(test)
+SIM_CLASS(mesh_node)
+SIM_CLASS(mesh_proxy)
+SIM_CLASS(mesh_proxy_server)
+SIM_CLASS(mesh_generic_server)
+SIM_CLASS(mesh_sensor_client)
+SIM_CLASS(mesh_friend)
+SIM_CLASS(mesh_lc_server)
+SIM_CLASS(mesh_lc_setup_server)
+SIM_CLASS(mesh_scene_server)
+SIM_CLASS(mesh_scene_setup_server)
@@ -0,0 +1,170 @@
+/*
+ * @filename	: dispatch_bench.c
+ * @description	: This file contains the host benchmark of the mesh_lib model handler dispatch
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Feeds synthetic gecko_evt_mesh_generic_server_client_request packets,
+ * on/off and level requests in turn, to mesh_lib_generic_server_event_handler()
+ * and times them.  Nine other registrations are made ahead of the on/off and
+ * level servers, as the pool of MESH_LIB_STATIC_MODELS allows, so the linear
+ * scan walks past them on every event.  The bench target of host/Makefile
+ * builds it twice: with the dispatch table, and with
+ * MESH_LIB_DISPATCH_ELEMENTS 0, which leaves every lookup to the scan.
+ * Deserializing the request is in both times.
+ *
+ * 		make -C host bench
+ * 		host/build/bench/dispatch_bench -n 10000000
+ */
+
+#include <stdint.h>
+#include "bg_types.h"
+#include "native_gecko.h"
+#include "mesh_generic_model_capi_types.h"
+#include "mesh_lib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_EVENTS			10000000UL
+#define BENCH_OTHER_MODELS		(MESH_LIB_STATIC_MODELS - 2)
+#define BENCH_OTHER_MODEL_ID	0x1300		//Lighting servers, none of them gets an event
+#define BENCH_SERVER_ADDRESS	0x0002
+#define BENCH_CLIENT_ADDRESS	0x0100
+#define BENCH_PARAMETERS_MAX	4
+
+/* A packet with room for the request parameters after the event */
+typedef union
+{
+	struct gecko_cmd_packet packet;
+	uint8_t buf[BGLIB_MSG_HEADER_LEN + sizeof(struct gecko_msg_mesh_generic_server_client_request_evt_t) +
+				BENCH_PARAMETERS_MAX];
+}bench_packet_t;
+
+static volatile uint32_t bench_requests = 0;
+static volatile int32_t bench_sum = 0;
+
+/*
+ * mesh_lib.c links against the commands its responses and publishes send,
+ * none of them is sent on the event path timed here.  Without bgapi_sim.c
+ * the command buffers and the commands are stubs.
+ */
+static bench_packet_t bench_cmd, bench_rsp;
+void *gecko_cmd_msg_buf = &bench_cmd;
+void *gecko_rsp_msg_buf = &bench_rsp;
+
+void sli_bt_cmd_handler_delegate(uint32_t header, gecko_cmd_handler handler, const void *payload)
+{
+	(void)header;
+	(void)handler;
+	(void)payload;
+	memset(&bench_rsp, 0, sizeof(bench_rsp));
+}
+
+/* Commands of the response and publish functions */
+#define BENCH_COMMAND(name)	void sli_bt_cmd_##name(const void *payload) { (void)payload; }
+
+BENCH_COMMAND(mesh_generic_server_response)
+BENCH_COMMAND(mesh_generic_server_update)
+BENCH_COMMAND(mesh_generic_server_publish)
+BENCH_COMMAND(mesh_generic_client_get)
+BENCH_COMMAND(mesh_generic_client_set)
+BENCH_COMMAND(mesh_generic_client_publish)
+
+static void benchRequest(uint16_t model_id, uint16_t element_index, uint16_t client_addr, uint16_t server_addr,
+						 uint16_t appkey_index, const struct mesh_generic_request *req, uint32_t transition_ms,
+						 uint16_t delay_ms, uint8_t request_flags)
+{
+	bench_requests++;
+	bench_sum += (model_id == MESH_GENERIC_LEVEL_SERVER_MODEL_ID) ? req->level : req->on_off;
+}
+
+static void benchChange(uint16_t model_id, uint16_t element_index, const struct mesh_generic_state *current,
+						const struct mesh_generic_state *target, uint32_t remaining_ms)
+{
+}
+
+static void benchPacket(bench_packet_t *evt, uint16_t model_id, uint8_t type, const uint8_t *parameters, uint8_t len)
+{
+	struct gecko_msg_mesh_generic_server_client_request_evt_t *req = &evt->packet.data.evt_mesh_generic_server_client_request;
+	uint16_t size = sizeof(*req) + len;
+
+	memset(evt, 0, sizeof(*evt));
+	evt->packet.header = gecko_evt_mesh_generic_server_client_request_id | ((uint32_t)(size & 0xFF) << 8) |
+						 ((size >> 8) & 0x7);
+	req->model_id = model_id;
+	req->client_address = BENCH_CLIENT_ADDRESS;
+	req->server_address = BENCH_SERVER_ADDRESS;
+	req->type = type;
+	req->parameters.len = len;
+	memcpy(req->parameters.data, parameters, len);
+}
+
+static uint64_t benchNs(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+int main(int argc, char **argv)
+{
+	static const uint8_t on_off[] = { 1 };
+	static const uint8_t level[] = { 0x34, 0x12 };
+	bench_packet_t events[2];
+	unsigned long count = BENCH_EVENTS, i;
+	uint64_t start, ns;
+	uint16_t model;
+	int opt;
+
+	while((opt = getopt(argc, argv, "n:")) != -1)
+	{
+		if(opt != 'n')
+		{
+			fprintf(stderr, "usage: %s [-n events]\n", argv[0]);
+			return 2;
+		}
+		count = strtoul(optarg, NULL, 0);
+	}
+
+	if(mesh_lib_init(NULL, NULL, MESH_LIB_STATIC_MODELS) != bg_err_success)
+	{
+		fprintf(stderr, "dispatch_bench: mesh_lib_init failed\n");
+		return 1;
+	}
+	for(model = 0; model < BENCH_OTHER_MODELS; model++)
+	{
+		mesh_lib_generic_server_register_handler(BENCH_OTHER_MODEL_ID + model, 0, benchRequest, benchChange, NULL);
+	}
+	if((mesh_lib_generic_server_register_handler(MESH_GENERIC_ON_OFF_SERVER_MODEL_ID, 0, benchRequest, benchChange,
+												 NULL) != bg_err_success) ||
+	   (mesh_lib_generic_server_register_handler(MESH_GENERIC_LEVEL_SERVER_MODEL_ID, 0, benchRequest, benchChange,
+												 NULL) != bg_err_success))
+	{
+		fprintf(stderr, "dispatch_bench: handler register failed\n");
+		return 1;
+	}
+	benchPacket(&events[0], MESH_GENERIC_ON_OFF_SERVER_MODEL_ID, mesh_generic_request_on_off, on_off, sizeof(on_off));
+	benchPacket(&events[1], MESH_GENERIC_LEVEL_SERVER_MODEL_ID, mesh_generic_request_level, level, sizeof(level));
+
+	start = benchNs();
+	for(i = 0; i < count; i++)
+	{
+		mesh_lib_generic_server_event_handler(&events[i & 1].packet);
+	}
+	ns = benchNs() - start;
+
+	if(bench_requests != count)
+	{
+		fprintf(stderr, "dispatch_bench: %lu requests handled of %lu\n", (unsigned long)bench_requests, count);
+		return 1;
+	}
+	printf("dispatch_bench: %s, %lu events in %.3f s, %.1f ns per event\n",
+		   (MESH_LIB_DISPATCH_ELEMENTS > 0) ? "table" : "scan ", count, (double)ns / 1e9,
+		   count ? ((double)ns / (double)count) : 0.0);
+	return 0;
+}
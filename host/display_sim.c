@@ -0,0 +1,91 @@
+/*
+ * @filename	: display_sim.c
+ * @description	: This file contains the LCD model of the host simulation
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Rows are formatted with fmtVsnprintf() as display.c does, staged, and
+ * copied to the committed rows by displayCommit().  Both are profiled as in
+ * display.c, and the commit is an energy hold of the display as there.
+ */
+
+#include "sim.h"
+#include "display.h"
+#include "format.h"
+#include "profile.h"
+#include "energy.h"
+#include <stdarg.h>
+#include <string.h>
+
+#define DISPLAY_ROW_LEN		32
+
+static char sim_rows_staged[DISPLAY_ROW_MAX][DISPLAY_ROW_LEN + 1];
+static char sim_rows[DISPLAY_ROW_MAX][DISPLAY_ROW_LEN + 1];
+static uint32_t sim_rows_dirty = 0;
+
+void displayInit()
+{
+	memset(sim_rows_staged, 0, sizeof(sim_rows_staged));
+	memset(sim_rows, 0, sizeof(sim_rows));
+	sim_rows_dirty = 0;
+}
+
+bool displayUpdate()
+{
+	return true;
+}
+
+void displayPrintf(enum display_row row, const char *format, ... )
+{
+	uint32_t cycles = profileStart();
+	va_list args;
+	int len;
+
+	if(row >= DISPLAY_ROW_MAX)
+	{
+		return;
+	}
+	va_start(args, format);
+	len = fmtVsnprintf(sim_rows_staged[row], DISPLAY_ROW_LEN, format, args);
+	va_end(args);
+	if(len < 0)
+	{
+		len = 0;
+	}
+	else if(len >= DISPLAY_ROW_LEN)
+	{
+		len = DISPLAY_ROW_LEN - 1;
+	}
+	sim_rows_staged[row][len] = 0;
+	sim_rows_dirty |= (1UL << row);
+	profileSection(PROFILE_DISPLAY_PRINTF, cycles);
+}
+
+void displayCommit()
+{
+	uint32_t cycles;
+	unsigned int row;
+
+	if(sim_rows_dirty == 0)
+	{
+		return;
+	}
+	cycles = profileStart();
+	energyBlockBegin(ENERGY_CAUSE_DISPLAY, sleepEM0);
+	for(row = 0; row < DISPLAY_ROW_MAX; row++)
+	{
+		if(sim_rows_dirty & (1UL << row))
+		{
+			memcpy(sim_rows[row], sim_rows_staged[row], sizeof(sim_rows[row]));
+		}
+	}
+	sim_rows_dirty = 0;
+	energyBlockEnd(ENERGY_CAUSE_DISPLAY, sleepEM0);
+	profileSection(PROFILE_DISPLAY_COMMIT, cycles);
+}
+
+const char *simDisplayRow(unsigned int row)
+{
+	return (row < DISPLAY_ROW_MAX) ? sim_rows[row] : "";
+}
@@ -0,0 +1,70 @@
+/*
+ * @filename	: fixed_point_test.c
+ * @description	: This file contains the host test of the Si7021 fixed point conversions
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ * 				  Si7021-A20 datasheet, section 5.1.1 and 5.1.2
+ *
+ * Converts every one of the 65536 Si7021 codes with fixedHumidityFromCode()
+ * and fixedTemperatureFromCode() and checks each result is within one LSB, a
+ * hundredth, of the float formula of the datasheet.  Also checks fixedFormat()
+ * against printf on values around the sign and the decimals.
+ *
+ * 		make -C host test
+ */
+
+#include "fixed_point.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define TEST_CHECK(cond)		testCheck((cond), #cond, __LINE__)
+
+static unsigned int test_checks = 0;
+
+static void testCheck(int ok, const char *cond, int line)
+{
+	test_checks++;
+	if(!ok)
+	{
+		fprintf(stderr, "fixed_point_test.c:%d: check failed: %s\n", line, cond);
+		exit(1);
+	}
+}
+
+int main(void)
+{
+	static const int32_t values[] = { 0, 1, -1, 5, -5, 99, -99, 100, -100, 4685, -4685, 12345678, -12345678 };
+	char buf[FIXED_FORMAT_LEN], expected[32];
+	double humidity, temperature, error, worst_humidity = 0.0, worst_temperature = 0.0;
+	uint32_t code;
+	size_t i;
+
+	for(code = 0; code <= UINT16_MAX; code++)
+	{
+		/* Datasheet formulas, in hundredths */
+		humidity = ((125.0 * code) / 65536.0 - 6.0) * 100.0;
+		temperature = ((175.72 * code) / 65536.0 - 46.85) * 100.0;
+
+		error = fabs(fixedHumidityFromCode((uint16_t)code) - humidity);
+		TEST_CHECK(error <= 1.0);
+		worst_humidity = (error > worst_humidity) ? error : worst_humidity;
+
+		error = fabs(fixedTemperatureFromCode((uint16_t)code) - temperature);
+		TEST_CHECK(error <= 1.0);
+		worst_temperature = (error > worst_temperature) ? error : worst_temperature;
+	}
+
+	for(i = 0; i < (sizeof(values) / sizeof(values[0])); i++)
+	{
+		snprintf(expected, sizeof(expected), "%s%ld.%02ld", (values[i] < 0) ? "-" : "",
+				 labs((long)values[i]) / 100, labs((long)values[i]) % 100);
+		TEST_CHECK(strcmp(fixedFormat(buf, sizeof(buf), values[i]), expected) == 0);
+	}
+
+	printf("fixed_point_test: %u checks passed, worst error %.3f LSB RH, %.3f LSB temperature\n", test_checks,
+		   worst_humidity, worst_temperature);
+	return 0;
+}
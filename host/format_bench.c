@@ -0,0 +1,183 @@
+/*
+ * @filename	: format_bench.c
+ * @description	: This file contains the host benchmark of fmtVsnprintf() against vsnprintf()
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Times src/format.c against the C library on the format strings of the tree:
+ * log lines with the prefix LOG_DO() adds, display rows, the device name and
+ * the fixed point values that replaced %.2f.  Both outputs are compared
+ * before timing, a case where they differ fails the run.  The flash side is
+ * reported by the bench target of host/Makefile, with size on format.o and
+ * on the printf objects vsnprintf() pulls out of the C library.
+ *
+ * 		make -C host bench
+ * 		host/build/bench/format_bench -n 100000
+ */
+
+#include "format.h"
+#include "fixed_point.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_BUF_LEN		96		//LOG_LINE_LEN
+#define BENCH_ITERATIONS	1000000UL
+#define BENCH_LOG_PREFIX	"%5" PRIu32 ":%s:%s: "
+
+typedef int (*bench_vsnprintf_t)(char *buf, size_t size, const char *format, va_list args);
+
+/* One call of a format string of the tree with typical arguments */
+typedef int (*bench_case_fn)(bench_vsnprintf_t print, char *buf, size_t size);
+
+typedef struct
+{
+	const char *name;
+	bench_case_fn fn;
+}bench_case_t;
+
+static int benchPrint(bench_vsnprintf_t print, char *buf, size_t size, const char *format, ...)
+{
+	va_list args;
+	int len;
+
+	va_start(args, format);
+	len = print(buf, size, format, args);
+	va_end(args);
+	return len;
+}
+
+static int benchLogLpns(bench_vsnprintf_t print, char *buf, size_t size)
+{
+	return benchPrint(print, buf, size, BENCH_LOG_PREFIX "Number of LPNs in mesh - %d\n", (uint32_t)86400123,
+					  "Info ", "handle_friend_events", 2);
+}
+
+static int benchLogSensor(bench_vsnprintf_t print, char *buf, size_t size)
+{
+	return benchPrint(print, buf, size, BENCH_LOG_PREFIX "Sensor property 0x%x from 0x%x ignored\n",
+					  (uint32_t)1234, "Warn ", "handleSensorStatus", 0x4F, 0x1A2B);
+}
+
+static int benchLogEvent(bench_vsnprintf_t print, char *buf, size_t size)
+{
+	return benchPrint(print, buf, size, BENCH_LOG_PREFIX "unhandled evt: %8.8x class %2.2x method %2.2x\r\n\n",
+					  (uint32_t)42, "Info ", "handle_gecko_event", 0x200600A0U, 0x06, 0x0A);
+}
+
+static int benchLogEnergy(bench_vsnprintf_t print, char *buf, size_t size)
+{
+	return benchPrint(print, buf, size, BENCH_LOG_PREFIX "energy modes em0=%lu em1=%lu em2=%lu em3=%lu ms\n",
+					  (uint32_t)3600000, "Info ", "energyReport", 41234UL, 90321UL, 3468445UL, 0UL);
+}
+
+static int benchRowFriend(bench_vsnprintf_t print, char *buf, size_t size)
+{
+	return benchPrint(print, buf, size, "FRIEND -- %d LPNs", 2);
+}
+
+static int benchRowNumber(bench_vsnprintf_t print, char *buf, size_t size)
+{
+	return benchPrint(print, buf, size, "%d", -1532);
+}
+
+static int benchName(bench_vsnprintf_t print, char *buf, size_t size)
+{
+	return benchPrint(print, buf, size, "5823Sub %02x:%02x", 0x0B, 0xE4);
+}
+
+/* Rows of fixed point values: fixedFormat() then %s, against %.2f of the float */
+static int benchRowFixed(bench_vsnprintf_t print, char *buf, size_t size)
+{
+	char value[FIXED_FORMAT_LEN];
+
+	if(print == vsnprintf)
+	{
+		return benchPrint(print, buf, size, "%.2f", -1234 / 100.0);
+	}
+	return benchPrint(print, buf, size, "%s", fixedFormat(value, sizeof(value), -1234));
+}
+
+static const bench_case_t bench_cases[] =
+{
+	{ "log lpns %d",			benchLogLpns },
+	{ "log sensor %x %x",		benchLogSensor },
+	{ "log event %8.8x %2.2x",	benchLogEvent },
+	{ "log energy 4x %lu",		benchLogEnergy },
+	{ "row friend %d",			benchRowFriend },
+	{ "row accel %d",			benchRowNumber },
+	{ "name %02x:%02x",			benchName },
+	{ "row fixed %.2f",			benchRowFixed },
+};
+
+static uint64_t benchNs(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+/* ns per call of a case over iterations calls */
+static double benchTime(const bench_case_t *bench, bench_vsnprintf_t print, unsigned long iterations)
+{
+	char buf[BENCH_BUF_LEN];
+	volatile int sink = 0;
+	unsigned long i;
+	uint64_t start;
+
+	start = benchNs();
+	for(i = 0; i < iterations; i++)
+	{
+		sink += bench->fn(print, buf, sizeof(buf));
+	}
+	(void)sink;
+	return (double)(benchNs() - start) / (double)iterations;
+}
+
+int main(int argc, char **argv)
+{
+	char fmt_buf[BENCH_BUF_LEN], libc_buf[BENCH_BUF_LEN];
+	unsigned long iterations = BENCH_ITERATIONS;
+	double fmt_ns, libc_ns, fmt_total = 0.0, libc_total = 0.0;
+	size_t i;
+	int opt;
+
+	while((opt = getopt(argc, argv, "n:")) != -1)
+	{
+		if(opt != 'n')
+		{
+			fprintf(stderr, "usage: %s [-n iterations]\n", argv[0]);
+			return 2;
+		}
+		iterations = strtoul(optarg, NULL, 0);
+	}
+	if(iterations == 0)
+	{
+		iterations = 1;
+	}
+
+	printf("%-24s %12s %12s %8s\n", "format", "fmt ns", "libc ns", "speedup");
+	for(i = 0; i < (sizeof(bench_cases) / sizeof(bench_cases[0])); i++)
+	{
+		bench_cases[i].fn(fmtVsnprintf, fmt_buf, sizeof(fmt_buf));
+		bench_cases[i].fn(vsnprintf, libc_buf, sizeof(libc_buf));
+		if(strcmp(fmt_buf, libc_buf) != 0)
+		{
+			fprintf(stderr, "format_bench: %s differs: \"%s\" against \"%s\"\n", bench_cases[i].name, fmt_buf,
+					libc_buf);
+			return 1;
+		}
+		fmt_ns = benchTime(&bench_cases[i], fmtVsnprintf, iterations);
+		libc_ns = benchTime(&bench_cases[i], vsnprintf, iterations);
+		fmt_total += fmt_ns;
+		libc_total += libc_ns;
+		printf("%-24s %12.1f %12.1f %7.2fx\n", bench_cases[i].name, fmt_ns, libc_ns, libc_ns / fmt_ns);
+	}
+	printf("%-24s %12.1f %12.1f %7.2fx\n", "total", fmt_total, libc_total, libc_total / fmt_total);
+	return 0;
+}
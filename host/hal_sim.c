@@ -0,0 +1,589 @@
+/*
+ * @filename	: hal_sim.c
+ * @description	: This file contains the peripheral models of the host simulation
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * GPIO pins and external interrupts, the CMU clock tree as far as LETIMER0
+ * and the core need it, the SLEEP driver, LETIMER0 itself, the DWT cycle counter, the sleeptimer
+ * and the NVM3 counter objects.
+ * LETIMER0 flags are worked out from the virtual time when they are read, so
+ * the timer costs nothing between two interrupts.
+ */
+
+#include "sim.h"
+#include "em_cmu.h"
+#include "em_letimer.h"
+#include "gpiointerrupt.h"
+#include "sleep.h"
+#include "sl_sleeptimer.h"
+#include "nvm3_default.h"
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+
+#define SIM_GPIO_PORTS		6
+#define SIM_GPIO_PINS		16
+#define SIM_LF_HZ			32768UL		//LFXO, LFRCO and ULFRCO all run at the tick rate here
+#define SIM_CORE_HZ			38400000UL	//HFXO of the board, the core and CYCCNT clock
+#define SIM_NVM3_OBJECTS	32
+
+struct LETIMER_TypeDef
+{
+	bool enabled;
+	uint64_t start;				//simNow() when enabled
+	uint32_t div;				//Ticks per LETIMER0 count
+	uint32_t comp[2];
+	uint32_t ien;
+	uint32_t flags;
+	uint64_t checked;			//Count up to which the flags were worked out
+};
+
+struct I2C_TypeDef
+{
+	uint32_t unused;
+};
+
+typedef struct
+{
+	bool enabled;
+	uint8_t port;
+	uint8_t pin;
+	bool rising;
+	bool falling;
+}sim_extint_t;
+
+typedef struct
+{
+	bool used;
+	nvm3_ObjectKey_t key;
+	uint32_t value;
+}sim_nvm3_object_t;
+
+LETIMER_TypeDef sim_letimer0 = { .div = 1 };
+I2C_TypeDef sim_i2c0;
+CoreDebug_Type sim_core_debug;
+nvm3_Handle_t *nvm3_defaultHandle = NULL;
+nvm3_Init_t *nvm3_defaultInit = NULL;
+
+static uint64_t sim_now = 0;
+static uint8_t sim_pin_level[SIM_GPIO_PORTS][SIM_GPIO_PINS];
+static sim_extint_t sim_extint[SIM_GPIO_PINS];
+static GPIOINT_IrqCallbackPtr_t sim_extint_callback[SIM_GPIO_PINS];
+static uint32_t sim_clock_div[cmuClock_COUNT];
+static uint32_t sim_sleep_blocks[sleepEM4 + 1];
+static SLEEP_Init_t sim_sleep_init;
+static sim_nvm3_object_t sim_nvm3[SIM_NVM3_OBJECTS];
+static DWT_Type sim_dwt;
+static uint32_t sim_dwt_base = 0;			//CYCCNT at sim_dwt_origin_ns
+static uint64_t sim_dwt_origin_ns = 0;
+static uint32_t sim_dwt_count = 0;			//CYCCNT as last brought up to date, differs once it is written
+
+void LETIMER0_IRQHandler(void);
+
+uint64_t simNow(void)
+{
+	return sim_now;
+}
+
+void simClockSet(uint64_t tick)
+{
+	if(tick > sim_now)
+	{
+		sim_now = tick;
+	}
+}
+
+/*******************************************************************************
+ * GPIO and GPIOINT
+ ******************************************************************************/
+
+void GPIO_DriveStrengthSet(GPIO_Port_TypeDef port, GPIO_DriveStrength_TypeDef strength)
+{
+	(void)port;
+	(void)strength;
+}
+
+void GPIO_PinModeSet(GPIO_Port_TypeDef port, unsigned int pin, GPIO_Mode_TypeDef mode, unsigned int out)
+{
+	/* DOUT sets the level of outputs and selects the pull-up of inputs with pull */
+	if((port < SIM_GPIO_PORTS) && (pin < SIM_GPIO_PINS) && (mode != gpioModeInput))
+	{
+		sim_pin_level[port][pin] = out ? 1 : 0;
+	}
+}
+
+void GPIO_PinOutSet(GPIO_Port_TypeDef port, unsigned int pin)
+{
+	if((port < SIM_GPIO_PORTS) && (pin < SIM_GPIO_PINS))
+	{
+		sim_pin_level[port][pin] = 1;
+	}
+}
+
+void GPIO_PinOutClear(GPIO_Port_TypeDef port, unsigned int pin)
+{
+	if((port < SIM_GPIO_PORTS) && (pin < SIM_GPIO_PINS))
+	{
+		sim_pin_level[port][pin] = 0;
+	}
+}
+
+void GPIO_PinOutToggle(GPIO_Port_TypeDef port, unsigned int pin)
+{
+	if((port < SIM_GPIO_PORTS) && (pin < SIM_GPIO_PINS))
+	{
+		sim_pin_level[port][pin] ^= 1;
+	}
+}
+
+unsigned int GPIO_PinOutGet(GPIO_Port_TypeDef port, unsigned int pin)
+{
+	return ((port < SIM_GPIO_PORTS) && (pin < SIM_GPIO_PINS)) ? sim_pin_level[port][pin] : 0;
+}
+
+unsigned int GPIO_PinInGet(GPIO_Port_TypeDef port, unsigned int pin)
+{
+	return GPIO_PinOutGet(port, pin);
+}
+
+void GPIO_ExtIntConfig(GPIO_Port_TypeDef port, unsigned int pin, unsigned int intNo,
+					   bool risingEdge, bool fallingEdge, bool enable)
+{
+	if(intNo >= SIM_GPIO_PINS)
+	{
+		return;
+	}
+	sim_extint[intNo].port = (uint8_t)port;
+	sim_extint[intNo].pin = (uint8_t)pin;
+	sim_extint[intNo].rising = risingEdge;
+	sim_extint[intNo].falling = fallingEdge;
+	sim_extint[intNo].enabled = enable;
+}
+
+void GPIOINT_Init(void)
+{
+}
+
+void GPIOINT_CallbackRegister(uint8_t intNo, GPIOINT_IrqCallbackPtr_t callbackPtr)
+{
+	if(intNo < SIM_GPIO_PINS)
+	{
+		sim_extint_callback[intNo] = callbackPtr;
+	}
+}
+
+void simGpioInput(GPIO_Port_TypeDef port, unsigned int pin, unsigned int level)
+{
+	uint8_t old;
+	uint8_t i;
+	bool edge;
+
+	if((port >= SIM_GPIO_PORTS) || (pin >= SIM_GPIO_PINS))
+	{
+		return;
+	}
+	old = sim_pin_level[port][pin];
+	sim_pin_level[port][pin] = level ? 1 : 0;
+	if(old == sim_pin_level[port][pin])
+	{
+		return;
+	}
+	for(i = 0; i < SIM_GPIO_PINS; i++)
+	{
+		edge = level ? sim_extint[i].rising : sim_extint[i].falling;
+		if(sim_extint[i].enabled && edge && (sim_extint[i].port == port) && (sim_extint[i].pin == pin) &&
+		   (sim_extint_callback[i] != NULL))
+		{
+			sim_extint_callback[i](i);
+		}
+	}
+}
+
+void simGpioLevel(GPIO_Port_TypeDef port, unsigned int pin, unsigned int level)
+{
+	if((port < SIM_GPIO_PORTS) && (pin < SIM_GPIO_PINS))
+	{
+		sim_pin_level[port][pin] = level ? 1 : 0;
+	}
+}
+
+/*******************************************************************************
+ * CMU and SLEEP
+ ******************************************************************************/
+
+void CMU_ClockEnable(CMU_Clock_TypeDef clock, bool enable)
+{
+	(void)clock;
+	(void)enable;
+}
+
+void CMU_ClockDivSet(CMU_Clock_TypeDef clock, CMU_ClkDiv_TypeDef div)
+{
+	if(clock < cmuClock_COUNT)
+	{
+		sim_clock_div[clock] = div;
+	}
+	if(clock == cmuClock_LETIMER0)
+	{
+		sim_letimer0.div = div;
+	}
+}
+
+void CMU_ClockSelectSet(CMU_Clock_TypeDef clock, CMU_Select_TypeDef ref)
+{
+	(void)clock;
+	(void)ref;
+}
+
+void CMU_OscillatorEnable(CMU_Osc_TypeDef osc, bool enable, bool wait)
+{
+	(void)osc;
+	(void)enable;
+	(void)wait;
+}
+
+uint32_t CMU_ClockFreqGet(CMU_Clock_TypeDef clock)
+{
+	uint32_t div = (clock < cmuClock_COUNT) ? sim_clock_div[clock] : 0;
+
+	return ((clock == cmuClock_HF) || (clock == cmuClock_CORE) ? SIM_CORE_HZ : SIM_LF_HZ) / (div ? div : 1);
+}
+
+DWT_Type *simDwt(void)
+{
+	struct timespec now;
+	uint64_t ns;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	ns = ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+	/* Counts from the value last written, only while enabled and traced as on target */
+	if((sim_dwt.CYCCNT != sim_dwt_count) || !(sim_dwt.CTRL & DWT_CTRL_CYCCNTENA_Msk) ||
+	   !(sim_core_debug.DEMCR & CoreDebug_DEMCR_TRCENA_Msk))
+	{
+		sim_dwt_base = sim_dwt.CYCCNT;
+		sim_dwt_origin_ns = ns;
+	}
+	sim_dwt.CYCCNT = sim_dwt_base + (uint32_t)(((ns - sim_dwt_origin_ns) * (SIM_CORE_HZ / 1000)) / 1000000ULL);
+	sim_dwt_count = sim_dwt.CYCCNT;
+	return &sim_dwt;
+}
+
+/* SLEEP_Init() callbacks return nothing, SLEEP_InitEx() ones decide whether to sleep */
+static SLEEP_CbFuncPtr_t sim_sleep_legacy = NULL;
+
+static bool simSleepLegacy(SLEEP_EnergyMode_t eMode)
+{
+	if(sim_sleep_legacy != NULL)
+	{
+		sim_sleep_legacy(eMode);
+	}
+	return true;
+}
+
+void SLEEP_Init(SLEEP_CbFuncPtr_t pSleepCb, SLEEP_CbFuncPtr_t pWakeUpCb)
+{
+	sim_sleep_legacy = pSleepCb;
+	sim_sleep_init.sleepCallback = simSleepLegacy;
+	sim_sleep_init.wakeupCallback = pWakeUpCb;
+	sim_sleep_init.restoreCallback = NULL;
+	memset(sim_sleep_blocks, 0, sizeof(sim_sleep_blocks));
+}
+
+void SLEEP_InitEx(const SLEEP_Init_t *init)
+{
+	SLEEP_Init(NULL, init->wakeupCallback);
+	sim_sleep_init = *init;
+}
+
+SLEEP_EnergyMode_t SLEEP_LowestEnergyModeGet(void)
+{
+	if(sim_sleep_blocks[sleepEM2])
+	{
+		return sleepEM1;
+	}
+	return sim_sleep_blocks[sleepEM3] ? sleepEM2 : sleepEM3;
+}
+
+void simSleep(uint64_t tick)
+{
+	SLEEP_EnergyMode_t mode = SLEEP_LowestEnergyModeGet();
+	bool enter = true;
+
+	if(sim_sleep_init.sleepCallback != NULL)
+	{
+		enter = sim_sleep_init.sleepCallback(mode);
+	}
+	simClockSet(tick);
+	if(enter && (sim_sleep_init.wakeupCallback != NULL))
+	{
+		sim_sleep_init.wakeupCallback(mode);
+	}
+}
+
+void SLEEP_SleepBlockBegin(SLEEP_EnergyMode_t eMode)
+{
+	if(eMode <= sleepEM4)
+	{
+		sim_sleep_blocks[eMode]++;
+	}
+}
+
+void SLEEP_SleepBlockEnd(SLEEP_EnergyMode_t eMode)
+{
+	if((eMode <= sleepEM4) && sim_sleep_blocks[eMode])
+	{
+		sim_sleep_blocks[eMode]--;
+	}
+}
+
+/*******************************************************************************
+ * LETIMER0, counts down from COMP0 to 0 and reloads, UF on the reload
+ ******************************************************************************/
+
+static uint64_t simLetimerCount(const LETIMER_TypeDef *letimer)
+{
+	return (sim_now - letimer->start) / letimer->div;
+}
+
+/* First count after from at which the counter reads value */
+static uint64_t simLetimerMatch(const LETIMER_TypeDef *letimer, uint64_t from, uint32_t value)
+{
+	uint64_t period = (uint64_t)letimer->comp[0] + 1;
+	uint64_t phase = letimer->comp[0] - value;
+
+	return from + 1 + ((phase + period - ((from + 1) % period)) % period);
+}
+
+/* Raise the flags of the counts since they were last worked out */
+static void simLetimerUpdate(LETIMER_TypeDef *letimer)
+{
+	uint64_t count;
+
+	if(!letimer->enabled)
+	{
+		return;
+	}
+	count = simLetimerCount(letimer);
+	if(count == letimer->checked)
+	{
+		return;
+	}
+	if(simLetimerMatch(letimer, letimer->checked, letimer->comp[0]) <= count)
+	{
+		letimer->flags |= LETIMER_IF_UF;
+	}
+	if((letimer->comp[1] <= letimer->comp[0]) && (simLetimerMatch(letimer, letimer->checked, letimer->comp[1]) <= count))
+	{
+		letimer->flags |= LETIMER_IF_COMP1;
+	}
+	letimer->checked = count;
+}
+
+void LETIMER_Init(LETIMER_TypeDef *letimer, const LETIMER_Init_TypeDef *init)
+{
+	letimer->enabled = false;
+	letimer->flags = 0;
+	LETIMER_Enable(letimer, init->enable);
+}
+
+void LETIMER_Enable(LETIMER_TypeDef *letimer, bool enable)
+{
+	if(enable && !letimer->enabled)
+	{
+		letimer->start = sim_now;
+		letimer->checked = 0;
+	}
+	simLetimerUpdate(letimer);
+	letimer->enabled = enable;
+}
+
+void LETIMER_CompareSet(LETIMER_TypeDef *letimer, unsigned int comp, uint32_t value)
+{
+	if(comp < 2)
+	{
+		simLetimerUpdate(letimer);
+		letimer->comp[comp] = value & 0xFFFF;
+	}
+}
+
+uint32_t LETIMER_CounterGet(LETIMER_TypeDef *letimer)
+{
+	if(!letimer->enabled)
+	{
+		return letimer->comp[0];
+	}
+	return letimer->comp[0] - (uint32_t)(simLetimerCount(letimer) % ((uint64_t)letimer->comp[0] + 1));
+}
+
+void LETIMER_IntEnable(LETIMER_TypeDef *letimer, uint32_t flags)
+{
+	letimer->ien |= flags;
+}
+
+void LETIMER_IntDisable(LETIMER_TypeDef *letimer, uint32_t flags)
+{
+	letimer->ien &= ~flags;
+}
+
+void LETIMER_IntClear(LETIMER_TypeDef *letimer, uint32_t flags)
+{
+	simLetimerUpdate(letimer);
+	letimer->flags &= ~flags;
+}
+
+uint32_t LETIMER_IntGet(LETIMER_TypeDef *letimer)
+{
+	simLetimerUpdate(letimer);
+	return letimer->flags;
+}
+
+uint32_t LETIMER_IntGetEnabled(LETIMER_TypeDef *letimer)
+{
+	return LETIMER_IntGet(letimer) & letimer->ien;
+}
+
+uint64_t simLetimerNextIrq(void)
+{
+	LETIMER_TypeDef *letimer = &sim_letimer0;
+	uint64_t next = SIM_NEVER;
+	uint64_t count;
+
+	if(!letimer->enabled)
+	{
+		return SIM_NEVER;
+	}
+	if(LETIMER_IntGetEnabled(letimer))
+	{
+		return sim_now;
+	}
+	if(letimer->ien & LETIMER_IF_UF)
+	{
+		next = simLetimerMatch(letimer, letimer->checked, letimer->comp[0]);
+	}
+	if((letimer->ien & LETIMER_IF_COMP1) && (letimer->comp[1] <= letimer->comp[0]))
+	{
+		count = simLetimerMatch(letimer, letimer->checked, letimer->comp[1]);
+		next = (count < next) ? count : next;
+	}
+	return (next == SIM_NEVER) ? SIM_NEVER : letimer->start + (next * letimer->div);
+}
+
+void simLetimerIrq(void)
+{
+	if(LETIMER_IntGetEnabled(&sim_letimer0))
+	{
+		sim_stats.letimer_irqs++;
+		LETIMER0_IRQHandler();
+	}
+}
+
+/*******************************************************************************
+ * Sleeptimer, runs at the tick rate from the start
+ ******************************************************************************/
+
+sl_status_t sl_sleeptimer_init(void)
+{
+	return 0;
+}
+
+uint32_t sl_sleeptimer_get_timer_frequency(void)
+{
+	return SIM_TICK_HZ;
+}
+
+uint64_t sl_sleeptimer_get_tick_count64(void)
+{
+	return sim_now;
+}
+
+/*******************************************************************************
+ * NVM3 counter objects
+ ******************************************************************************/
+
+static sim_nvm3_object_t *simNvm3Find(nvm3_ObjectKey_t key, bool create)
+{
+	uint8_t i;
+
+	for(i = 0; i < SIM_NVM3_OBJECTS; i++)
+	{
+		if(sim_nvm3[i].used && (sim_nvm3[i].key == key))
+		{
+			return &sim_nvm3[i];
+		}
+	}
+	for(i = 0; create && (i < SIM_NVM3_OBJECTS); i++)
+	{
+		if(!sim_nvm3[i].used)
+		{
+			sim_nvm3[i].used = true;
+			sim_nvm3[i].key = key;
+			sim_nvm3[i].value = 0;
+			return &sim_nvm3[i];
+		}
+	}
+	return NULL;
+}
+
+Ecode_t nvm3_open(nvm3_Handle_t *h, const nvm3_Init_t *i)
+{
+	(void)h;
+	(void)i;
+	return ECODE_NVM3_OK;
+}
+
+Ecode_t nvm3_readCounter(nvm3_Handle_t *h, nvm3_ObjectKey_t key, uint32_t *value)
+{
+	sim_nvm3_object_t *object = simNvm3Find(key, false);
+
+	(void)h;
+	if(object == NULL)
+	{
+		return ECODE_NVM3_ERR_KEY_NOT_FOUND;
+	}
+	*value = object->value;
+	return ECODE_NVM3_OK;
+}
+
+Ecode_t nvm3_writeCounter(nvm3_Handle_t *h, nvm3_ObjectKey_t key, uint32_t value)
+{
+	sim_nvm3_object_t *object = simNvm3Find(key, true);
+
+	(void)h;
+	if(object == NULL)
+	{
+		return ECODE_NVM3_ERR_STORAGE_FULL;
+	}
+	object->value = value;
+	return ECODE_NVM3_OK;
+}
+
+Ecode_t nvm3_incrementCounter(nvm3_Handle_t *h, nvm3_ObjectKey_t key, uint32_t *newValue)
+{
+	sim_nvm3_object_t *object = simNvm3Find(key, false);
+
+	(void)h;
+	if(object == NULL)
+	{
+		return ECODE_NVM3_ERR_KEY_NOT_FOUND;
+	}
+	object->value++;
+	if(newValue != NULL)
+	{
+		*newValue = object->value;
+	}
+	return ECODE_NVM3_OK;
+}
+
+bool nvm3_repackNeeded(nvm3_Handle_t *h)
+{
+	(void)h;
+	return false;
+}
+
+Ecode_t nvm3_repack(nvm3_Handle_t *h)
+{
+	(void)h;
+	return ECODE_NVM3_OK;
+}
@@ -0,0 +1,64 @@
+/*
+ * @filename	: em_cmu.h
+ * @description	: This file contains the host build replacement of the emlib CMU API
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Host build only.  The low frequency oscillators run at 32768 Hz, the core
+ * at the HFXO frequency, and the divider set for a clock is applied by
+ * CMU_ClockFreqGet().
+ */
+
+#ifndef HOST_EM_CMU_H_
+#define HOST_EM_CMU_H_
+
+#include "em_device.h"
+
+typedef uint32_t CMU_ClkDiv_TypeDef;
+
+#define cmuClkDiv_1		1
+#define cmuClkDiv_2		2
+#define cmuClkDiv_4		4
+#define cmuClkDiv_8		8
+
+typedef enum
+{
+	cmuClock_HF = 0,
+	cmuClock_CORE,
+	cmuClock_HFPER,
+	cmuClock_LFA,
+	cmuClock_LFB,
+	cmuClock_LETIMER0,
+	cmuClock_GPIO,
+	cmuClock_I2C0,
+	cmuClock_LDMA,
+	cmuClock_USART0,
+	cmuClock_COUNT
+}CMU_Clock_TypeDef;
+
+typedef enum
+{
+	cmuOsc_LFXO = 0,
+	cmuOsc_LFRCO,
+	cmuOsc_ULFRCO,
+	cmuOsc_HFXO,
+	cmuOsc_HFRCO
+}CMU_Osc_TypeDef;
+
+typedef enum
+{
+	cmuSelect_Disabled = 0,
+	cmuSelect_LFXO,
+	cmuSelect_LFRCO,
+	cmuSelect_ULFRCO,
+	cmuSelect_HFXO
+}CMU_Select_TypeDef;
+
+void CMU_ClockEnable(CMU_Clock_TypeDef clock, bool enable);
+void CMU_ClockDivSet(CMU_Clock_TypeDef clock, CMU_ClkDiv_TypeDef div);
+void CMU_ClockSelectSet(CMU_Clock_TypeDef clock, CMU_Select_TypeDef ref);
+void CMU_OscillatorEnable(CMU_Osc_TypeDef osc, bool enable, bool wait);
+uint32_t CMU_ClockFreqGet(CMU_Clock_TypeDef clock);
+
+#endif /* HOST_EM_CMU_H_ */
@@ -0,0 +1,23 @@
+/*
+ * @filename	: em_core.h
+ * @description	: This file contains the host build replacement of the emlib CORE API
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Host build only.  Interrupt handlers run on the main thread, between two
+ * events, so critical sections have nothing to mask.
+ */
+
+#ifndef HOST_EM_CORE_H_
+#define HOST_EM_CORE_H_
+
+#include "em_device.h"
+
+#define CORE_DECLARE_IRQ_STATE		(void)0
+#define CORE_ENTER_CRITICAL()		(void)0
+#define CORE_EXIT_CRITICAL()		(void)0
+#define CORE_ENTER_ATOMIC()			(void)0
+#define CORE_EXIT_ATOMIC()			(void)0
+
+#endif /* HOST_EM_CORE_H_ */
@@ -0,0 +1,64 @@
+/*
+ * @filename	: em_device.h
+ * @description	: This file contains the host build replacement of the device header
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Host build only.  The peripherals are opaque handles to the models in
+ * host/hal_sim.c and the NVIC calls do nothing, interrupt handlers are called
+ * by the simulation when their interrupt is due.  DWT CYCCNT is the host
+ * monotonic clock scaled to the core clock, brought up to date each time DWT
+ * is used, so the cycles of a handler are its time on this host.
+ */
+
+#ifndef HOST_EM_DEVICE_H_
+#define HOST_EM_DEVICE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum
+{
+	GPIO_EVEN_IRQn,
+	GPIO_ODD_IRQn,
+	I2C0_IRQn,
+	LETIMER0_IRQn,
+	LDMA_IRQn,
+	USART0_RX_IRQn,
+	USART0_TX_IRQn
+}IRQn_Type;
+
+#define CoreDebug_DEMCR_TRCENA_Msk	(1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk		(1UL << 0)
+
+typedef struct
+{
+	volatile uint32_t DEMCR;
+}CoreDebug_Type;
+
+typedef struct
+{
+	volatile uint32_t CTRL;
+	volatile uint32_t CYCCNT;
+}DWT_Type;
+
+typedef struct LETIMER_TypeDef LETIMER_TypeDef;
+typedef struct I2C_TypeDef I2C_TypeDef;
+
+extern LETIMER_TypeDef sim_letimer0;
+extern I2C_TypeDef sim_i2c0;
+extern CoreDebug_Type sim_core_debug;
+
+DWT_Type *simDwt(void);
+
+#define LETIMER0	(&sim_letimer0)
+#define I2C0		(&sim_i2c0)
+#define CoreDebug	(&sim_core_debug)
+#define DWT			(simDwt())
+
+static inline void NVIC_EnableIRQ(IRQn_Type irq) { (void)irq; }
+static inline void NVIC_DisableIRQ(IRQn_Type irq) { (void)irq; }
+static inline void NVIC_ClearPendingIRQ(IRQn_Type irq) { (void)irq; }
+
+#endif /* HOST_EM_DEVICE_H_ */
@@ -0,0 +1,21 @@
+/*
+ * @filename	: em_emu.h
+ * @description	: This file contains the host build replacement of the emlib EMU API
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Host build only.  The simulation never sleeps, time moves forward in
+ * gecko_wait_event().
+ */
+
+#ifndef HOST_EM_EMU_H_
+#define HOST_EM_EMU_H_
+
+#include "em_device.h"
+
+static inline void EMU_EnterEM1(void) { }
+static inline void EMU_EnterEM2(bool restore) { (void)restore; }
+static inline void EMU_EnterEM3(bool restore) { (void)restore; }
+
+#endif /* HOST_EM_EMU_H_ */
@@ -0,0 +1,55 @@
+/*
+ * @filename	: em_gpio.h
+ * @description	: This file contains the host build replacement of the emlib GPIO API
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Host build only.  Pin levels are kept by host/hal_sim.c, inputs are driven
+ * with simGpioInput().
+ */
+
+#ifndef HOST_EM_GPIO_H_
+#define HOST_EM_GPIO_H_
+
+#include "em_device.h"
+
+typedef enum
+{
+	gpioPortA = 0,
+	gpioPortB,
+	gpioPortC,
+	gpioPortD,
+	gpioPortE,
+	gpioPortF
+}GPIO_Port_TypeDef;
+
+typedef enum
+{
+	gpioModeDisabled = 0,
+	gpioModeInput,
+	gpioModeInputPull,
+	gpioModeInputPullFilter,
+	gpioModePushPull,
+	gpioModeWiredAnd
+}GPIO_Mode_TypeDef;
+
+typedef enum
+{
+	gpioDriveStrengthWeakAlternateWeak = 0,
+	gpioDriveStrengthWeakAlternateStrong,
+	gpioDriveStrengthStrongAlternateWeak,
+	gpioDriveStrengthStrongAlternateStrong
+}GPIO_DriveStrength_TypeDef;
+
+void GPIO_DriveStrengthSet(GPIO_Port_TypeDef port, GPIO_DriveStrength_TypeDef strength);
+void GPIO_PinModeSet(GPIO_Port_TypeDef port, unsigned int pin, GPIO_Mode_TypeDef mode, unsigned int out);
+void GPIO_PinOutSet(GPIO_Port_TypeDef port, unsigned int pin);
+void GPIO_PinOutClear(GPIO_Port_TypeDef port, unsigned int pin);
+void GPIO_PinOutToggle(GPIO_Port_TypeDef port, unsigned int pin);
+unsigned int GPIO_PinOutGet(GPIO_Port_TypeDef port, unsigned int pin);
+unsigned int GPIO_PinInGet(GPIO_Port_TypeDef port, unsigned int pin);
+void GPIO_ExtIntConfig(GPIO_Port_TypeDef port, unsigned int pin, unsigned int intNo,
+					   bool risingEdge, bool fallingEdge, bool enable);
+
+#endif /* HOST_EM_GPIO_H_ */
@@ -0,0 +1,42 @@
+/*
+ * @filename	: em_i2c.h
+ * @description	: This file contains the host build replacement of the emlib I2C types
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Host build only.  The host build uses I2C_TRANSFER_MOCK, which never
+ * touches the bus, so only the types i2c.c declares are provided.
+ */
+
+#ifndef HOST_EM_I2C_H_
+#define HOST_EM_I2C_H_
+
+#include "em_device.h"
+
+#define I2C_FLAG_WRITE		0x0001
+#define I2C_FLAG_READ		0x0002
+
+typedef enum
+{
+	i2cTransferInProgress = 1,
+	i2cTransferDone = 0,
+	i2cTransferNack = -1,
+	i2cTransferBusErr = -2,
+	i2cTransferArbLost = -3,
+	i2cTransferUsageFault = -4,
+	i2cTransferSwFault = -5
+}I2C_TransferReturn_TypeDef;
+
+typedef struct
+{
+	uint16_t addr;
+	uint16_t flags;
+	struct
+	{
+		uint8_t *data;
+		uint16_t len;
+	}buf[2];
+}I2C_TransferSeq_TypeDef;
+
+#endif /* HOST_EM_I2C_H_ */
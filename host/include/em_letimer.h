@@ -0,0 +1,64 @@
+/*
+ * @filename	: em_letimer.h
+ * @description	: This file contains the host build replacement of the emlib LETIMER API
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Host build only.  host/hal_sim.c models LETIMER0 counting down from COMP0
+ * in free mode, raising UF when it reloads and COMP1 when it passes COMP1.
+ */
+
+#ifndef HOST_EM_LETIMER_H_
+#define HOST_EM_LETIMER_H_
+
+#include "em_device.h"
+
+#define LETIMER_IF_COMP0	0x01UL
+#define LETIMER_IF_COMP1	0x02UL
+#define LETIMER_IF_UF		0x04UL
+#define LETIMER_IEN_COMP0	LETIMER_IF_COMP0
+#define LETIMER_IEN_COMP1	LETIMER_IF_COMP1
+#define LETIMER_IEN_UF		LETIMER_IF_UF
+
+typedef enum
+{
+	letimerRepeatFree = 0,
+	letimerRepeatOneshot,
+	letimerRepeatBuffered,
+	letimerRepeatDouble
+}LETIMER_RepeatMode_TypeDef;
+
+typedef enum
+{
+	letimerUFOANone = 0,
+	letimerUFOAToggle,
+	letimerUFOAPulse,
+	letimerUFOAPwm
+}LETIMER_UFOA_TypeDef;
+
+typedef struct
+{
+	bool enable;
+	bool debugRun;
+	bool comp0Top;
+	bool bufTop;
+	uint8_t out0Pol;
+	uint8_t out1Pol;
+	LETIMER_UFOA_TypeDef ufoa0;
+	LETIMER_UFOA_TypeDef ufoa1;
+	LETIMER_RepeatMode_TypeDef repMode;
+	uint32_t topValue;
+}LETIMER_Init_TypeDef;
+
+void LETIMER_Init(LETIMER_TypeDef *letimer, const LETIMER_Init_TypeDef *init);
+void LETIMER_Enable(LETIMER_TypeDef *letimer, bool enable);
+void LETIMER_CompareSet(LETIMER_TypeDef *letimer, unsigned int comp, uint32_t value);
+uint32_t LETIMER_CounterGet(LETIMER_TypeDef *letimer);
+void LETIMER_IntEnable(LETIMER_TypeDef *letimer, uint32_t flags);
+void LETIMER_IntDisable(LETIMER_TypeDef *letimer, uint32_t flags);
+void LETIMER_IntClear(LETIMER_TypeDef *letimer, uint32_t flags);
+uint32_t LETIMER_IntGet(LETIMER_TypeDef *letimer);
+uint32_t LETIMER_IntGetEnabled(LETIMER_TypeDef *letimer);
+
+#endif /* HOST_EM_LETIMER_H_ */
@@ -0,0 +1,18 @@
+/*
+ * @filename	: glib.h
+ * @description	: This file contains the host build replacement of the GLIB header
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Host build only.  host/display_sim.c keeps the rows as strings, nothing
+ * from GLIB is used.
+ */
+
+#ifndef HOST_GLIB_H_
+#define HOST_GLIB_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#endif /* HOST_GLIB_H_ */
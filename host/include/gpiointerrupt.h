@@ -0,0 +1,22 @@
+/*
+ * @filename	: gpiointerrupt.h
+ * @description	: This file contains the host build replacement of the GPIOINT driver API
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Host build only.  Callbacks are called by simGpioInput() on an edge enabled
+ * with GPIO_ExtIntConfig().
+ */
+
+#ifndef HOST_GPIOINTERRUPT_H_
+#define HOST_GPIOINTERRUPT_H_
+
+#include "em_gpio.h"
+
+typedef void (*GPIOINT_IrqCallbackPtr_t)(uint8_t intNo);
+
+void GPIOINT_Init(void);
+void GPIOINT_CallbackRegister(uint8_t intNo, GPIOINT_IrqCallbackPtr_t callbackPtr);
+
+#endif /* HOST_GPIOINTERRUPT_H_ */
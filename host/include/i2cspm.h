@@ -0,0 +1,16 @@
+/*
+ * @filename	: i2cspm.h
+ * @description	: This file contains the host build replacement of the I2CSPM driver header
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Host build only, see em_i2c.h.
+ */
+
+#ifndef HOST_I2CSPM_H_
+#define HOST_I2CSPM_H_
+
+#include "em_i2c.h"
+
+#endif /* HOST_I2CSPM_H_ */
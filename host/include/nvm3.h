@@ -0,0 +1,33 @@
+/*
+ * @filename	: nvm3.h
+ * @description	: This file contains the host build replacement of the NVM3 API
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Host build only.  Counter objects are kept in RAM by host/hal_sim.c.
+ */
+
+#ifndef HOST_NVM3_H_
+#define HOST_NVM3_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef uint32_t Ecode_t;
+typedef uint32_t nvm3_ObjectKey_t;
+typedef struct nvm3_Handle nvm3_Handle_t;
+typedef struct nvm3_Init nvm3_Init_t;
+
+#define ECODE_NVM3_OK					0x00000000UL
+#define ECODE_NVM3_ERR_KEY_NOT_FOUND	0xF000000EUL
+#define ECODE_NVM3_ERR_STORAGE_FULL		0xF0000009UL
+
+Ecode_t nvm3_open(nvm3_Handle_t *h, const nvm3_Init_t *i);
+Ecode_t nvm3_readCounter(nvm3_Handle_t *h, nvm3_ObjectKey_t key, uint32_t *value);
+Ecode_t nvm3_writeCounter(nvm3_Handle_t *h, nvm3_ObjectKey_t key, uint32_t value);
+Ecode_t nvm3_incrementCounter(nvm3_Handle_t *h, nvm3_ObjectKey_t key, uint32_t *newValue);
+bool nvm3_repackNeeded(nvm3_Handle_t *h);
+Ecode_t nvm3_repack(nvm3_Handle_t *h);
+
+#endif /* HOST_NVM3_H_ */
@@ -0,0 +1,19 @@
+/*
+ * @filename	: nvm3_default.h
+ * @description	: This file contains the host build replacement of the default NVM3 instance
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Host build only, see nvm3.h.
+ */
+
+#ifndef HOST_NVM3_DEFAULT_H_
+#define HOST_NVM3_DEFAULT_H_
+
+#include "nvm3.h"
+
+extern nvm3_Handle_t *nvm3_defaultHandle;
+extern nvm3_Init_t *nvm3_defaultInit;
+
+#endif /* HOST_NVM3_DEFAULT_H_ */
@@ -0,0 +1,22 @@
+/*
+ * @filename	: sl_sleeptimer.h
+ * @description	: This file contains the host build replacement of the sleeptimer API
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Host build only.  The tick count is the virtual clock of the simulation.
+ */
+
+#ifndef HOST_SL_SLEEPTIMER_H_
+#define HOST_SL_SLEEPTIMER_H_
+
+#include <stdint.h>
+
+typedef uint32_t sl_status_t;
+
+sl_status_t sl_sleeptimer_init(void);
+uint32_t sl_sleeptimer_get_timer_frequency(void);
+uint64_t sl_sleeptimer_get_tick_count64(void);
+
+#endif /* HOST_SL_SLEEPTIMER_H_ */
@@ -0,0 +1,42 @@
+/*
+ * @filename	: sleep.h
+ * @description	: This file contains the host build replacement of the SLEEP driver API
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Host build only.  Sleep blocks are counted, and the callbacks are called
+ * around each move of the virtual time, see simSleep() in host/sim.h.
+ */
+
+#ifndef HOST_SLEEP_H_
+#define HOST_SLEEP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum
+{
+	sleepEM0 = 0,
+	sleepEM1,
+	sleepEM2,
+	sleepEM3,
+	sleepEM4
+}SLEEP_EnergyMode_t;
+
+typedef void (*SLEEP_CbFuncPtr_t)(SLEEP_EnergyMode_t);
+
+typedef struct
+{
+	bool (*sleepCallback)(SLEEP_EnergyMode_t emode);
+	void (*wakeupCallback)(SLEEP_EnergyMode_t emode);
+	uint32_t (*restoreCallback)(SLEEP_EnergyMode_t emode);
+}SLEEP_Init_t;
+
+void SLEEP_Init(SLEEP_CbFuncPtr_t pSleepCb, SLEEP_CbFuncPtr_t pWakeUpCb);
+void SLEEP_InitEx(const SLEEP_Init_t *init);
+SLEEP_EnergyMode_t SLEEP_LowestEnergyModeGet(void);
+void SLEEP_SleepBlockBegin(SLEEP_EnergyMode_t eMode);
+void SLEEP_SleepBlockEnd(SLEEP_EnergyMode_t eMode);
+
+#endif /* HOST_SLEEP_H_ */
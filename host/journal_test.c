@@ -0,0 +1,225 @@
+/*
+ * @filename	: journal_test.c
+ * @description	: This file contains the host test of the flash journal
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Runs src/journal.c against journal_flash_sim.c on a region of
+ * JOURNAL_FLASH_SIZE 0x4000, four sectors, so a few thousand records wrap it
+ * several times.  Checks that journalRead() returns the records in order with
+ * only the dropped oldest ones missing, across wraps and remounts, that a
+ * program cut short by a reset loses only its own records, and that the erase
+ * count in each sector header matches the erases of the simulator with no
+ * extra erase per boot.
+ *
+ * 		make -C host test
+ */
+
+#include "journal.h"
+#include "journal_flash.h"
+#include "timebase.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_HEADER_MAGIC		0x4C4E524AUL	//journal.c JOURNAL_MAGIC
+#define TEST_READ_BATCH			7				//Not a divisor of the sector, batches cross sectors
+#define TEST_MAX_RECORDS		(JOURNAL_SECTOR_COUNT * JOURNAL_RECORDS_PER_SECTOR)
+#define TEST_CHECK(cond)		testCheck((cond), #cond, __LINE__)
+
+typedef char test_geometry_check[(JOURNAL_SECTOR_COUNT == 4) ? 1 : -1];
+
+static uint64_t test_ms = 0;
+static unsigned int test_checks = 0;
+static int32_t test_next = 0;						//Value of the next record appended
+
+uint64_t timebaseGetMs(void)
+{
+	return test_ms;
+}
+
+static void testCheck(bool ok, const char *cond, int line)
+{
+	test_checks++;
+	if(!ok)
+	{
+		fprintf(stderr, "journal_test.c:%d: check failed: %s\n", line, cond);
+		exit(1);
+	}
+}
+
+/* Append count records, with the idle work the main loop would do between them */
+static void testAppend(uint32_t count)
+{
+	while(count--)
+	{
+		journalAppend(JOURNAL_TEMPERATURE, 0x0010, test_next++, 0);
+		test_ms += 1000;
+		journalIdle();
+	}
+}
+
+/* Reboot: records still staged are lost, as on a reset */
+static void testReboot(void)
+{
+	journalInit();
+	journalIdle();
+}
+
+/*
+ * Read the whole journal.  Values of the test records must grow by one,
+ * except across the values in the lost list, and the newest must be
+ * test_next - 1.  journalCount() also counts the torn slots.  Returns the
+ * number of test records.
+ */
+static uint32_t testReadAll(const int32_t *lost, uint32_t lost_count, uint32_t torn)
+{
+	static journal_record_t records[TEST_MAX_RECORDS + 64];
+	journal_cursor_t cursor;
+	uint32_t count = 0, tests = 0, i, j;
+	int32_t expected = 0;
+	uint16_t got;
+	bool first = true;
+
+	journalCursorOldest(&cursor);
+	do
+	{
+		TEST_CHECK((count + TEST_READ_BATCH) <= (sizeof(records) / sizeof(records[0])));
+		got = journalRead(&cursor, &records[count], TEST_READ_BATCH);
+		count += got;
+	}while(got);
+	TEST_CHECK((count + torn) == journalCount());
+
+	for(i = 0; i < count; i++)
+	{
+		if(records[i].type == JOURNAL_BOOT)
+		{
+			continue;
+		}
+		TEST_CHECK(records[i].type == JOURNAL_TEMPERATURE);
+		if(!first)
+		{
+			for(j = 0; j < lost_count; j++)
+			{
+				if(lost[j] == expected)
+				{
+					expected++;
+				}
+			}
+			TEST_CHECK(records[i].value == expected);
+		}
+		first = false;
+		expected = records[i].value + 1;
+		tests++;
+	}
+	TEST_CHECK(expected == test_next);
+	return tests;
+}
+
+/* Erase count in each valid or reserved sector header against the simulator */
+static void testEraseCounts(void)
+{
+	uint32_t header[4];
+	uint16_t sector;
+
+	journalFlashBegin();
+	for(sector = 0; sector < JOURNAL_SECTOR_COUNT; sector++)
+	{
+		TEST_CHECK(journalFlashRead((uint32_t)sector * JOURNAL_SECTOR_SIZE, header, sizeof(header)));
+		if(header[0] == TEST_HEADER_MAGIC)
+		{
+			TEST_CHECK(header[2] == journalFlashSimEraseCount(sector));
+		}
+	}
+	journalFlashEnd();
+}
+
+static uint32_t testTotalErases(void)
+{
+	uint32_t total = 0;
+	uint16_t sector;
+
+	for(sector = 0; sector < JOURNAL_SECTOR_COUNT; sector++)
+	{
+		total += journalFlashSimEraseCount(sector);
+	}
+	return total;
+}
+
+int main(void)
+{
+	int32_t lost[JOURNAL_RECORDS_PER_PAGE];
+	uint32_t lost_count = 0, erases, programs, i;
+
+	/* Format, then fill less than the region */
+	journalFlashSimReset();
+	testReboot();
+	TEST_CHECK(journalFlashSimEraseCount(0) == 1);
+	TEST_CHECK(journalFlashSimEraseCount(1) == 1);
+	testAppend(500);
+	journalFlush();
+	TEST_CHECK(testReadAll(NULL, 0, 0) == 500);
+	testEraseCounts();
+
+	/* Wrap the region several times, the oldest sectors are dropped whole */
+	testAppend(5000);
+	journalFlush();
+	TEST_CHECK(testReadAll(NULL, 0, 0) >= (TEST_MAX_RECORDS - (2 * JOURNAL_RECORDS_PER_SECTOR)));
+	testEraseCounts();
+
+	/* Remounts keep the records and erase nothing again */
+	erases = testTotalErases();
+	for(i = 0; i < 3; i++)
+	{
+		testReboot();
+		testReadAll(NULL, 0, 0);
+		testEraseCounts();
+	}
+	TEST_CHECK(testTotalErases() == erases);
+
+	/* Remounts with the sector ahead erased by an idle window keep its count in flash */
+	testAppend(JOURNAL_RECORDS_PER_SECTOR);
+	journalFlush();
+	erases = testTotalErases();
+	for(i = 0; i < 3; i++)
+	{
+		testReboot();
+		testEraseCounts();
+	}
+	TEST_CHECK(testTotalErases() == erases);
+	testAppend(3 * JOURNAL_RECORDS_PER_SECTOR);
+	journalFlush();
+	testReadAll(NULL, 0, 0);
+	testEraseCounts();
+
+	/* A reset in the middle of a page program: the page is cut after 2.5 records */
+	testAppend(3);
+	journalFlush();
+	programs = journalFlashSimProgramCount();
+	for(i = 0; i < 5; i++)
+	{
+		journalAppend(JOURNAL_TEMPERATURE, 0x0010, test_next, 0);
+		if(i >= 2)
+		{
+			lost[lost_count++] = test_next;
+		}
+		test_next++;
+	}
+	journalFlashSimFailAfter((2 * JOURNAL_RECORD_SIZE) + (JOURNAL_RECORD_SIZE / 2));
+	journalFlush();
+	TEST_CHECK(journalFlashSimProgramCount() == (programs + 1));
+	journalFlashSimFailAfter(UINT32_MAX);
+	testReboot();
+	testAppend(2 * JOURNAL_RECORDS_PER_PAGE);
+	journalFlush();
+	testReadAll(lost, lost_count, 1);
+	testEraseCounts();
+
+	/* And the torn slot is skipped again after one more remount */
+	testReboot();
+	testReadAll(lost, lost_count, 1);
+
+	printf("journal_test: %u checks passed\n", test_checks);
+	return 0;
+}
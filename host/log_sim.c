@@ -0,0 +1,72 @@
+/*
+ * @filename	: log_sim.c
+ * @description	: This file contains the logger of the host simulation
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Log lines go to stdout with the virtual time as their timestamp.  Building
+ * with LOGGING=0 removes the log calls as on target, for throughput runs.
+ */
+
+#include "sim.h"
+#include "log.h"
+#include "timebase.h"
+#include <stdarg.h>
+
+#if INCLUDE_LOGGING
+
+uint32_t log_dropped_lines = 0;
+static bool sim_log_quiet = false;
+
+void logInit(void)
+{
+}
+
+void logPrintf(const char *format, ...)
+{
+	va_list args;
+
+	if(sim_log_quiet)
+	{
+		return;
+	}
+	va_start(args, format);
+	vprintf(format, args);
+	va_end(args);
+}
+
+void logTokenized(uint16_t id, uint16_t types, ...)
+{
+	(void)id;
+	(void)types;
+}
+
+bool logTxActive(void)
+{
+	return false;
+}
+
+uint32_t loggerGetTimestamp(void)
+{
+	return (uint32_t)timebaseGetMs();
+}
+
+void logFlush(void)
+{
+	fflush(stdout);
+}
+
+void simLogQuiet(bool quiet)
+{
+	sim_log_quiet = quiet;
+}
+
+#else
+
+void simLogQuiet(bool quiet)
+{
+	(void)quiet;
+}
+
+#endif /* INCLUDE_LOGGING */
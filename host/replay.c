@@ -0,0 +1,166 @@
+/*
+ * @filename	: replay.c
+ * @description	: This file contains the trace replay of the host simulation
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Reads a trace image, saved from the node or by simTraceSave(), and hands its
+ * records to gecko_wait_event() in place of the script.  Each event is queued
+ * at its recorded time, with PB0, PB1 and the PIR input set to the levels
+ * recorded with it.  While a trace is replayed the models raise no events of
+ * their own: soft timer and external signal events all come from the trace, so
+ * the application sees the recorded event sequence exactly.  LETIMER0 still
+ * interrupts, an interrupt due at the time of a record first, as the handler
+ * keeps state that the signal handlers read; the signals it posts are dropped.
+ *
+ * What the handlers read from hardware other than the recorded input pins is
+ * not in the trace.  The humidity readings of a replay are those of the mock
+ * I2C transfer, not the ones the node measured.
+ */
+
+#include "sim.h"
+#include "trace.h"
+#include "gpio.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define REPLAY_RING_MAX		0x4000000	//Larger rings are taken for a corrupt file
+
+static trace_header_t replay_header;
+static uint8_t *replay_ring = NULL;
+static uint32_t replay_position = 0;
+static trace_record_t replay_record;
+static bool replay_active = false;
+static bool replay_pending = false;			//replay_record is read and not queued yet
+static bool replay_started = false;
+static uint32_t replay_last_ticks;			//Timestamp of the record before, for the wrap
+static uint64_t replay_ticks;				//Timestamp without the wraps, in trace ticks
+static uint64_t replay_due;
+
+/* Read the next record and work out its virtual time */
+static void simReplayFetch(void)
+{
+	replay_pending = traceRecordRead(&replay_header, replay_ring, &replay_position, &replay_record);
+	if(!replay_pending)
+	{
+		return;
+	}
+	if(replay_started)
+	{
+		replay_ticks += (uint32_t)(replay_record.ticks - replay_last_ticks);
+	}
+	else
+	{
+		replay_ticks = replay_record.ticks;
+		replay_started = true;
+	}
+	replay_last_ticks = replay_record.ticks;
+	replay_due = (replay_ticks * SIM_TICK_HZ) / replay_header.tick_frequency;
+}
+
+bool simReplayLoad(const char *path)
+{
+	FILE *file = fopen(path, "rb");
+	bool ok = false;
+
+	if(file == NULL)
+	{
+		fprintf(stderr, "%s: cannot open\n", path);
+		return false;
+	}
+	if(fread(&replay_header, sizeof(replay_header), 1, file) != 1)
+	{
+		fprintf(stderr, "%s: no trace header\n", path);
+	}
+	else if((replay_header.magic != TRACE_MAGIC) || (replay_header.version != TRACE_VERSION) ||
+			(replay_header.record_header_size != TRACE_RECORD_HEADER_SIZE))
+	{
+		fprintf(stderr, "%s: not a version %d trace\n", path, TRACE_VERSION);
+	}
+	else if((replay_header.ring_size == 0) || (replay_header.ring_size > REPLAY_RING_MAX) ||
+			(replay_header.boot_size >= replay_header.ring_size) || (replay_header.boot_used > replay_header.boot_size) ||
+			(replay_header.head >= (replay_header.ring_size - replay_header.boot_size)) ||
+			(replay_header.used > (replay_header.ring_size - replay_header.boot_size)) ||
+			(replay_header.tick_frequency == 0))
+	{
+		fprintf(stderr, "%s: trace header is corrupt\n", path);
+	}
+	else if((replay_ring = malloc(replay_header.ring_size)) == NULL)
+	{
+		fprintf(stderr, "%s: no memory for a %lu byte ring\n", path, (unsigned long)replay_header.ring_size);
+	}
+	else if(fread(replay_ring, replay_header.ring_size, 1, file) != 1)
+	{
+		fprintf(stderr, "%s: trace ring is cut short\n", path);
+	}
+	else
+	{
+		ok = true;
+	}
+	fclose(file);
+	if(!ok)
+	{
+		return false;
+	}
+	replay_active = true;
+	replay_position = 0;
+	replay_started = false;
+	simReplayFetch();
+	if(replay_header.dropped)
+	{
+		fprintf(stderr, "%s: %lu records between the boot records and the oldest one in the ring were dropped\n",
+				path, (unsigned long)replay_header.dropped);
+	}
+	return true;
+}
+
+bool simReplayActive(void)
+{
+	return replay_active;
+}
+
+uint64_t simReplayNext(void)
+{
+	return replay_pending ? replay_due : SIM_NEVER;
+}
+
+void simReplayStep(void)
+{
+	if(!replay_pending)
+	{
+		return;
+	}
+	simGpioLevel(PB0_Port, PB0_Pin, (replay_record.inputs & TRACE_INPUT_PB0) ? 1 : 0);
+	simGpioLevel(PB1_Port, PB1_Pin, (replay_record.inputs & TRACE_INPUT_PB1) ? 1 : 0);
+	simGpioLevel(MOTION_PORT, MOTION_PIN, (replay_record.inputs & TRACE_INPUT_PIR) ? 1 : 0);
+	simEventPush(BGLIB_MSG_ID(replay_record.header), replay_record.data, replay_record.len);
+	sim_stats.trace_records++;
+	simReplayFetch();
+}
+
+bool simTraceSave(const char *path)
+{
+	const trace_image_t *image = traceImage();
+	FILE *file;
+	bool ok;
+
+	if(image == NULL)
+	{
+		fprintf(stderr, "%s: built without INCLUDE_TRACE\n", path);
+		return false;
+	}
+	file = fopen(path, "wb");
+	if(file == NULL)
+	{
+		fprintf(stderr, "%s: cannot create\n", path);
+		return false;
+	}
+	ok = fwrite(image, sizeof(image->header) + image->header.ring_size, 1, file) == 1;
+	ok = (fclose(file) == 0) && ok;
+	if(!ok)
+	{
+		fprintf(stderr, "%s: write failed\n", path);
+	}
+	return ok;
+}
@@ -0,0 +1,474 @@
+/*
+ * @filename	: script.c
+ * @description	: This file contains the event script reader of the host simulation
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * A script line is a delay in ms from the line before, a command and its
+ * arguments, numbers in C notation.  Lines starting with # are comments.
+ * Stack commands queue the stack event the command is named after, hardware
+ * commands drive a pin or the mock sensor.  See host/scripts/ward.txt.
+ */
+
+#include "sim.h"
+#include "main.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#define SCRIPT_LINES_MAX	4096
+#define SCRIPT_ARGS_MAX		6
+#define SCRIPT_DATA_MAX		64		//Bytes of a hex argument
+#define SCRIPT_TEXT_MAX		256
+#define SCRIPT_ATT_WRITE	0x12	//ATT Write Request opcode
+#define SCRIPT_ATT_READ		0x0a	//ATT Read Request opcode
+#define SCRIPT_ATT_READ_BLOB	0x0c	//ATT Read Blob Request opcode, a read from an offset
+
+typedef struct
+{
+	uint32_t delay_ms;
+	uint8_t command;			//Index in script_commands
+	int32_t args[SCRIPT_ARGS_MAX];
+	uint8_t data_len;
+	uint8_t data[SCRIPT_DATA_MAX];
+}script_line_t;
+
+typedef struct
+{
+	const char *name;
+	uint8_t args;				//Number arguments
+	bool data;					//Followed by a hex argument
+	void (*run)(const script_line_t *line);
+}script_command_t;
+
+typedef struct
+{
+	const char *name;
+	uint16_t handle;
+}script_characteristic_t;
+
+static script_line_t script_lines[SCRIPT_LINES_MAX];
+static uint16_t script_count = 0;
+static uint16_t script_index = 0;
+static uint16_t script_loop = 0;			//Line the repeats start from
+static uint32_t script_loops_left = 0;
+static uint64_t script_due = 0;				//Tick the line at script_index is due
+static uint16_t script_address = 0;			//Unicast address of this node, from the initialized command
+
+static const script_characteristic_t script_characteristics[] =
+{
+	{ "ota_control", gattdb_ota_control },
+	{ "history_control", gattdb_history_control },
+	{ "history_data", gattdb_history_data },
+	{ "live_telemetry", gattdb_live_telemetry },
+	{ "event_profile", gattdb_event_profile },
+};
+
+/*******************************************************************************
+ * Commands
+ ******************************************************************************/
+
+static void scriptNone(const script_line_t *line)
+{
+	(void)line;
+}
+
+static void scriptBoot(const script_line_t *line)
+{
+	struct gecko_msg_system_boot_evt_t evt = { .major = 2 };
+
+	(void)line;
+	simEventPush(gecko_evt_system_boot_id, &evt, sizeof(evt));
+}
+
+static void scriptInitialized(const script_line_t *line)
+{
+	struct gecko_msg_mesh_node_initialized_evt_t evt = { .provisioned = 1 };
+
+	evt.address = (uint16)line->args[0];
+	script_address = evt.address;
+	simEventPush(gecko_evt_mesh_node_initialized_id, &evt, sizeof(evt));
+}
+
+static void scriptUnprovisioned(const script_line_t *line)
+{
+	struct gecko_msg_mesh_node_initialized_evt_t evt = { .provisioned = 0 };
+
+	(void)line;
+	simEventPush(gecko_evt_mesh_node_initialized_id, &evt, sizeof(evt));
+}
+
+static void scriptNodeReset(const script_line_t *line)
+{
+	(void)line;
+	simEventPush(gecko_evt_mesh_node_reset_id, NULL, 0);
+}
+
+static void scriptFriend(const script_line_t *line)
+{
+	struct gecko_msg_mesh_friend_friendship_established_evt_t evt;
+
+	evt.lpn_address = (uint16)line->args[0];
+	simEventPush(gecko_evt_mesh_friend_friendship_established_id, &evt, sizeof(evt));
+}
+
+static void scriptFriendLost(const script_line_t *line)
+{
+	struct gecko_msg_mesh_friend_friendship_terminated_evt_t evt;
+
+	evt.reason = (uint16)line->args[0];
+	simEventPush(gecko_evt_mesh_friend_friendship_terminated_id, &evt, sizeof(evt));
+}
+
+void simClientRequest(uint16_t model_id, uint16_t client, uint16_t server, uint8_t type, const uint8_t *parameters,
+					  uint8_t len)
+{
+	uint8_t buf[sizeof(struct gecko_msg_mesh_generic_server_client_request_evt_t) + SCRIPT_DATA_MAX];
+	struct gecko_msg_mesh_generic_server_client_request_evt_t *evt = (void *)buf;
+
+	if(len > SCRIPT_DATA_MAX)
+	{
+		return;
+	}
+	memset(evt, 0, sizeof(*evt));
+	evt->model_id = model_id;
+	evt->client_address = client;
+	evt->server_address = server;
+	evt->type = type;
+	evt->parameters.len = len;
+	memcpy(evt->parameters.data, parameters, len);
+	simEventPush(gecko_evt_mesh_generic_server_client_request_id, evt, sizeof(*evt) + len);
+}
+
+static void scriptOnoff(const script_line_t *line)
+{
+	uint8_t on_off = line->args[1] ? 1 : 0;
+
+	simClientRequest(MESH_GENERIC_ON_OFF_SERVER_MODEL_ID, (uint16_t)line->args[0], script_address,
+					 mesh_generic_request_on_off, &on_off, sizeof(on_off));
+}
+
+static void scriptLevel(const script_line_t *line)
+{
+	uint8_t level[2] = { (uint8_t)line->args[1], (uint8_t)(line->args[1] >> 8) };
+
+	simClientRequest(MESH_GENERIC_LEVEL_SERVER_MODEL_ID, (uint16_t)line->args[0], script_address,
+					 mesh_generic_request_level, level, sizeof(level));
+}
+
+static void scriptSensor(const script_line_t *line)
+{
+	uint8_t buf[sizeof(struct gecko_msg_mesh_sensor_client_status_evt_t) + SCRIPT_DATA_MAX];
+	struct gecko_msg_mesh_sensor_client_status_evt_t *evt = (void *)buf;
+
+	memset(evt, 0, sizeof(*evt));
+	evt->server_address = (uint16)line->args[0];
+	evt->client_address = script_address;
+	evt->sensor_data.len = line->data_len;
+	memcpy(evt->sensor_data.data, line->data, line->data_len);
+	simEventPush(gecko_evt_mesh_sensor_client_status_id, evt, sizeof(*evt) + line->data_len);
+}
+
+static void scriptButton(const script_line_t *line)
+{
+	simGpioInput(PB0_Port, PB0_Pin, line->args[0] ? 0 : 1);	//Pressed pulls PB0 low
+}
+
+static void scriptPir(const script_line_t *line)
+{
+	simGpioInput(MOTION_PORT, MOTION_PIN, line->args[0] ? 1 : 0);
+}
+
+static void scriptHumidity(const script_line_t *line)
+{
+	I2C_MockSetHumidityCode((uint16_t)line->args[0]);
+}
+
+static void scriptSwarm(const script_line_t *line)
+{
+	swarm_config_t config;
+
+	config.lpns = (uint16_t)line->args[0];
+	config.level_ms = (uint32_t)line->args[1];
+	config.onoff_ms = (uint32_t)line->args[2];
+	config.friendship_ms = (uint32_t)line->args[3];
+	config.pir_ms = (uint32_t)line->args[4];
+	config.button_ms = (uint32_t)line->args[5];
+	simSwarmStart(&config, script_address);
+}
+
+static void scriptConnect(const script_line_t *line)
+{
+	struct gecko_msg_le_connection_opened_evt_t evt;
+
+	memset(&evt, 0, sizeof(evt));
+	evt.connection = (uint8)line->args[0];
+	evt.bonding = 0xFF;
+	simEventPush(gecko_evt_le_connection_opened_id, &evt, sizeof(evt));
+}
+
+static void scriptDisconnect(const script_line_t *line)
+{
+	struct gecko_msg_le_connection_closed_evt_t evt;
+
+	evt.connection = (uint8)line->args[0];
+	evt.reason = (uint16)line->args[1];
+	simEventPush(gecko_evt_le_connection_closed_id, &evt, sizeof(evt));
+}
+
+static void scriptParams(const script_line_t *line)
+{
+	struct gecko_msg_le_connection_parameters_evt_t evt;
+
+	memset(&evt, 0, sizeof(evt));
+	evt.connection = (uint8)line->args[0];
+	evt.interval = (uint16)line->args[1];
+	evt.timeout = 100;
+	evt.txsize = 27;
+	simEventPush(gecko_evt_le_connection_parameters_id, &evt, sizeof(evt));
+}
+
+static void scriptMtu(const script_line_t *line)
+{
+	struct gecko_msg_gatt_mtu_exchanged_evt_t evt;
+
+	evt.connection = (uint8)line->args[0];
+	evt.mtu = (uint16)line->args[1];
+	simMtuSet(evt.connection, evt.mtu);
+	simEventPush(gecko_evt_gatt_mtu_exchanged_id, &evt, sizeof(evt));
+}
+
+static void scriptNotify(const script_line_t *line)
+{
+	struct gecko_msg_gatt_server_characteristic_status_evt_t evt;
+
+	evt.connection = (uint8)line->args[0];
+	evt.characteristic = (uint16)line->args[1];
+	evt.status_flags = gatt_server_client_config;
+	evt.client_config_flags = (uint16)line->args[2];
+	simEventPush(gecko_evt_gatt_server_characteristic_status_id, &evt, sizeof(evt));
+}
+
+static void scriptWrite(const script_line_t *line)
+{
+	uint8_t buf[sizeof(struct gecko_msg_gatt_server_user_write_request_evt_t) + SCRIPT_DATA_MAX];
+	struct gecko_msg_gatt_server_user_write_request_evt_t *evt = (void *)buf;
+
+	memset(evt, 0, sizeof(*evt));
+	evt->connection = (uint8)line->args[0];
+	evt->characteristic = (uint16)line->args[1];
+	evt->att_opcode = SCRIPT_ATT_WRITE;
+	evt->value.len = line->data_len;
+	memcpy(evt->value.data, line->data, line->data_len);
+	simEventPush(gecko_evt_gatt_server_user_write_request_id, evt, sizeof(*evt) + line->data_len);
+}
+
+static void scriptRead(const script_line_t *line)
+{
+	struct gecko_msg_gatt_server_user_read_request_evt_t evt;
+
+	evt.connection = (uint8)line->args[0];
+	evt.characteristic = (uint16)line->args[1];
+	evt.offset = (uint16)line->args[2];
+	evt.att_opcode = evt.offset ? SCRIPT_ATT_READ_BLOB : SCRIPT_ATT_READ;
+	simEventPush(gecko_evt_gatt_server_user_read_request_id, &evt, sizeof(evt));
+}
+
+static const script_command_t script_commands[] =
+{
+	{ "wait", 0, false, scriptNone },					//Only the delay
+	{ "loop", 0, false, scriptNone },					//Repeats start from the next line
+	{ "boot", 0, false, scriptBoot },
+	{ "initialized", 1, false, scriptInitialized },		//address, provisioned node
+	{ "unprovisioned", 0, false, scriptUnprovisioned },
+	{ "node_reset", 0, false, scriptNodeReset },
+	{ "friend", 1, false, scriptFriend },				//LPN address
+	{ "friend_lost", 1, false, scriptFriendLost },		//reason
+	{ "onoff", 2, false, scriptOnoff },					//LPN address, 0 or 1
+	{ "level", 2, false, scriptLevel },					//LPN address, level
+	{ "sensor", 1, true, scriptSensor },				//LPN address, marshalled sensor data
+	{ "button", 1, false, scriptButton },				//1 pressed, 0 released
+	{ "pir", 1, false, scriptPir },						//PIR output level
+	{ "humidity", 1, false, scriptHumidity },			//Si7021 code of the next readings
+	{ "swarm", 6, false, scriptSwarm },					//LPNs, level, onoff, friendship, PIR and PB0 periods in ms
+	{ "connect", 1, false, scriptConnect },				//connection
+	{ "disconnect", 2, false, scriptDisconnect },		//connection, reason
+	{ "params", 2, false, scriptParams },				//connection, interval in 1.25 ms
+	{ "mtu", 2, false, scriptMtu },						//connection, ATT MTU
+	{ "notify", 3, false, scriptNotify },				//connection, characteristic, client config flags
+	{ "write", 2, true, scriptWrite },					//connection, characteristic, value
+	{ "read", 3, false, scriptRead },					//connection, characteristic, offset
+};
+
+#define SCRIPT_COMMANDS		(sizeof(script_commands) / sizeof(script_commands[0]))
+#define SCRIPT_COMMAND_LOOP	1
+
+/*******************************************************************************
+ * Reader
+ ******************************************************************************/
+
+static bool scriptNumber(const char *token, int32_t *value)
+{
+	char *end;
+	uint8_t i;
+
+	for(i = 0; i < (sizeof(script_characteristics) / sizeof(script_characteristics[0])); i++)
+	{
+		if(strcmp(token, script_characteristics[i].name) == 0)
+		{
+			*value = script_characteristics[i].handle;
+			return true;
+		}
+	}
+	*value = (int32_t)strtol(token, &end, 0);
+	return (*end == 0) && (end != token);
+}
+
+static bool scriptHex(const char *token, script_line_t *line)
+{
+	unsigned int byte;
+	size_t len = strlen(token);
+
+	if(((len % 2) != 0) || ((len / 2) > SCRIPT_DATA_MAX))
+	{
+		return false;
+	}
+	for(line->data_len = 0; *token; token += 2)
+	{
+		if(!isxdigit((unsigned char)token[0]) || !isxdigit((unsigned char)token[1]) ||
+		   (sscanf(token, "%2x", &byte) != 1))
+		{
+			return false;
+		}
+		line->data[line->data_len++] = (uint8_t)byte;
+	}
+	return true;
+}
+
+static bool scriptParse(char *text, script_line_t *line, bool *empty)
+{
+	char *token;
+	int32_t delay;
+	uint8_t i;
+
+	*empty = false;
+	token = strtok(text, " \t\r\n");
+	if((token == NULL) || (token[0] == '#'))
+	{
+		*empty = true;
+		return true;
+	}
+	if(!scriptNumber(token, &delay) || (delay < 0) || ((token = strtok(NULL, " \t\r\n")) == NULL))
+	{
+		return false;
+	}
+	memset(line, 0, sizeof(*line));
+	line->delay_ms = (uint32_t)delay;
+	for(line->command = 0; line->command < SCRIPT_COMMANDS; line->command++)
+	{
+		if(strcmp(token, script_commands[line->command].name) == 0)
+		{
+			break;
+		}
+	}
+	if(line->command == SCRIPT_COMMANDS)
+	{
+		return false;
+	}
+	for(i = 0; i < script_commands[line->command].args; i++)
+	{
+		token = strtok(NULL, " \t\r\n");
+		if((token == NULL) || !scriptNumber(token, &line->args[i]))
+		{
+			return false;
+		}
+	}
+	if(script_commands[line->command].data)
+	{
+		token = strtok(NULL, " \t\r\n");
+		if((token == NULL) || !scriptHex(token, line))
+		{
+			return false;
+		}
+	}
+	token = strtok(NULL, " \t\r\n");
+	return (token == NULL) || (token[0] == '#');
+}
+
+bool simScriptLoad(const char *path)
+{
+	char text[SCRIPT_TEXT_MAX];
+	unsigned int number = 0;
+	bool empty, ok = true;
+	FILE *file = fopen(path, "r");
+
+	if(file == NULL)
+	{
+		fprintf(stderr, "%s: cannot open\n", path);
+		return false;
+	}
+	script_count = 0;
+	script_loop = 0;
+	while(fgets(text, sizeof(text), file) != NULL)
+	{
+		number++;
+		if(script_count == SCRIPT_LINES_MAX)
+		{
+			fprintf(stderr, "%s:%u: more than %d lines\n", path, number, SCRIPT_LINES_MAX);
+			ok = false;
+			break;
+		}
+		if(!scriptParse(text, &script_lines[script_count], &empty))
+		{
+			fprintf(stderr, "%s:%u: not understood\n", path, number);
+			ok = false;
+			continue;
+		}
+		if(!empty)
+		{
+			if(script_lines[script_count].command == SCRIPT_COMMAND_LOOP)
+			{
+				script_loop = script_count + 1;
+			}
+			script_count++;
+		}
+	}
+	fclose(file);
+	script_index = 0;
+	script_due = simNow() + (script_count ? SIM_MS_TO_TICKS(script_lines[0].delay_ms) : 0);
+	return ok;
+}
+
+void simScriptRepeat(uint32_t loops)
+{
+	script_loops_left = loops ? loops - 1 : 0;
+}
+
+uint64_t simScriptNext(void)
+{
+	return (script_index < script_count) ? script_due : SIM_NEVER;
+}
+
+void simScriptStep(void)
+{
+	const script_line_t *line;
+
+	if(script_index >= script_count)
+	{
+		return;
+	}
+	line = &script_lines[script_index++];
+	script_commands[line->command].run(line);
+	sim_stats.script_lines++;
+	if((script_index == script_count) && script_loops_left && (script_loop < script_count))
+	{
+		script_loops_left--;
+		script_index = script_loop;
+	}
+	if(script_index < script_count)
+	{
+		script_due += SIM_MS_TO_TICKS(script_lines[script_index].delay_ms);
+	}
+}
@@ -0,0 +1,315 @@
+/*
+ * @filename	: sim.h
+ * @description	: This file contains the interface of the host simulation
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Host build of the friend node.  The application sources are compiled for
+ * Linux against the replacement headers in host/include and the models here:
+ *
+ * 		bgapi_sim.c		BGAPI commands, event queue, soft timers, PS keys
+ * 		hal_sim.c		GPIO, GPIOINT, CMU, SLEEP, LETIMER0, sleeptimer, NVM3 counters
+ * 		display_sim.c	LCD rows kept as strings
+ * 		log_sim.c		Log lines to stdout
+ * 		script.c		Events read from a script file
+ * 		replay.c		Events read from a trace saved by src/trace.c
+ * 		swarm.c			Virtual LPNs started by the swarm script command
+ *
+ * Time is virtual, in 32768 Hz ticks.  It only moves in gecko_wait_event(),
+ * straight to the next script line, soft timer or LETIMER0 interrupt, so a
+ * run takes as long as the handlers take and not as long as the script says.
+ * A replay moves the time to the next trace record or LETIMER0 interrupt.
+ */
+
+#ifndef HOST_SIM_H_
+#define HOST_SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_gpio.h"
+
+/*******************************************************************************
+ ********************************  DEFINES  ************************************
+ ******************************************************************************/
+
+#define SIM_TICK_HZ				32768UL
+#define SIM_NEVER				UINT64_MAX
+#define SIM_MS_TO_TICKS(ms)		(((uint64_t)(ms) * SIM_TICK_HZ) / 1000)
+#define SIM_NOTIFY_UNLIMITED	0
+
+typedef struct
+{
+	uint64_t events;				//Events returned to the application
+	uint64_t commands;				//BGAPI commands called
+	uint64_t notifications;			//Notifications accepted
+	uint64_t notifications_refused;	//Notifications refused with bg_err_out_of_memory
+	uint64_t timer_events;			//Soft timer events
+	uint64_t signal_events;			//External signal events
+	uint64_t letimer_irqs;			//LETIMER0_IRQHandler() calls
+	uint64_t script_lines;			//Script lines run
+	uint64_t trace_records;			//Trace records replayed
+	uint64_t swarm_messages;		//Onoff and level requests of the swarm
+}sim_stats_t;
+
+/* Swarm of the swarm script command, a period of 0 turns the action off */
+typedef struct
+{
+	uint16_t lpns;					//Virtual LPNs, patients and caretakers in turn
+	uint32_t level_ms;				//Level requests of each LPN
+	uint32_t onoff_ms;				//Onoff requests of each LPN
+	uint32_t friendship_ms;			//Friendship of each LPN lost and established again
+	uint32_t pir_ms;				//PIR pulses
+	uint32_t button_ms;				//PB0 presses
+}swarm_config_t;
+
+extern sim_stats_t sim_stats;
+
+/*******************************************************************************
+ **************************    FUNCTION PROTOTYPES    **************************
+ ******************************************************************************/
+
+/* hal_sim.c */
+
+/**************************************************************************//**
+ * @brief   Virtual time, in SIM_TICK_HZ ticks since the start
+ *
+ * @return  Ticks
+ *****************************************************************************/
+uint64_t simNow(void);
+
+/**************************************************************************//**
+ * @brief   Move the virtual time forward
+ *
+ * @detail  Only gecko_wait_event() moves the time, to a tick no later than
+ * 			simLetimerNextIrq()
+ *
+ * @return  Void
+ *****************************************************************************/
+void simClockSet(uint64_t tick);
+
+/**************************************************************************//**
+ * @brief   Sleep until a tick, moving the virtual time there
+ *
+ * @detail  Sleeps in the lowest mode not blocked, with the SLEEP driver
+ * 			callbacks around the move as SLEEP_Sleep() has them.  The time
+ * 			still moves when the sleep callback keeps the node in EM0
+ *
+ * @return  Void
+ *****************************************************************************/
+void simSleep(uint64_t tick);
+
+/**************************************************************************//**
+ * @brief   Drive an input pin
+ *
+ * @detail  Calls the GPIOINT callback when the change is an edge enabled with
+ * 			GPIO_ExtIntConfig(), as the GPIO interrupt would
+ *
+ * @return  Void
+ *****************************************************************************/
+void simGpioInput(GPIO_Port_TypeDef port, unsigned int pin, unsigned int level);
+
+/**************************************************************************//**
+ * @brief   Set the level of an input pin without an interrupt
+ *
+ * @detail  For the replay, where the interrupts already happened on the node
+ *
+ * @return  Void
+ *****************************************************************************/
+void simGpioLevel(GPIO_Port_TypeDef port, unsigned int pin, unsigned int level);
+
+/**************************************************************************//**
+ * @brief   Tick of the next enabled LETIMER0 interrupt
+ *
+ * @return  Tick, SIM_NEVER if no interrupt is enabled
+ *****************************************************************************/
+uint64_t simLetimerNextIrq(void);
+
+/**************************************************************************//**
+ * @brief   Call LETIMER0_IRQHandler() if an enabled interrupt is pending
+ *
+ * @return  Void
+ *****************************************************************************/
+void simLetimerIrq(void);
+
+/* bgapi_sim.c */
+
+/**************************************************************************//**
+ * @brief   Queue a stack event
+ *
+ * @detail  data is the event structure, len its length including the
+ * 			variable length array at its end
+ *
+ * @return  Void
+ *****************************************************************************/
+void simEventPush(uint32_t id, const void *data, uint16_t len);
+
+/**************************************************************************//**
+ * @brief   Set how many notifications the stack accepts between two moves of
+ * 			the virtual time, SIM_NOTIFY_UNLIMITED for no limit
+ *
+ * @return  Void
+ *****************************************************************************/
+void simNotifyBudget(uint16_t notifications);
+
+/**************************************************************************//**
+ * @brief   ATT MTU of a connection, for the length of its read responses
+ *
+ * @detail  From the mtu script command, connections without one have 23
+ *
+ * @return  Void
+ *****************************************************************************/
+void simMtuSet(uint8_t connection, uint16_t mtu);
+
+/**************************************************************************//**
+ * @brief   The application called gecko_cmd_system_reset()
+ *
+ * @return  true once a reset was requested
+ *****************************************************************************/
+bool simResetRequested(void);
+
+/* display_sim.c */
+
+/**************************************************************************//**
+ * @brief   Text last committed to a display row
+ *
+ * @return  Row text, empty if never written
+ *****************************************************************************/
+const char *simDisplayRow(unsigned int row);
+
+/* log_sim.c */
+
+/**************************************************************************//**
+ * @brief   Stop writing log lines to stdout, for throughput runs
+ *
+ * @return  Void
+ *****************************************************************************/
+void simLogQuiet(bool quiet);
+
+/* script.c */
+
+/**************************************************************************//**
+ * @brief   Read a script file
+ *
+ * @detail  Each line is a delay in ms from the line before, a command and
+ * 			its arguments.  See host/scripts/ward.txt for the commands
+ *
+ * @return  true if every line was understood
+ *****************************************************************************/
+bool simScriptLoad(const char *path);
+
+/**************************************************************************//**
+ * @brief   Run the script loops times, from the loop line on after the first
+ *
+ * @return  Void
+ *****************************************************************************/
+void simScriptRepeat(uint32_t loops);
+
+/**************************************************************************//**
+ * @brief   Tick at which the next script line is due
+ *
+ * @return  Tick, SIM_NEVER at the end of the script
+ *****************************************************************************/
+uint64_t simScriptNext(void);
+
+/**************************************************************************//**
+ * @brief   Run the next script line
+ *
+ * @return  Void
+ *****************************************************************************/
+void simScriptStep(void);
+
+/**************************************************************************//**
+ * @brief   Queue a generic server client request from an LPN
+ *
+ * @return  Void
+ *****************************************************************************/
+void simClientRequest(uint16_t model_id, uint16_t client, uint16_t server, uint8_t type, const uint8_t *parameters,
+					  uint8_t len);
+
+/* replay.c */
+
+/**************************************************************************//**
+ * @brief   Read a trace image and replay it instead of a script
+ *
+ * @return  true if the file is a trace image
+ *****************************************************************************/
+bool simReplayLoad(const char *path);
+
+/**************************************************************************//**
+ * @brief   A trace is being replayed
+ *
+ * @detail  The soft timers and external signals then raise no events
+ *
+ * @return  true after simReplayLoad() succeeded
+ *****************************************************************************/
+bool simReplayActive(void);
+
+/**************************************************************************//**
+ * @brief   Tick at which the next trace record is due
+ *
+ * @return  Tick, SIM_NEVER at the end of the trace
+ *****************************************************************************/
+uint64_t simReplayNext(void);
+
+/**************************************************************************//**
+ * @brief   Set the inputs of the next trace record and queue its event
+ *
+ * @return  Void
+ *****************************************************************************/
+void simReplayStep(void);
+
+/**************************************************************************//**
+ * @brief   Write the trace recorded by src/trace.c to a file
+ *
+ * @return  true if the file was written
+ *****************************************************************************/
+bool simTraceSave(const char *path);
+
+/* swarm.c */
+
+/**************************************************************************//**
+ * @brief   Run the swarm with this many LPNs, whatever the script says
+ *
+ * @return  Void
+ *****************************************************************************/
+void simSwarmSize(uint16_t lpns);
+
+/**************************************************************************//**
+ * @brief   Start the swarm, its LPNs befriend the node one after the other
+ *
+ * @detail  server is the unicast address of the node
+ *
+ * @return  Void
+ *****************************************************************************/
+void simSwarmStart(const swarm_config_t *config, uint16_t server);
+
+/**************************************************************************//**
+ * @brief   The swarm was started
+ *
+ * @return  true after simSwarmStart()
+ *****************************************************************************/
+bool simSwarmActive(void);
+
+/**************************************************************************//**
+ * @brief   LPNs of the swarm
+ *
+ * @return  Count, the simSwarmSize() one before the swarm starts
+ *****************************************************************************/
+uint16_t simSwarmLpns(void);
+
+/**************************************************************************//**
+ * @brief   Tick at which the next swarm action is due
+ *
+ * @return  Tick, SIM_NEVER if the swarm is not running
+ *****************************************************************************/
+uint64_t simSwarmNext(void);
+
+/**************************************************************************//**
+ * @brief   Run the swarm actions due now
+ *
+ * @return  Void
+ *****************************************************************************/
+void simSwarmStep(void);
+
+#endif /* HOST_SIM_H_ */
@@ -0,0 +1,577 @@
+/*
+ * @filename	: sim_main.c
+ * @description	: This file contains the main function of the host simulation
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Runs the initialization and event loop of main.c against the models of the
+ * host build, feeding the events of a script or of a trace saved by
+ * src/trace.c, then prints the display and the event rate.
+ *
+ * 		friend_sim [-q] [-l] [-p] [-n loops] [-b notifications] [-t trace] script
+ * 		friend_sim [-q] [-l] [-p] [-b notifications] [-t trace] -r trace
+ * 		friend_sim [-q] [-b notifications] [-k slowdown] -w lpns[,lpns...] script
+ *
+ * 		-q	no log lines
+ * 		-l	time each event handler and print the times per event
+ * 		-p	write the cycle profile of src/profile.c and the energy report
+ * 			of src/energy.c to the log at the end, also with -q
+ * 		-n	run the script loops times, from its loop line on after the first
+ * 		-b	notifications the stack accepts between two moves of the time
+ * 		-t	save the trace recorded during the run
+ * 		-r	replay a trace instead of a script
+ * 		-w	run the swarm of the script with each of these LPN counts, one
+ * 			process per count, and print a line of results for each
+ * 		-k	times the node takes longer than this host to handle an event
+ *
+ * Replaying a trace saved with -t records the same trace again, which checks
+ * that a run is deterministic.
+ *
+ * The swarm results model the node as one queue: each event arrives at its
+ * virtual time and takes the time measured on this host, times the slowdown,
+ * to handle.  The load is the handling time over the virtual time, events back
+ * up on the node as it nears 100 %.  The memory columns are what serving every
+ * LPN of the swarm takes: LPN registry slots, and stack heap for the
+ * friendships from mesh_sizes.h.  regd is how many the registry of this build,
+ * MESH_CFG_MAX_FRIENDSHIPS slots, holds at the end.  overruns are the posts of
+ * each external signal, in eSignal order, merged into one still pending.
+ */
+
+#include "sim.h"
+#include "main.h"
+#include "journal_flash.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <getopt.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <mesh_sizes.h>
+
+#define SIM_LATENCY_KEYS	128
+#define SIM_SWARM_SIZES		32
+#define SIM_SLOWDOWN		50		//Rough EFR32BG13 at 38.4 MHz against a desktop core, measure it for real numbers
+
+/* Stack heap of one friendship, the terms of BTMESH_HEAP_SIZE that scale with MESH_CFG_MAX_FRIENDSHIPS */
+#define SIM_FRIENDSHIP_HEAP	(MESH_MEMSIZE_FRIENDSHIP + MESH_MEMSIZE_FRIEND_TIMERS + \
+							 (MESH_CFG_FRIEND_MAX_SUBS_LIST * MESH_MEMSIZE_FRIEND_SUBS_LIST_ENTRY))
+
+/* Handler times of one event, soft timer handle or signal mask */
+typedef struct
+{
+	uint32_t id;
+	uint32_t detail;			//Timer handle or signal mask, 0 for other events
+	uint64_t count;
+	uint64_t total_ns;
+	uint64_t max_ns;
+}sim_latency_t;
+
+typedef struct
+{
+	uint32_t id;
+	const char *name;
+}sim_event_name_t;
+
+/* Events app.c handles */
+static const sim_event_name_t sim_event_names[] =
+{
+	{ gecko_evt_system_boot_id, "system_boot" },
+	{ gecko_evt_system_external_signal_id, "system_external_signal" },
+	{ gecko_evt_hardware_soft_timer_id, "hardware_soft_timer" },
+	{ gecko_evt_mesh_node_initialized_id, "mesh_node_initialized" },
+	{ gecko_evt_mesh_node_provisioning_started_id, "mesh_node_provisioning_started" },
+	{ gecko_evt_mesh_node_provisioned_id, "mesh_node_provisioned" },
+	{ gecko_evt_mesh_node_provisioning_failed_id, "mesh_node_provisioning_failed" },
+	{ gecko_evt_mesh_node_key_added_id, "mesh_node_key_added" },
+	{ gecko_evt_mesh_node_model_config_changed_id, "mesh_node_model_config_changed" },
+	{ gecko_evt_mesh_node_reset_id, "mesh_node_reset" },
+	{ gecko_evt_mesh_generic_server_client_request_id, "mesh_generic_server_client_request" },
+	{ gecko_evt_mesh_generic_server_state_changed_id, "mesh_generic_server_state_changed" },
+	{ gecko_evt_mesh_generic_server_state_recall_id, "mesh_generic_server_state_recall" },
+	{ gecko_evt_mesh_sensor_client_status_id, "mesh_sensor_client_status" },
+	{ gecko_evt_mesh_friend_friendship_established_id, "mesh_friend_friendship_established" },
+	{ gecko_evt_mesh_friend_friendship_terminated_id, "mesh_friend_friendship_terminated" },
+	{ gecko_evt_le_gap_adv_timeout_id, "le_gap_adv_timeout" },
+	{ gecko_evt_le_connection_opened_id, "le_connection_opened" },
+	{ gecko_evt_le_connection_parameters_id, "le_connection_parameters" },
+	{ gecko_evt_le_connection_closed_id, "le_connection_closed" },
+	{ gecko_evt_gatt_mtu_exchanged_id, "gatt_mtu_exchanged" },
+	{ gecko_evt_gatt_server_characteristic_status_id, "gatt_server_characteristic_status" },
+	{ gecko_evt_gatt_server_user_read_request_id, "gatt_server_user_read_request" },
+	{ gecko_evt_gatt_server_user_write_request_id, "gatt_server_user_write_request" },
+};
+
+/* One handled event, for the percentiles and the queue model */
+typedef struct
+{
+	uint64_t arrival;			//Virtual tick
+	uint32_t ns;				//Handler time on this host
+}sim_sample_t;
+
+typedef struct
+{
+	const char *script;
+	const char *replay;
+	const char *save;
+	uint32_t loops;
+	uint16_t budget;
+	bool latency;				//Table per event
+	bool profile;				//Dump the cycle profile and the energy report
+	bool samples;				//Keep every handler time
+	bool swarm_line;			//Print a line of swarm results instead of the display
+	double slowdown;
+}sim_options_t;
+
+static sim_latency_t sim_latency[SIM_LATENCY_KEYS];
+static unsigned int sim_latency_used = 0;
+static sim_sample_t *sim_samples = NULL;
+static size_t sim_samples_used = 0;
+static size_t sim_samples_size = 0;
+
+bool mesh_bgapi_listener(struct gecko_cmd_packet *evt);
+
+static double simWallSeconds(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + ((double)now.tv_nsec / 1e9);
+}
+
+static uint64_t simWallNs(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+static const char *simEventName(uint32_t id)
+{
+	unsigned int i;
+
+	for(i = 0; i < (sizeof(sim_event_names) / sizeof(sim_event_names[0])); i++)
+	{
+		if(sim_event_names[i].id == id)
+		{
+			return sim_event_names[i].name;
+		}
+	}
+	return NULL;
+}
+
+/* Add the time of one event to its entry */
+static void simLatencyAdd(const struct gecko_cmd_packet *evt, uint64_t ns)
+{
+	uint32_t id = BGLIB_MSG_ID(evt->header);
+	uint32_t detail = 0;
+	sim_latency_t *entry = NULL;
+	unsigned int i;
+
+	if(id == gecko_evt_hardware_soft_timer_id)
+	{
+		detail = evt->data.evt_hardware_soft_timer.handle;
+	}
+	else if(id == gecko_evt_system_external_signal_id)
+	{
+		detail = evt->data.evt_system_external_signal.extsignals;
+	}
+	for(i = 0; i < sim_latency_used; i++)
+	{
+		if((sim_latency[i].id == id) && (sim_latency[i].detail == detail))
+		{
+			entry = &sim_latency[i];
+			break;
+		}
+	}
+	if(entry == NULL)
+	{
+		if(sim_latency_used == SIM_LATENCY_KEYS)
+		{
+			return;
+		}
+		entry = &sim_latency[sim_latency_used++];
+		memset(entry, 0, sizeof(*entry));
+		entry->id = id;
+		entry->detail = detail;
+	}
+	entry->count++;
+	entry->total_ns += ns;
+	if(ns > entry->max_ns)
+	{
+		entry->max_ns = ns;
+	}
+}
+
+/* Largest total time first */
+static int simLatencyCompare(const void *a, const void *b)
+{
+	const sim_latency_t *first = a, *second = b;
+
+	return (first->total_ns < second->total_ns) ? 1 : ((first->total_ns > second->total_ns) ? -1 : 0);
+}
+
+static void simLatencyPrint(void)
+{
+	const char *name;
+	char label[64];
+	unsigned int i;
+
+	qsort(sim_latency, sim_latency_used, sizeof(sim_latency[0]), simLatencyCompare);
+	printf("\n%-44s %10s %10s %10s %12s\n", "event", "count", "mean ns", "max ns", "total us");
+	for(i = 0; i < sim_latency_used; i++)
+	{
+		name = simEventName(sim_latency[i].id);
+		if(name == NULL)
+		{
+			snprintf(label, sizeof(label), "0x%08lx", (unsigned long)sim_latency[i].id);
+		}
+		else if(sim_latency[i].id == gecko_evt_hardware_soft_timer_id)
+		{
+			snprintf(label, sizeof(label), "%s %lu", name, (unsigned long)sim_latency[i].detail);
+		}
+		else if(sim_latency[i].id == gecko_evt_system_external_signal_id)
+		{
+			snprintf(label, sizeof(label), "%s 0x%lx", name, (unsigned long)sim_latency[i].detail);
+		}
+		else
+		{
+			snprintf(label, sizeof(label), "%s", name);
+		}
+		printf("%-44s %10llu %10llu %10llu %12llu\n", label, (unsigned long long)sim_latency[i].count,
+			   (unsigned long long)(sim_latency[i].total_ns / sim_latency[i].count),
+			   (unsigned long long)sim_latency[i].max_ns, (unsigned long long)(sim_latency[i].total_ns / 1000));
+	}
+}
+
+static void simSampleAdd(uint64_t arrival, uint64_t ns)
+{
+	sim_sample_t *grown;
+
+	if(sim_samples_used == sim_samples_size)
+	{
+		sim_samples_size = sim_samples_size ? (sim_samples_size * 2) : 65536;
+		grown = realloc(sim_samples, sim_samples_size * sizeof(sim_samples[0]));
+		if(grown == NULL)
+		{
+			fprintf(stderr, "no memory for %lu handler times\n", (unsigned long)sim_samples_size);
+			exit(1);
+		}
+		sim_samples = grown;
+	}
+	sim_samples[sim_samples_used].arrival = arrival;
+	sim_samples[sim_samples_used].ns = (ns > UINT32_MAX) ? UINT32_MAX : (uint32_t)ns;
+	sim_samples_used++;
+}
+
+static int simDoubleCompare(const void *a, const void *b)
+{
+	double first = *(const double *)a, second = *(const double *)b;
+
+	return (first > second) - (first < second);
+}
+
+/* Value below which a fraction of the sorted values are */
+static double simPercentile(const double *sorted, size_t count, double fraction)
+{
+	size_t index = (size_t)(fraction * (double)count);
+
+	return count ? sorted[(index < count) ? index : (count - 1)] : 0.0;
+}
+
+/* Overrun count of every signal, in eSignal order, separated by '/' */
+static const char *simSignalOverruns(void)
+{
+	static char text[SIGNAL_COUNT * 11];
+	size_t len = 0;
+	eSignal signal;
+
+	text[0] = '\0';
+	for(signal = 0; signal < SIGNAL_COUNT; signal++)
+	{
+		len += snprintf(&text[len], sizeof(text) - len, "%s%lu", (signal == 0) ? "" : "/",
+						(unsigned long)signalOverrunCount(signal));
+	}
+	return text;
+}
+
+static void simSwarmHeader(void)
+{
+	char names[SIGNAL_COUNT * 8];
+	size_t len = 0;
+	eSignal signal;
+
+	for(signal = 0; signal < SIGNAL_COUNT; signal++)
+	{
+		len += snprintf(&names[len], sizeof(names) - len, "%s%s", (signal == 0) ? "" : "/", signalName(signal));
+	}
+	printf("%5s %5s %9s %10s %7s %7s %6s %8s %8s %8s %10s %9s  overruns %s\n",
+		   "lpns", "regd", "events", "events/s", "p50 ns", "p99 ns", "load", "p50 ms", "p99 ms", "max ms",
+		   "registry B", "friend B", names);
+}
+
+/*
+ * One line of swarm results: host handler times, then the node as a single
+ * queue with the handler times scaled by the slowdown
+ */
+static void simSwarmLine(double seconds, double slowdown)
+{
+	double *host = malloc((sim_samples_used + 1) * sizeof(double));
+	double *node = malloc((sim_samples_used + 1) * sizeof(double));
+	double arrival, service, busy = 0.0, finish = 0.0, virtual_seconds;
+	size_t i;
+
+	if((host == NULL) || (node == NULL))
+	{
+		fprintf(stderr, "no memory for the percentiles\n");
+		exit(1);
+	}
+	for(i = 0; i < sim_samples_used; i++)
+	{
+		arrival = (double)sim_samples[i].arrival / SIM_TICK_HZ;
+		service = ((double)sim_samples[i].ns * slowdown) / 1e9;
+		finish = ((finish > arrival) ? finish : arrival) + service;
+		busy += service;
+		host[i] = sim_samples[i].ns;
+		node[i] = (finish - arrival) * 1000.0;
+	}
+	qsort(host, sim_samples_used, sizeof(double), simDoubleCompare);
+	qsort(node, sim_samples_used, sizeof(double), simDoubleCompare);
+	virtual_seconds = (double)simNow() / SIM_TICK_HZ;
+	printf("%5u %5u %9llu %10.0f %7.0f %7.0f %5.1f%% %8.3f %8.3f %8.3f %10lu %9lu  %s\n",
+		   simSwarmLpns(), lpnRegistryCount(), (unsigned long long)sim_stats.events,
+		   (seconds > 0) ? (double)sim_stats.events / seconds : 0.0,
+		   simPercentile(host, sim_samples_used, 0.50), simPercentile(host, sim_samples_used, 0.99),
+		   (virtual_seconds > 0) ? (100.0 * busy / virtual_seconds) : 0.0,
+		   simPercentile(node, sim_samples_used, 0.50), simPercentile(node, sim_samples_used, 0.99),
+		   sim_samples_used ? node[sim_samples_used - 1] : 0.0,
+		   (unsigned long)(simSwarmLpns() * sizeof(lpn_entry_t)),
+		   (unsigned long)(simSwarmLpns() * SIM_FRIENDSHIP_HEAP), simSignalOverruns());
+	free(host);
+	free(node);
+}
+
+static void simUsage(const char *name)
+{
+	fprintf(stderr, "usage: %s [-q] [-l] [-p] [-n loops] [-b notifications] [-t trace] script\n"
+					"       %s [-q] [-l] [-p] [-b notifications] [-t trace] -r trace\n"
+					"       %s [-q] [-b notifications] [-k slowdown] -w lpns[,lpns...] script\n", name, name, name);
+}
+
+/* One run of the script or trace, in this process */
+static int simRun(const sim_options_t *options)
+{
+	struct gecko_cmd_packet *evt;
+	uint64_t handler_start = 0, arrival;
+	uint32_t cycles;
+	double start, seconds;
+	unsigned int row;
+
+	if((options->replay != NULL) ? !simReplayLoad(options->replay) : !simScriptLoad(options->script))
+	{
+		return 1;
+	}
+	simScriptRepeat(options->loops);
+	simNotifyBudget(options->budget);
+
+	/* Same order as main.c, without the board, LDMA and coexistence setup */
+	timebaseInit();
+	logInit();
+	gpioInit();
+	cmuInit();
+	profileInit();
+	letimer_Init();
+	I2C_Initialize();
+	displayInit();
+	journalFlashSimReset();
+	journalInit();
+	traceInit();
+	init_signal_handlers();
+	gecko_stack_init(NULL);
+	energyInit();
+	gecko_bgapi_classes_init();
+
+	start = simWallSeconds();
+	while(1)
+	{
+		evt = gecko_peek_event();
+		if(evt == NULL)
+		{
+			countersIdle();
+			journalIdle();
+			evt = gecko_wait_event();
+			if(evt == NULL)
+			{
+				break;	//Script or trace done, or the application reset the node
+			}
+		}
+		traceRecord(evt);
+		arrival = simNow();
+		cycles = profileStart();
+		if(options->latency || options->samples)
+		{
+			handler_start = simWallNs();
+		}
+		if(mesh_bgapi_listener(evt))
+		{
+			handle_ecen5823_gecko_event(BGLIB_MSG_ID(evt->header), evt);
+		}
+		displayCommit();
+		profileEvent(BGLIB_MSG_ID(evt->header), cycles);
+		if(options->latency)
+		{
+			simLatencyAdd(evt, simWallNs() - handler_start);
+		}
+		if(options->samples)
+		{
+			simSampleAdd(arrival, simWallNs() - handler_start);
+		}
+	}
+	seconds = simWallSeconds() - start;
+
+	if(options->swarm_line)
+	{
+		simSwarmLine(seconds, options->slowdown);
+		return 0;
+	}
+	printf("\n");
+	for(row = 0; row < DISPLAY_ROW_MAX; row++)
+	{
+		printf("display %u: %s\n", row, simDisplayRow(row));
+	}
+	printf("virtual time  %.3f s%s\n", (double)simNow() / SIM_TICK_HZ, simResetRequested() ? ", ended by reset" : "");
+	if(options->replay != NULL)
+	{
+		printf("trace records %llu\n", (unsigned long long)sim_stats.trace_records);
+	}
+	else
+	{
+		printf("script lines  %llu\n", (unsigned long long)sim_stats.script_lines);
+	}
+	if(simSwarmActive())
+	{
+		printf("swarm         %u LPNs, %llu requests\n", simSwarmLpns(), (unsigned long long)sim_stats.swarm_messages);
+	}
+	printf("events        %llu (%llu timer, %llu signal)\n", (unsigned long long)sim_stats.events,
+		   (unsigned long long)sim_stats.timer_events, (unsigned long long)sim_stats.signal_events);
+	printf("commands      %llu\n", (unsigned long long)sim_stats.commands);
+	printf("notifications %llu (%llu refused)\n", (unsigned long long)sim_stats.notifications,
+		   (unsigned long long)sim_stats.notifications_refused);
+	printf("letimer irqs  %llu\n", (unsigned long long)sim_stats.letimer_irqs);
+	printf("overruns      %s\n", simSignalOverruns());
+	printf("journal       %lu records\n", (unsigned long)journalCount());
+	printf("wall time     %.3f s, %.0f events/s\n", seconds, (seconds > 0) ? (double)sim_stats.events / seconds : 0.0);
+	if(options->latency)
+	{
+		simLatencyPrint();
+	}
+	if(options->profile)
+	{
+		simLogQuiet(false);
+		profileDump();
+		energyReport();
+	}
+	if((options->save != NULL) && !simTraceSave(options->save))
+	{
+		return 1;
+	}
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	sim_options_t options = { .loops = 1, .budget = SIM_NOTIFY_UNLIMITED, .slowdown = SIM_SLOWDOWN };
+	unsigned long sizes[SIM_SWARM_SIZES];
+	unsigned int size_count = 0, i;
+	char *list = NULL, *token;
+	int option, status;
+	pid_t child;
+
+	while((option = getopt(argc, argv, "qlpn:b:t:r:w:k:")) != -1)
+	{
+		switch(option)
+		{
+		case 'q':
+			simLogQuiet(true);
+			break;
+		case 'l':
+			options.latency = true;
+			break;
+		case 'p':
+			options.profile = true;
+			break;
+		case 't':
+			options.save = optarg;
+			break;
+		case 'r':
+			options.replay = optarg;
+			break;
+		case 'n':
+			options.loops = (uint32_t)strtoul(optarg, NULL, 0);
+			break;
+		case 'b':
+			options.budget = (uint16_t)strtoul(optarg, NULL, 0);
+			break;
+		case 'w':
+			list = optarg;
+			break;
+		case 'k':
+			options.slowdown = strtod(optarg, NULL);
+			break;
+		default:
+			simUsage(argv[0]);
+			return 2;
+		}
+	}
+	if(optind != (argc - ((options.replay == NULL) ? 1 : 0)))
+	{
+		simUsage(argv[0]);
+		return 2;
+	}
+	options.script = argv[optind];
+	if(list == NULL)
+	{
+		return simRun(&options);
+	}
+
+	for(token = strtok(list, ","); (token != NULL) && (size_count < SIM_SWARM_SIZES); token = strtok(NULL, ","))
+	{
+		sizes[size_count++] = strtoul(token, NULL, 0);
+	}
+	if((size_count == 0) || (options.replay != NULL))
+	{
+		simUsage(argv[0]);
+		return 2;
+	}
+
+	/* A process per size, the application state starts afresh for each */
+	options.samples = true;
+	options.swarm_line = true;
+	options.save = NULL;
+	simSwarmHeader();
+	for(i = 0; i < size_count; i++)
+	{
+		fflush(stdout);
+		child = fork();
+		if(child < 0)
+		{
+			perror("fork");
+			return 1;
+		}
+		if(child == 0)
+		{
+			simSwarmSize((uint16_t)sizes[i]);
+			status = simRun(&options);
+			fflush(stdout);
+			_exit(status);
+		}
+		if((waitpid(child, &status, 0) < 0) || !WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+		{
+			fprintf(stderr, "run with %lu LPNs failed\n", sizes[i]);
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,281 @@
+/*
+ * @filename	: swarm.c
+ * @description	: This file contains the virtual LPN swarm of the host simulation
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Load generator started by the swarm script command.  Each virtual LPN
+ * befriends the node, then sends level requests and onoff requests at its own
+ * period, and drops and re-establishes its friendship at another.  Patients
+ * and caretakers alternate, addresses counting up from SWARM_FIRST_ADDRESS so
+ * LPN_ROLE_FROM_ADDRESS() gives the same roles on the node.  The PIR and PB0
+ * inputs are pulsed at node wide periods.
+ *
+ * Every period has a random phase and up to 25 % of jitter from a fixed seed,
+ * so the LPNs interleave but two runs of the same script are identical.  The
+ * swarm runs until the script ends.
+ */
+
+#include "sim.h"
+#include "gpio.h"
+#include "lpn_registry.h"
+#include "native_gecko.h"
+#include "mesh_generic_model_capi_types.h"
+#include "log.h"
+#include <string.h>
+
+#define SWARM_FIRST_ADDRESS		0x0010		//Patient, the next LPN is its caretaker
+#define SWARM_LPNS_MAX			256
+#define SWARM_STAGGER_MS		20			//Between two friendships at the start
+#define SWARM_REJOIN_MS			1000		//Friendship lost to established again
+#define SWARM_PULSE_MS			100			//PIR high or PB0 pressed
+#define SWARM_SEED				0x2545F491UL
+
+typedef enum
+{
+	SWARM_LEVEL = 0,
+	SWARM_ONOFF,
+	SWARM_FRIENDSHIP,
+	SWARM_LPN_ACTIONS
+}eSwarmAction;
+
+typedef struct
+{
+	uint16_t address;
+	bool befriended;
+	bool on;								//Last onoff sent
+	uint64_t due[SWARM_LPN_ACTIONS];
+}swarm_lpn_t;
+
+typedef struct
+{
+	bool high;								//PIR high or PB0 pressed
+	uint64_t due;
+}swarm_pulse_t;
+
+static swarm_config_t swarm_config;
+static swarm_lpn_t swarm_lpns[SWARM_LPNS_MAX];
+static swarm_pulse_t swarm_pir;
+static swarm_pulse_t swarm_button;
+static uint16_t swarm_size_override = 0;
+static uint16_t swarm_server = 0;
+static bool swarm_active = false;
+static uint32_t swarm_random = SWARM_SEED;
+
+static uint32_t swarmRandom(void)
+{
+	swarm_random ^= swarm_random << 13;
+	swarm_random ^= swarm_random >> 17;
+	swarm_random ^= swarm_random << 5;
+	return swarm_random;
+}
+
+/* Next time of a periodic action, SIM_NEVER for a period of 0 */
+static uint64_t swarmAfter(uint64_t from, uint32_t period_ms)
+{
+	uint32_t jitter;
+
+	if(period_ms == 0)
+	{
+		return SIM_NEVER;
+	}
+	jitter = period_ms / 4;
+	return from + SIM_MS_TO_TICKS(period_ms - jitter + (jitter ? (swarmRandom() % (2 * jitter)) : 0));
+}
+
+/* First time of a periodic action, anywhere in its first period */
+static uint64_t swarmPhase(uint64_t from, uint32_t period_ms)
+{
+	return (period_ms == 0) ? SIM_NEVER : (from + SIM_MS_TO_TICKS(swarmRandom() % period_ms));
+}
+
+static void swarmLevel(swarm_lpn_t *lpn)
+{
+	int16_t value;
+	uint8_t level[2];
+
+	if(LPN_ROLE_FROM_ADDRESS(lpn->address) == LPN_ROLE_CARETAKER)
+	{
+		value = (int16_t)(swarmRandom() % 30000);				//Ultrasonic distance
+	}
+	else if(lpn->on)
+	{
+		value = (int16_t)(2000 + (swarmRandom() % 1200));		//Accelerometer, some above ACC_FALL_THRESHOLD
+	}
+	else
+	{
+		value = (int16_t)(3300 + (swarmRandom() % 200));		//Temperature, some above TEMP_ALERT_THRESHOLD
+	}
+	level[0] = (uint8_t)value;
+	level[1] = (uint8_t)((uint16_t)value >> 8);
+	simClientRequest(MESH_GENERIC_LEVEL_SERVER_MODEL_ID, lpn->address, swarm_server, mesh_generic_request_level,
+					 level, sizeof(level));
+	sim_stats.swarm_messages++;
+}
+
+static void swarmOnoff(swarm_lpn_t *lpn)
+{
+	uint8_t on_off;
+
+	/* Patients switch sensor, caretakers toggle their presence with every 1 */
+	lpn->on = !lpn->on;
+	on_off = (LPN_ROLE_FROM_ADDRESS(lpn->address) == LPN_ROLE_CARETAKER) ? 1 : (lpn->on ? 1 : 0);
+	simClientRequest(MESH_GENERIC_ON_OFF_SERVER_MODEL_ID, lpn->address, swarm_server, mesh_generic_request_on_off,
+					 &on_off, sizeof(on_off));
+	sim_stats.swarm_messages++;
+}
+
+static void swarmFriendship(swarm_lpn_t *lpn)
+{
+	struct gecko_msg_mesh_friend_friendship_established_evt_t established;
+	struct gecko_msg_mesh_friend_friendship_terminated_evt_t terminated;
+
+	if(lpn->befriended)
+	{
+		terminated.reason = bg_err_timeout;		//LPN stopped polling
+		simEventPush(gecko_evt_mesh_friend_friendship_terminated_id, &terminated, sizeof(terminated));
+		lpn->befriended = false;
+		lpn->due[SWARM_FRIENDSHIP] = simNow() + SIM_MS_TO_TICKS(SWARM_REJOIN_MS);
+		return;
+	}
+	established.lpn_address = lpn->address;
+	simEventPush(gecko_evt_mesh_friend_friendship_established_id, &established, sizeof(established));
+	lpn->befriended = true;
+	lpn->due[SWARM_FRIENDSHIP] = swarmAfter(simNow(), swarm_config.friendship_ms);
+	if(lpn->due[SWARM_LEVEL] == SIM_NEVER)
+	{
+		lpn->due[SWARM_LEVEL] = swarmPhase(simNow(), swarm_config.level_ms);
+		lpn->due[SWARM_ONOFF] = swarmPhase(simNow(), swarm_config.onoff_ms);
+	}
+}
+
+static void swarmPulse(swarm_pulse_t *pulse, GPIO_Port_TypeDef port, unsigned int pin, bool active_low,
+					   uint32_t period_ms)
+{
+	pulse->high = !pulse->high;
+	simGpioInput(port, pin, (pulse->high != active_low) ? 1 : 0);
+	pulse->due = pulse->high ? (simNow() + SIM_MS_TO_TICKS(SWARM_PULSE_MS)) : swarmAfter(simNow(), period_ms);
+}
+
+void simSwarmSize(uint16_t lpns)
+{
+	swarm_size_override = (lpns > SWARM_LPNS_MAX) ? SWARM_LPNS_MAX : lpns;
+}
+
+void simSwarmStart(const swarm_config_t *config, uint16_t server)
+{
+	uint64_t now = simNow();
+	uint16_t i;
+
+	swarm_config = *config;
+	if(swarm_size_override)
+	{
+		swarm_config.lpns = swarm_size_override;
+	}
+	if(swarm_config.lpns > SWARM_LPNS_MAX)
+	{
+		swarm_config.lpns = SWARM_LPNS_MAX;
+	}
+	swarm_server = server;
+	swarm_random = SWARM_SEED;
+	for(i = 0; i < swarm_config.lpns; i++)
+	{
+		memset(&swarm_lpns[i], 0, sizeof(swarm_lpns[i]));
+		swarm_lpns[i].address = SWARM_FIRST_ADDRESS + i;
+		swarm_lpns[i].due[SWARM_LEVEL] = SIM_NEVER;
+		swarm_lpns[i].due[SWARM_ONOFF] = SIM_NEVER;
+		swarm_lpns[i].due[SWARM_FRIENDSHIP] = now + SIM_MS_TO_TICKS(i * SWARM_STAGGER_MS);
+	}
+	swarm_pir.high = false;
+	swarm_pir.due = swarmPhase(now, swarm_config.pir_ms);
+	swarm_button.high = false;
+	swarm_button.due = swarmPhase(now, swarm_config.button_ms);
+	swarm_active = true;
+}
+
+bool simSwarmActive(void)
+{
+	return swarm_active;
+}
+
+uint16_t simSwarmLpns(void)
+{
+	return swarm_active ? swarm_config.lpns : swarm_size_override;
+}
+
+uint64_t simSwarmNext(void)
+{
+	uint64_t next = SIM_NEVER;
+	uint16_t i;
+	uint8_t action;
+
+	if(!swarm_active)
+	{
+		return SIM_NEVER;
+	}
+	for(i = 0; i < swarm_config.lpns; i++)
+	{
+		for(action = 0; action < SWARM_LPN_ACTIONS; action++)
+		{
+			if(swarm_lpns[i].due[action] < next)
+			{
+				next = swarm_lpns[i].due[action];
+			}
+		}
+	}
+	if(swarm_pir.due < next)
+	{
+		next = swarm_pir.due;
+	}
+	if(swarm_button.due < next)
+	{
+		next = swarm_button.due;
+	}
+	return next;
+}
+
+void simSwarmStep(void)
+{
+	uint64_t now = simNow();
+	swarm_lpn_t *lpn;
+	uint16_t i;
+
+	if(!swarm_active)
+	{
+		return;
+	}
+	for(i = 0; i < swarm_config.lpns; i++)
+	{
+		lpn = &swarm_lpns[i];
+		if(lpn->due[SWARM_FRIENDSHIP] <= now)
+		{
+			swarmFriendship(lpn);
+		}
+		/* Messages due while the friendship is down are lost */
+		if(lpn->due[SWARM_ONOFF] <= now)
+		{
+			if(lpn->befriended)
+			{
+				swarmOnoff(lpn);
+			}
+			lpn->due[SWARM_ONOFF] = swarmAfter(now, swarm_config.onoff_ms);
+		}
+		if(lpn->due[SWARM_LEVEL] <= now)
+		{
+			if(lpn->befriended)
+			{
+				swarmLevel(lpn);
+			}
+			lpn->due[SWARM_LEVEL] = swarmAfter(now, swarm_config.level_ms);
+		}
+	}
+	if(swarm_pir.due <= now)
+	{
+		swarmPulse(&swarm_pir, MOTION_PORT, MOTION_PIN, false, swarm_config.pir_ms);
+	}
+	if(swarm_button.due <= now)
+	{
+		swarmPulse(&swarm_button, PB0_Port, PB0_Pin, true, swarm_config.button_ms);
+	}
+}
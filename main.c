@@ -47,7 +47,6 @@
 #include "bspconfig.h"
 #endif
 
-eState eNextState;
 /***********************************************************************************************//**
  * @addtogroup Application
  * @{
@@ -59,10 +58,6 @@ eState eNextState;
  **************************************************************************************************/
 
 bool mesh_bgapi_listener(struct gecko_cmd_packet *evt);
-eState eNextState;
-
-/// Maximum number of simultaneous Bluetooth connections
-#define MAX_CONNECTIONS 2
 
 /// Heap for Bluetooth stack
 uint8_t bluetooth_stack_heap[DEFAULT_BLUETOOTH_HEAP(MAX_CONNECTIONS) + BTMESH_HEAP_SIZE + 1760];
@@ -132,22 +127,28 @@ int main(void)
   // Initialize application
   initApp();
   initVcomEnable();
+  timebaseInit();
+  ldmaInit(); //Before logInit(), the log is drained by the LDMA
   logInit();
   /*	Initialize required gpios	*/
   gpioInit();
 
   /*	Initialize clocks	*/
   cmuInit();
+  profileInit(); //After cmuInit(), the cycles are counted at the core clock
   letimer_Init();
   I2C_Initialize();
-  eNextState = POWER_OFF;
   displayInit();
+  journalInit(); //After displayInit(), the flash hands USART1 back to the display
+  traceInit();
+  init_signal_handlers();
 
   // Minimize advertisement latency by allowing the advertiser to always
   // interrupt the scanner.
   linklayer_priorities.scan_max = linklayer_priorities.adv_min + 1;
 
   gecko_stack_init(&config);
+  energyInit(); //After gecko_stack_init(), the stack registers its sleep callbacks there
 
   // Initialize the bgapi classes
   gecko_bgapi_classes_init();
@@ -155,10 +156,22 @@ int main(void)
   // Initialize coexistence interface. Parameters are taken from HAL config.
   gecko_initCoexHAL();
   while (1) {
-    struct gecko_cmd_packet *evt = gecko_wait_event();
+    struct gecko_cmd_packet *evt = gecko_peek_event();
+    if (evt == NULL) {
+      /* Nothing to handle, flash maintenance cannot delay an event now */
+      countersIdle();
+      journalIdle();
+      evt = gecko_wait_event();
+    }
+    /* Record the event as the stack delivered it, before any handler sees it */
+    traceRecord(evt);
+    uint32_t cycles = profileStart();
     bool pass = mesh_bgapi_listener(evt);
     if (pass) {
       handle_ecen5823_gecko_event(BGLIB_MSG_ID(evt->header), evt);
     }
+    /* Write every display row staged while handling this event in one update */
+    displayCommit();
+    profileEvent(BGLIB_MSG_ID(evt->header), cycles);
   }
 }
@@ -24,7 +24,7 @@
 
 
 #define MESH_CFG_MAX_ELEMENTS                   1
-#define MESH_CFG_MAX_MODELS                     14
+#define MESH_CFG_MAX_MODELS                     15
 #define MESH_CFG_MAX_APP_BINDS                  4
 #define MESH_CFG_MAX_SUBSCRIPTIONS              4
 #define MESH_CFG_MAX_NETKEYS                    4
@@ -42,7 +42,9 @@
 #define MESH_CFG_MAX_PROVISIONED_DEVICE_APPKEYS 0
 #define MESH_CFG_MAX_PROVISIONED_DEVICE_NETKEYS 0
 #define MESH_CFG_MAX_FOUNDATION_CLIENT_CMDS     0
+#ifndef MESH_CFG_MAX_FRIENDSHIPS
 #define MESH_CFG_MAX_FRIENDSHIPS                2
+#endif
 #define MESH_CFG_FRIEND_MAX_SUBS_LIST           5
 #define MESH_CFG_FRIEND_MAX_TOTAL_CACHE         5
 #define MESH_CFG_FRIEND_MAX_SINGLE_CACHE        5
@@ -18,6 +18,16 @@
 #ifndef MESH_LIB_H
 #define MESH_LIB_H
 
+/** Registrations available when mesh_lib_init() is given no malloc function */
+#ifndef MESH_LIB_STATIC_MODELS
+#define MESH_LIB_STATIC_MODELS 11
+#endif
+
+/** Elements covered by the direct model handler dispatch table, 0 leaves every lookup to the linear scan */
+#ifndef MESH_LIB_DISPATCH_ELEMENTS
+#define MESH_LIB_DISPATCH_ELEMENTS 2
+#endif
+
 /** Request flags */
 typedef enum {
   /** Send request as nonrelayed (with TTL zero); response, if any,
@@ -56,7 +66,13 @@ uint32_t mesh_lib_transition_time_to_ms(uint8_t transition_time);
  * This function needs to be called before using other helper library
  * functions.
  *
- * @param malloc_fn Function to use to allocate memory during runtime
+ * Registered handlers are found through a table indexed by model ID and
+ * element index, so dispatching an event does not scan the registrations.
+ * The table covers SIG models 0x1000..0x131F on the first
+ * MESH_LIB_DISPATCH_ELEMENTS elements; other models are looked up linearly.
+ *
+ * @param malloc_fn Function to use to allocate memory during runtime, or
+ * NULL to use a static pool of MESH_LIB_STATIC_MODELS registrations
  * @param free_fn Function to free allocated memory during runtime
  * @param generic_models Number of models on the device for which
  * event handlers will be registered; see
@@ -17,6 +17,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 /* BG stack headers */
 #include "bg_types.h"
@@ -67,8 +68,38 @@ static size_t regs = 0;
 static void *(*lib_malloc_fn)(size_t) = NULL;
 static void (*lib_free_fn)(void *) = NULL;
 
-static struct reg *find_reg(uint16_t model_id,
-                            uint16_t elem_index)
+/* Registrations used when mesh_lib_init() is given no malloc function */
+static struct reg reg_pool[MESH_LIB_STATIC_MODELS];
+
+/*
+ * Dispatch table indexed directly by (model_id, elem_index), holding the
+ * index of the registration in reg[]. SIG models 0x1000..0x131F (generic,
+ * sensor, time and scene, lighting) map to a dense slot, (model_id >> 8)
+ * selecting one of four groups of 32 model ids. Anything outside that
+ * range or element falls back to the linear scan.
+ */
+#define DISPATCH_MODEL_BASE   0x1000
+#define DISPATCH_MODEL_SLOTS  128
+#define DISPATCH_NONE         0xFF
+#define DISPATCH_SLOT(model_id, elem_index) \
+  ((size_t)(elem_index) * DISPATCH_MODEL_SLOTS \
+   + ((((model_id) >> 8) & 0x03) << 5) + ((model_id) & 0x1F))
+
+static uint8_t dispatch[MESH_LIB_DISPATCH_ELEMENTS * DISPATCH_MODEL_SLOTS];
+
+static int dispatch_slot(uint16_t model_id, uint16_t elem_index, size_t *slot)
+{
+  if (model_id < DISPATCH_MODEL_BASE || model_id > 0x13FF
+      || (model_id & 0xE0) != 0
+      || elem_index >= MESH_LIB_DISPATCH_ELEMENTS) {
+    return 0;
+  }
+  *slot = DISPATCH_SLOT(model_id, elem_index);
+  return 1;
+}
+
+static struct reg *find_reg_scan(uint16_t model_id,
+                                 uint16_t elem_index)
 {
   size_t r;
   for (r = 0; r < regs; r++) {
@@ -79,6 +110,28 @@ static struct reg *find_reg(uint16_t model_id,
   return NULL;
 }
 
+static struct reg *find_reg(uint16_t model_id,
+                            uint16_t elem_index)
+{
+  size_t slot;
+  if (dispatch_slot(model_id, elem_index, &slot)) {
+    if (dispatch[slot] == DISPATCH_NONE) {
+      return NULL;
+    }
+    return &reg[dispatch[slot]];
+  }
+  return find_reg_scan(model_id, elem_index);
+}
+
+/* Record a new registration in the dispatch table */
+static void dispatch_add(struct reg *r)
+{
+  size_t slot;
+  if (dispatch_slot(r->model_id, r->elem_index, &slot)) {
+    dispatch[slot] = (uint8_t)(r - reg);
+  }
+}
+
 static struct reg *find_free(void)
 {
   size_t r;
@@ -94,11 +147,20 @@ errorcode_t mesh_lib_init(void *(*malloc_fn)(size_t),
                           void (*free_fn)(void *),
                           size_t generic_models)
 {
+  mesh_lib_deinit();
   lib_malloc_fn = malloc_fn;
   lib_free_fn = free_fn;
+  memset(dispatch, DISPATCH_NONE, sizeof(dispatch));
 
+  if (generic_models >= DISPATCH_NONE) {
+    return bg_err_invalid_param; // dispatch table holds 8 bit indices
+  }
   if (generic_models) {
-    reg = (lib_malloc_fn)(generic_models * sizeof(struct reg));
+    if (lib_malloc_fn) {
+      reg = (lib_malloc_fn)(generic_models * sizeof(struct reg));
+    } else if (generic_models <= MESH_LIB_STATIC_MODELS) {
+      reg = reg_pool;
+    }
     if (!reg) {
       return bg_err_out_of_memory;
     }
@@ -111,11 +173,12 @@ errorcode_t mesh_lib_init(void *(*malloc_fn)(size_t),
 
 void mesh_lib_deinit(void)
 {
-  if (reg) {
+  if (reg && reg != reg_pool) {
     (lib_free_fn)(reg);
-    reg = NULL;
-    regs = 0;
   }
+  reg = NULL;
+  regs = 0;
+  memset(dispatch, DISPATCH_NONE, sizeof(dispatch));
 }
 
 errorcode_t
@@ -142,6 +205,7 @@ mesh_lib_generic_server_register_handler(uint16_t model_id,
   reg->server.client_request_cb = cb;
   reg->server.state_changed_cb = ch;
   reg->server.state_recall_cb = recall;
+  dispatch_add(reg);
   return bg_err_success;
 }
 
@@ -165,6 +229,7 @@ mesh_lib_generic_client_register_handler(uint16_t model_id,
   reg->model_id = model_id;
   reg->elem_index = elem_index;
   reg->client.server_response_cb = cb;
+  dispatch_add(reg);
   return bg_err_success;
 }
 
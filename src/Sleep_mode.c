@@ -21,21 +21,19 @@ void sleep_initialize()
 void sleep_mode_on()
 {
 	mode_Select();
-	  if(EnergyMode == sleepEM1 || EnergyMode == sleepEM2)
+	  if(EnergyMode == sleepEM1 || EnergyMode == sleepEM2 || logTxActive())
 	  {
-		  logFlush();
-		  SLEEP_Sleep(); //Command applicable only for EM1 and EM2
+		  SLEEP_Sleep(); //Command applicable only for EM1 and EM2, the log drain blocks EM2 while it runs
 	  }
 	  else if(EnergyMode == sleepEM3)
 	  {
-		  logFlush();
 		  EMU_EnterEM3(true); //Command applicable for EM3 only
 	  }
 }
 
 void mode_Select(void)
 {
-	if(eNextState == POWER_OFF)
+	if(fsmState(&humidity_fsm) == HUM_STATE_OFF)
 		EnergyMode = sleepEM3; //Keep in EM3 except when in I2C transfer
 	else
 	{
@@ -15,6 +15,7 @@
 #include "log.h"
 #include "cmu.h"
 #include "em_emu.h"
+#include "main.h"
 
 
 
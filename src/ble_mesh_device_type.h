@@ -28,6 +28,12 @@
 #define DEVICE_IS_BLE_MESH_LPN 				0
 #define DEVICE_IS_BLE_MESH_FRIEND 			0
 
+/**
+ * Maximum number of simultaneous Bluetooth connections.  Sizes the stack
+ * heap and configuration in main.c and the telemetry client slots
+ */
+#define MAX_CONNECTIONS						2
+
 
 #if DEVICE_IS_BLE_MESH_LPN
 #define BUILD_INCLUDES_BLE_MESH_LPN 	1
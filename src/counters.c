@@ -0,0 +1,128 @@
+/*
+ * @filename	: counters.c
+ * @description	: This file contains the source code for the NVM3 event counters
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ */
+
+#include "counters.h"
+#include "log.h"
+#include <nvm3.h>
+#include <nvm3_default.h>
+#include <string.h>
+
+#define COUNTER_KEY(counter)	((nvm3_ObjectKey_t)(COUNTER_NVM3_KEY_BASE + (counter)))
+
+static uint32_t counter_values[COUNTER_COUNT];
+static bool counters_ready = false;
+static uint32_t counters_created = 0;		//Bit per counter not in NVM3 before this boot
+
+typedef char counters_created_check[(COUNTER_COUNT <= 32) ? 1 : -1];
+
+void countersInit(void)
+{
+	Ecode_t status;
+	uint8_t i;
+
+	counters_created = 0;
+	/* Already open when the stack keeps its PS keys in NVM3, opening again with the same parameters is allowed */
+	status = nvm3_open(nvm3_defaultHandle, nvm3_defaultInit);
+	if(status != ECODE_NVM3_OK)
+	{
+		LOG_ERROR("NVM3 open failed 0x%lx, counters not persisted", (unsigned long)status);
+		return;
+	}
+	for(i = 0; i < COUNTER_COUNT; i++)
+	{
+		status = nvm3_readCounter(nvm3_defaultHandle, COUNTER_KEY(i), &counter_values[i]);
+		if(status == ECODE_NVM3_ERR_KEY_NOT_FOUND)
+		{
+			counter_values[i] = 0;
+			counters_created |= 1UL << i;
+			status = nvm3_writeCounter(nvm3_defaultHandle, COUNTER_KEY(i), 0);
+		}
+		if(status != ECODE_NVM3_OK)
+		{
+			LOG_ERROR("Counter %d load failed 0x%lx", i, (unsigned long)status);
+		}
+	}
+	counters_ready = true;
+}
+
+uint32_t counterIncrement(eCounter counter)
+{
+	Ecode_t status;
+
+	if(counter >= COUNTER_COUNT)
+	{
+		return 0;
+	}
+	if(counters_ready)
+	{
+		status = nvm3_incrementCounter(nvm3_defaultHandle, COUNTER_KEY(counter), &counter_values[counter]);
+		if(status == ECODE_NVM3_OK)
+		{
+			return counter_values[counter];
+		}
+		LOG_ERROR("Counter %d increment failed 0x%lx", counter, (unsigned long)status);
+	}
+	return ++counter_values[counter]; //Counted in RAM only
+}
+
+uint32_t counterGet(eCounter counter)
+{
+	return (counter < COUNTER_COUNT) ? counter_values[counter] : 0;
+}
+
+bool counterCreated(eCounter counter)
+{
+	return (counter < COUNTER_COUNT) && (counters_created & (1UL << counter));
+}
+
+void counterSet(eCounter counter, uint32_t value)
+{
+	if((counter >= COUNTER_COUNT) || (counter_values[counter] == value))
+	{
+		return; //The RAM copy matches NVM3, an unchanged value is not written again
+	}
+	counter_values[counter] = value;
+	if(counters_ready)
+	{
+		nvm3_writeCounter(nvm3_defaultHandle, COUNTER_KEY(counter), value);
+	}
+}
+
+uint8_t countersRead(uint32_t *values, uint8_t count)
+{
+	if(count > COUNTER_COUNT)
+	{
+		count = COUNTER_COUNT;
+	}
+	memcpy(values, counter_values, count * sizeof(counter_values[0]));
+	return count;
+}
+
+void countersReset(void)
+{
+	uint8_t i;
+
+	for(i = 0; i < COUNTER_COUNT; i++)
+	{
+		counterSet(i, 0);
+	}
+}
+
+void countersIdle(void)
+{
+	Ecode_t status;
+
+	if(counters_ready && nvm3_repackNeeded(nvm3_defaultHandle))
+	{
+		status = nvm3_repack(nvm3_defaultHandle);
+		if(status != ECODE_NVM3_OK)
+		{
+			LOG_ERROR("NVM3 repack failed 0x%lx", (unsigned long)status);
+		}
+	}
+}
@@ -0,0 +1,110 @@
+/*
+ * @filename	: counters.h
+ * @description	: This file contains header files for counters.c
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Persistent event counters kept in NVM3 counter objects of the default NVM3
+ * instance, the one the stack keeps its PS keys in.  An increment of a counter
+ * object only writes a small delta to flash instead of a whole new object, and
+ * counters are 32 bit so they do not wrap in the life of the device.  A RAM copy
+ * serves all reads.  Repacking NVM3 erases a flash page, so it is only done by
+ * countersIdle() when the main loop has no event to handle.
+ */
+
+#ifndef SRC_COUNTERS_H_
+#define SRC_COUNTERS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ ********************************  DEFINES  ************************************
+ ******************************************************************************/
+
+/* NVM3 key of the first counter, in the application domain below the stack's keys */
+#define COUNTER_NVM3_KEY_BASE	0x01000
+
+typedef enum
+{
+	COUNTER_ALERTS_CLEARED = 0,		//PB0 presses clearing the alerts
+	COUNTER_FAINT_ALERTS,			//Accelerometer levels above ACC_FALL_THRESHOLD
+	COUNTER_FEVER_ALERTS,			//Temperatures above TEMP_ALERT_THRESHOLD
+	COUNTER_INTRUSIONS,				//Motion without a caretaker present
+	COUNTER_FRIENDSHIPS_ESTABLISHED,
+	COUNTER_FRIENDSHIPS_TERMINATED,
+	COUNTER_COUNT
+}eCounter;
+
+/*******************************************************************************
+ **************************    FUNCTION PROTOTYPES    **************************
+ ******************************************************************************/
+
+/**************************************************************************//**
+ * @brief   Load all counters from NVM3
+ *
+ * @detail  Counters not in NVM3 yet are created with the value 0
+ *
+ * @return  Void
+ *****************************************************************************/
+void countersInit(void);
+
+/**************************************************************************//**
+ * @brief   Add one to a counter
+ *
+ * @return  The new value
+ *****************************************************************************/
+uint32_t counterIncrement(eCounter counter);
+
+/**************************************************************************//**
+ * @brief   Current value of a counter
+ *
+ * @return  Counter value
+ *****************************************************************************/
+uint32_t counterGet(eCounter counter);
+
+/**************************************************************************//**
+ * @brief   Whether countersInit() created a counter because NVM3 had none
+ *
+ * @detail  Tells a first boot with the counter from a counter that is still 0,
+ * 			so a count kept elsewhere is migrated only once
+ *
+ * @return  true if the counter was not in NVM3 before this boot
+ *****************************************************************************/
+bool counterCreated(eCounter counter);
+
+/**************************************************************************//**
+ * @brief   Set a counter, for migrating a count kept elsewhere
+ *
+ * @detail  Nothing is written when the counter already holds value
+ *
+ * @return  Void
+ *****************************************************************************/
+void counterSet(eCounter counter, uint32_t value);
+
+/**************************************************************************//**
+ * @brief   Copy the first count counters into values, in eCounter order
+ *
+ * @return  Number of counters copied
+ *****************************************************************************/
+uint8_t countersRead(uint32_t *values, uint8_t count);
+
+/**************************************************************************//**
+ * @brief   Set all counters to 0
+ *
+ * @return  Void
+ *****************************************************************************/
+void countersReset(void);
+
+/**************************************************************************//**
+ * @brief   Idle work of the counters
+ *
+ * @detail  Repacks NVM3 if it needs it.  Call from the main loop only when no
+ * 			stack event is pending, a repack may block for a page erase
+ *
+ * @return  Void
+ *****************************************************************************/
+void countersIdle(void);
+
+#endif /* SRC_COUNTERS_H_ */
@@ -17,7 +17,10 @@
 #include "glib.h"
 #include "gpio.h"
 #include "log.h"
+#include "format.h"
 #include "display.h"
+#include "profile.h"
+#include "energy.h"
 #include "hardware/kit/common/drivers/display.h"
 //#include "fsm.h" // Add a reference to your module supporting scheduler events for display update
 #include "letimer.h" // Add a reference to your module supporting configuration of underflow events here
@@ -32,7 +35,7 @@
 /**
  * The number of rows
  */
-#define DISPLAY_ROW_NUMBER_OF_ROWS	 8
+#define DISPLAY_ROW_NUMBER_OF_ROWS	 DISPLAY_ROW_MAX
 
 /**
  * A structure containing information about the data we want to display on a given
@@ -51,6 +54,16 @@ struct display_data {
 	 * The char content of each row, null terminated
 	 */
 	char row_data[DISPLAY_ROW_NUMBER_OF_ROWS][DISPLAY_ROW_LEN+1];
+	/**
+	 * The char content of each row as it was last drawn into the frame buffer.
+	 * Rows matching row_data are skipped on the next write so only changed
+	 * scanlines get marked in the DMD dirtyRows bitmap and pushed over SPI.
+	 */
+	char rendered_data[DISPLAY_ROW_NUMBER_OF_ROWS][DISPLAY_ROW_LEN+1];
+	/**
+	 * Bitmap of rows written by displayPrintf() since the last displayCommit(), one bit per row
+	 */
+	uint16_t staged_rows;
 };
 
 /**
@@ -70,60 +83,105 @@ static struct display_data *displayGetData() {
 extern size_t strnlen(const char *, size_t);
 
 /**
- * Write the display data in the buffer represented by @param display to the device
+ * Clear the band of scanlines used by @param row to the background color.
+ * Only the scanlines in this band are marked dirty for the next DMD_updateDisplay()
+ */
+static EMSTATUS displayClearRow(GLIB_Context_t *context, enum display_row row)
+{
+	EMSTATUS result;
+	GLIB_Rectangle_t band;
+	int32_t row_height = context->font.lineSpacing + context->font.fontHeight;
+
+	band.xMin = 0;
+	band.xMax = context->pDisplayGeometry->xSize - 1;
+	band.yMin = row_height * row;
+	band.yMax = band.yMin + row_height - 1;
+	if( band.yMax > (int32_t)context->pDisplayGeometry->ySize - 1 ) {
+		band.yMax = context->pDisplayGeometry->ySize - 1;
+	}
+	result = GLIB_setClippingRegion(context, &band);
+	if( result == GLIB_OK ) {
+		result = GLIB_clearRegion(context);
+	}
+	/**
+	 * Restore the full display clipping region for the following GLIB_drawString()
+	 */
+	GLIB_resetClippingRegion(context);
+	GLIB_applyClippingRegion(context);
+	return result;
+}
+
+/**
+ * Write the staged rows of the buffer represented by @param display which changed since
+ * the last write to the device.  Unchanged rows are left alone in the frame buffer, so
+ * DMD_updateDisplay() only flushes the scanlines of the rows which were redrawn.
  */
 static void displayUpdateWriteBuffer(struct display_data *display)
 {
 	enum display_row row = DISPLAY_ROW_FRIEND;
 	GLIB_Context_t *context = &display->context;
-	EMSTATUS result = GLIB_clear(context);
-	if( result != GLIB_OK ) {
-		LOG_ERROR("GLIB_Clear failed with result %d",(int)result);
-	} else {
-		/**
-		 * See example in graphics.c graphPrintCenter()
-		 */
-		for( row = DISPLAY_ROW_FRIEND; row < DISPLAY_ROW_MAX; row ++) {
-			uint8_t row_len = strnlen(display->row_data[row],DISPLAY_ROW_LEN);
-			uint8_t row_width = row_len * context->font.fontWidth;
-			if( row_width > context->pDisplayGeometry->xSize ) {
-				LOG_ERROR("Content of display row %d (%s) with length %d font width %d is too wide for display geometry size %d",
-						row,&display->row_data[row][0],row_len,context->font.fontWidth,context->pDisplayGeometry->xSize);
-			} else {
-				uint8_t posX = (context->pDisplayGeometry->xSize - row_width) >> 1;
-				uint8_t posY = ((context->font.lineSpacing + context->font.fontHeight) * row)
-							   + context->font.lineSpacing;
-				result = GLIB_drawString(context, &display->row_data[row][0], row_len, posX, posY, 0);
-				if( result != GLIB_OK ) {
-					if( result == GLIB_ERROR_NOTHING_TO_DRAW ) {
-						/**
-						 * This error happens if the content of the draw string did not change
-						 */
-						LOG_DEBUG("GLIB_drawString returned GLIB_ERROR_NOTHING_TO_DRAW for string %s len %d",&display->row_data[row][0],row_len);
-						result = GLIB_OK;
-					} else {
-						LOG_ERROR("GLIB_drawString failed with result %d for content %s length %d at X=%d Y=%d",
-								(int)result,&display->row_data[row][0],row_len,posX,posY);
-					}
+	EMSTATUS result;
+	bool rows_changed = false;
+
+	/**
+	 * See example in graphics.c graphPrintCenter()
+	 */
+	for( row = DISPLAY_ROW_FRIEND; row < DISPLAY_ROW_MAX; row ++) {
+		if( (display->staged_rows & (1 << row)) == 0 ) {
+			continue;
+		}
+		if( strncmp(display->row_data[row], display->rendered_data[row], DISPLAY_ROW_LEN) == 0 ) {
+			continue;
+		}
+		rows_changed = true;
+		result = displayClearRow(context, row);
+		if( result != GLIB_OK ) {
+			LOG_ERROR("Clearing display row %d failed with result %d",row,(int)result);
+		}
+		uint8_t row_len = strnlen(display->row_data[row],DISPLAY_ROW_LEN);
+		uint8_t row_width = row_len * context->font.fontWidth;
+		if( row_width > context->pDisplayGeometry->xSize ) {
+			LOG_ERROR("Content of display row %d (%s) with length %d font width %d is too wide for display geometry size %d",
+					row,&display->row_data[row][0],row_len,context->font.fontWidth,context->pDisplayGeometry->xSize);
+		} else {
+			uint8_t posX = (context->pDisplayGeometry->xSize - row_width) >> 1;
+			uint8_t posY = ((context->font.lineSpacing + context->font.fontHeight) * row)
+						   + context->font.lineSpacing;
+			result = GLIB_drawString(context, &display->row_data[row][0], row_len, posX, posY, 0);
+			if( result != GLIB_OK ) {
+				if( result == GLIB_ERROR_NOTHING_TO_DRAW ) {
+					/**
+					 * This error happens if the content of the draw string did not change
+					 */
+					LOG_DEBUG("GLIB_drawString returned GLIB_ERROR_NOTHING_TO_DRAW for string %s len %d",&display->row_data[row][0],row_len);
+					result = GLIB_OK;
+				} else {
+					LOG_ERROR("GLIB_drawString failed with result %d for content %s length %d at X=%d Y=%d",
+							(int)result,&display->row_data[row][0],row_len,posX,posY);
 				}
 			}
 		}
+		memcpy(display->rendered_data[row], display->row_data[row], DISPLAY_ROW_LEN+1);
 	}
-	result = DMD_updateDisplay();
-	if( result != DMD_OK ) {
-		LOG_ERROR("DMD_updateDisplay failed with result %d",(int)result);
+	display->staged_rows = 0;
+	if( rows_changed ) {
+		result = DMD_updateDisplay();
+		if( result != DMD_OK ) {
+			LOG_ERROR("DMD_updateDisplay failed with result %d",(int)result);
+		}
 	}
 }
 
 void displayPrintf(enum display_row row, const char *format, ... )
 {
+	uint32_t cycles = profileStart();
 	struct display_data *display = displayGetData();
-	if( row > DISPLAY_ROW_MAX ) {
+	if( row >= DISPLAY_ROW_MAX ) {
 		LOG_WARN("Row %d exceeded max row, ignoring write request",row);
 	} else {
 		va_list args;
 		va_start (args, format);
-		int chars_written = vsnprintf(&display->row_data[row][0],DISPLAY_ROW_LEN,format,args);
+		int chars_written = fmtVsnprintf(&display->row_data[row][0],DISPLAY_ROW_LEN,format,args);
 		va_end(args);
 		if( chars_written < 0 ) {
 			LOG_WARN("Error encoding format string %s",format);
@@ -136,10 +194,27 @@ void displayPrintf(enum display_row row, const char *format, ... )
 		 * Ensure null terminator
 		 */
 		display->row_data[row][chars_written] = 0;
-		LOG_DEBUG("Updating display row %d with content \"%s\"",row,&display->row_data[row][0]);
+		display->staged_rows |= (1 << row);
+		LOG_DEBUG("Staging display row %d with content \"%s\"",row,&display->row_data[row][0]);
 	}
+	profileSection(PROFILE_DISPLAY_PRINTF, cycles);
+}
 
-	displayUpdateWriteBuffer(display);
+/**
+ * Write all rows staged by displayPrintf() since the last call to the device in a single
+ * DMD_updateDisplay().  Call once at the end of each event loop iteration so a burst of
+ * row updates from one event costs one SPI transfer.
+ */
+void displayCommit()
+{
+	struct display_data *display = displayGetData();
+	if( display->staged_rows ) {
+		uint32_t cycles = profileStart();
+		energyBlockBegin(ENERGY_CAUSE_DISPLAY, sleepEM0);
+		displayUpdateWriteBuffer(display);
+		energyBlockEnd(ENERGY_CAUSE_DISPLAY, sleepEM0);
+		profileSection(PROFILE_DISPLAY_COMMIT, cycles);
+	}
 }
 
 
@@ -172,6 +247,12 @@ static void displayGlibInit(GLIB_Context_t *context)
 				if( GLIB_OK != status ) {
 					LOG_ERROR("Failed to set font to GLIB_FontNarrow6x8 in GLIB_setFont, error was %d",(int)status);
 				}
+
+				/* Start from a blank frame, later writes only touch changed rows */
+				status = GLIB_clear(context);
+				if( GLIB_OK != status ) {
+					LOG_ERROR("Failed to clear display in GLIB_clear, error was %d",(int)status);
+				}
 			}
 		}
 	}
@@ -196,6 +277,7 @@ void displayInit()
 	for( row = DISPLAY_ROW_FRIEND; row < DISPLAY_ROW_MAX; row++ ) {
 		displayPrintf(row,"%s"," ");
 	}
+	displayCommit();
 #if SCHEDULER_SUPPORTS_DISPLAY_UPDATE_EVENT
 #if TIMER_SUPPORTS_1HZ_TIMER_EVENT
 	gecko_cmd_hardware_set_soft_timer((1*32768),1,0);
@@ -25,6 +25,9 @@
  *
  * 3) Call displayInit() before attempting to write the display and after initializing your timer and
  * scheduler.
+ *
+ * 4) displayPrintf() only stages the row content.  Call displayCommit() once at the end of each
+ * 		event loop iteration to write all staged rows to the LCD in one update.
  */
 
 #ifndef SRC_DISPLAY_H_
@@ -56,11 +59,13 @@ enum display_row {
 void displayInit();
 bool displayUpdate();
 void displayPrintf(enum display_row row, const char *format, ... );
+void displayCommit();
 #define TIMER_ID_DISPLAY_UPDATES (1)
 #else
 static inline void displayInit() { }
 static inline bool displayUpdate() { return true; }
 static inline void displayPrintf(enum display_row row, const char *format, ... ) { row=row; format=format;}
+static inline void displayCommit() { }
 #endif
 
 
@@ -1,46 +1,180 @@
 /*
- * @filename : energy.c
- *
- *  @date : Jan 29, 2020
- *  @description : File containing letimer initialization function
- *
- *    	@author : pshiralagi
- *    	@reference : https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ * @filename	: energy.c
+ * @description	: This file contains the source code for the energy mode residency
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
  */
 
 #include "energy.h"
+#include "timebase.h"
+#include "log.h"
+#include <em_core.h>
+#include <string.h>
 
-/*	@brief : Function to initialize various energy modes	*/
-void energyConfig(void)
+#define ENERGY_MODES		(sleepEM3 + 1)		//SLEEP_Sleep() goes no lower than EM3
+
+/* Callbacks the stack gave SLEEP_Init(), defined in libbluetooth_mesh.a and declared in no header */
+void bg_pre_sleep(SLEEP_EnergyMode_t emode);
+void bg_post_wakeup(SLEEP_EnergyMode_t emode);
+
+static uint64_t energy_ticks[ENERGY_MODES];
+static uint64_t energy_cause_ticks[ENERGY_CAUSES];
+static uint64_t energy_cause_since[ENERGY_CAUSES];		//Ticks at the first Begin of the open hold
+static uint8_t energy_cause_holds[ENERGY_CAUSES];
+static uint8_t energy_em2_holds = 0;					//Application EM2 blocks, none means EM1 sleep is the radio
+static uint64_t energy_mark = 0;						//Ticks at the last sleep or wakeup
+static bool energy_started = false;
+
+static bool energySleep(SLEEP_EnergyMode_t emode)
 {
+	uint64_t now = timebaseGetTicks();
+
+	energy_ticks[sleepEM0] += now - energy_mark;
+	energy_mark = now;
+	bg_pre_sleep(emode);
+	return true;
+}
+
+static void energyWakeup(SLEEP_EnergyMode_t emode)
+{
+	uint64_t now = timebaseGetTicks();
+
+	if(emode < ENERGY_MODES)
+	{
+		energy_ticks[emode] += now - energy_mark;
+		if((emode == sleepEM1) && (energy_em2_holds == 0))
+		{
+			energy_cause_ticks[ENERGY_CAUSE_RADIO] += now - energy_mark;
+		}
+	}
+	energy_mark = now;
+	bg_post_wakeup(emode);
+}
 
-	SLEEP_Init_t init_values = {0};		//Null for this assignment
+void energyInit(void)
+{
+	SLEEP_Init_t init = {
+		.sleepCallback = energySleep,
+		.wakeupCallback = energyWakeup,
+		.restoreCallback = NULL,
+	};
+	SLEEP_EnergyMode_t lowest;
+
+	/* The log drain is the only holder left once it is flushed, apart from the stack */
+	logFlush();
+	lowest = SLEEP_LowestEnergyModeGet();
+	SLEEP_InitEx(&init);
+	if(lowest < sleepEM3)
+	{
+		SLEEP_SleepBlockBegin(sleepEM3);
+	}
+	if(lowest < sleepEM2)
+	{
+		SLEEP_SleepBlockBegin(sleepEM2);
+	}
+
+	memset(energy_ticks, 0, sizeof(energy_ticks));
+	memset(energy_cause_ticks, 0, sizeof(energy_cause_ticks));
+	memset(energy_cause_holds, 0, sizeof(energy_cause_holds));
+	energy_em2_holds = 0;
+	energy_mark = timebaseGetTicks();
+	energy_started = true;
+	LOG_INFO("Energy residency from EM%d up", (int)lowest);
+}
+
+void energyBlockBegin(eEnergyCause cause, SLEEP_EnergyMode_t mode)
+{
+	CORE_DECLARE_IRQ_STATE;
 
-	SLEEP_InitEx(&init_values);
-	SLEEP_SleepBlockBegin(energy_mode_i2c+1);
+	CORE_ENTER_ATOMIC();
+	if(cause < ENERGY_CAUSES)
+	{
+		if(energy_cause_holds[cause]++ == 0)
+		{
+			energy_cause_since[cause] = timebaseGetTicks();
+		}
+	}
+	if(mode == sleepEM2)
+	{
+		energy_em2_holds++;
+	}
+	if((mode == sleepEM2) || (mode == sleepEM3))
+	{
+		SLEEP_SleepBlockBegin(mode);
+	}
+	CORE_EXIT_ATOMIC();
 }
 
-/*	@brief : Function to go to sleep based on energy mode	*/
-void goToSleep(void)
+void energyBlockEnd(eEnergyCause cause, SLEEP_EnergyMode_t mode)
 {
-	if ((energy_mode < 3) && (energy_mode > 0))	//If energy mode to be entered is EM1 or EM2
+	CORE_DECLARE_IRQ_STATE;
+
+	CORE_ENTER_ATOMIC();
+	if((cause < ENERGY_CAUSES) && energy_cause_holds[cause])
 	{
-		logFlush();								//Avoid printing garbage values on terminal
-		SLEEP_Sleep();
+		if(--energy_cause_holds[cause] == 0)
+		{
+			energy_cause_ticks[cause] += timebaseGetTicks() - energy_cause_since[cause];
+		}
 	}
-	else if (energy_mode == 3)					//If energy mode to be entered is EM3
+	if((mode == sleepEM2) && energy_em2_holds)
 	{
-		logFlush();
-		EMU_EnterEM3(true);
+		energy_em2_holds--;
 	}
-	else if (energy_mode == 4)					//If energy mode to be entered is EM4 (Need to verify this)
+	if((mode == sleepEM2) || (mode == sleepEM3))
 	{
-		SLEEP_ForceSleepInEM4();
+		SLEEP_SleepBlockEnd(mode);
 	}
+	CORE_EXIT_ATOMIC();
 }
-/*	@brief : Function to sleep in EM1	*/
-void sleep_em1(void)
+
+void energyReport(void)
 {
-//	logFlush();
-	SLEEP_Sleep();
+	uint64_t ms[ENERGY_MODES], cause_ms[ENERGY_CAUSES];
+	uint64_t now, total = 0, charge, average;
+	uint8_t i;
+	CORE_DECLARE_IRQ_STATE;
+
+	if(!energy_started)
+	{
+		return;
+	}
+	/* Copy with the open EM0 interval and the open holds up to now */
+	CORE_ENTER_ATOMIC();
+	now = timebaseGetTicks();
+	for(i = 0; i < ENERGY_MODES; i++)
+	{
+		ms[i] = energy_ticks[i] + ((i == sleepEM0) ? (now - energy_mark) : 0);
+	}
+	for(i = 0; i < ENERGY_CAUSES; i++)
+	{
+		cause_ms[i] = energy_cause_ticks[i] + (energy_cause_holds[i] ? (now - energy_cause_since[i]) : 0);
+	}
+	CORE_EXIT_ATOMIC();
+	for(i = 0; i < ENERGY_MODES; i++)
+	{
+		ms[i] = timebaseTicksToMs(ms[i]);
+		total += ms[i];
+	}
+	for(i = 0; i < ENERGY_CAUSES; i++)
+	{
+		cause_ms[i] = timebaseTicksToMs(cause_ms[i]);
+	}
+
+	/* EM1 with the radio on draws the radio current */
+	charge = (ms[sleepEM0] * ENERGY_EM0_NA) + ((ms[sleepEM1] - cause_ms[ENERGY_CAUSE_RADIO]) * ENERGY_EM1_NA) +
+			 (cause_ms[ENERGY_CAUSE_RADIO] * ENERGY_RADIO_NA) + (ms[sleepEM2] * ENERGY_EM2_NA) +
+			 (ms[sleepEM3] * ENERGY_EM3_NA);
+	average = total ? (charge / total) : 0;
+	(void)average; //Only the log reads it
+
+	LOG_INFO("energy modes em0=%lu em1=%lu em2=%lu em3=%lu ms", (unsigned long)ms[sleepEM0],
+			 (unsigned long)ms[sleepEM1], (unsigned long)ms[sleepEM2], (unsigned long)ms[sleepEM3]);
+	LOG_INFO("energy causes i2c=%lu display=%lu radio=%lu log=%lu ms", (unsigned long)cause_ms[ENERGY_CAUSE_I2C],
+			 (unsigned long)cause_ms[ENERGY_CAUSE_DISPLAY], (unsigned long)cause_ms[ENERGY_CAUSE_RADIO],
+			 (unsigned long)cause_ms[ENERGY_CAUSE_LOG]);
+	LOG_INFO("energy estimate avg=%lu nA life=%lu h of %lu mAh", (unsigned long)average,
+			 (unsigned long)(average ? ((ENERGY_BATTERY_MAH * 1000000ULL) / average) : 0),
+			 (unsigned long)ENERGY_BATTERY_MAH);
 }
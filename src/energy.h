@@ -1,31 +1,117 @@
 /*
- * @filename : energy.h
+ * @filename	: energy.h
+ * @description	: This file contains header files for energy.c
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
  *
- *  @date : Jan 29, 2020
- *  @description : Header file containing function to enter different energy modes
+ * Energy mode residency.  energyInit() puts its own callbacks in front of the
+ * ones the stack gave the SLEEP driver, so every sleep and every wakeup is
+ * timestamped with the timebase and the time is added to EM0, EM1, EM2 or EM3.
+ * Time the stack sleeps in EM1 while no application cause holds EM2 off is
+ * counted as radio time, the stack only blocks EM2 for the radio.
  *
- *    	@author : pshiralagi
- *    	@reference : https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ * The application takes its sleep blocks through energyBlockBegin() and
+ * energyBlockEnd(), which also add up how long each cause held one: the I2C
+ * humidity measurement and the log drain block EM2, the display is counted
+ * while its rows are written.  energyReport() writes the residency, the causes
+ * and an average current from the ENERGY_ datasheet currents below to the log,
+ * tools/energy_report.py reads those lines back.
  */
 
-#ifndef energy_h
-#define energy_h
+#ifndef SRC_ENERGY_H_
+#define SRC_ENERGY_H_
 
+#include <stdint.h>
+#include <stdbool.h>
+#include <sleep.h>
 
-
-#include"main.h"
-
+/*******************************************************************************
+ ********************************  DEFINES  ************************************
+ ******************************************************************************/
 
 #define energy_mode sleepEM2	//Sleep mode selected, this mode will be entered (not this mode - 1) after completing events
 #define energy_mode_i2c sleepEM1 //Sleep mode to enter during i2c transactions and waits
 
-/*	@brief : Function to initialize various energy modes	*/
-void energyConfig(void);
+#define TIMER_ID_ENERGY_REPORT		(5)		//Soft timer writing the energy report
+#ifndef ENERGY_REPORT_S
+#define ENERGY_REPORT_S				3600	//Seconds between two reports, 0 for reports on request only
+#endif
 
-/*	@brief : Function to go to sleep based on energy mode	*/
-void goToSleep(void);
+/* EFR32BG13 datasheet currents at 3 V in nA, EM0 and EM1 at 38.4 MHz from flash */
+#ifndef ENERGY_EM0_NA
+#define ENERGY_EM0_NA				3340000UL	//87 uA/MHz
+#endif
+#ifndef ENERGY_EM1_NA
+#define ENERGY_EM1_NA				1340000UL	//35 uA/MHz
+#endif
+#ifndef ENERGY_EM2_NA
+#define ENERGY_EM2_NA				1400UL		//Full RAM retention, RTCC from the LFXO
+#endif
+#ifndef ENERGY_EM3_NA
+#define ENERGY_EM3_NA				1100UL
+#endif
+#ifndef ENERGY_RADIO_NA
+#define ENERGY_RADIO_NA				8500000UL	//Between RX at 1 Mbps, 8.7 mA, and TX at 0 dBm, 8.2 mA
+#endif
+#ifndef ENERGY_BATTERY_MAH
+#define ENERGY_BATTERY_MAH			225UL		//CR2032
+#endif
 
-/*	@brief : Function to sleep based on external SLEEP_Block statements	*/
-void sleep_em1(void);
+typedef enum
+{
+	ENERGY_CAUSE_I2C = 0,
+	ENERGY_CAUSE_DISPLAY,
+	ENERGY_CAUSE_RADIO,			//Counted in the wakeup callback, never held
+	ENERGY_CAUSE_LOG,
+	ENERGY_CAUSES
+}eEnergyCause;
 
-#endif
+/*******************************************************************************
+ **************************    FUNCTION PROTOTYPES    **************************
+ ******************************************************************************/
+
+/**************************************************************************//**
+ * @brief   Take over the SLEEP driver callbacks from the stack and start
+ * 			counting
+ *
+ * @detail  Call right after gecko_stack_init().  SLEEP_InitEx() clears the
+ * 			sleep blocks, so the log is flushed first and the blocks still
+ * 			seen are taken again once: an EM3 block, and an EM2 block if EM2
+ * 			was blocked, which takes an EM3 block along with it
+ *
+ * @return  Void
+ *****************************************************************************/
+void energyInit(void);
+
+/**************************************************************************//**
+ * @brief   Hold the node above a mode for a cause
+ *
+ * @detail  sleepEM2 and sleepEM3 take a SLEEP block, sleepEM0 only counts the
+ * 			time, for work that keeps the core awake.  Holds of a cause nest,
+ * 			its time counts from the first Begin to the last End.  Safe to call
+ * 			from ISR context
+ *
+ * @return  Void
+ *****************************************************************************/
+void energyBlockBegin(eEnergyCause cause, SLEEP_EnergyMode_t mode);
+
+/**************************************************************************//**
+ * @brief   End a hold of energyBlockBegin(), with the same cause and mode
+ *
+ * @return  Void
+ *****************************************************************************/
+void energyBlockEnd(eEnergyCause cause, SLEEP_EnergyMode_t mode);
+
+/**************************************************************************//**
+ * @brief   Write the residency, the causes and the estimate to the log
+ *
+ * @detail  Times are in ms since energyInit(), the open EM0 interval and
+ * 			holds counted up to now.  Also call when TIMER_ID_ENERGY_REPORT
+ * 			expires
+ *
+ * @return  Void
+ *****************************************************************************/
+void energyReport(void);
+
+#endif /* SRC_ENERGY_H_ */
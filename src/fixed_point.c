@@ -0,0 +1,28 @@
+/*
+ * @filename	: fixed_point.c
+ * @description	: This file contains the source code for fixed point sensor math
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ * 				  Si7021-A20 datasheet, section 5.1.1 and 5.1.2
+ */
+
+#include "fixed_point.h"
+#include "format.h"
+
+/* (a * code + 2^15) >> 16 rounds to nearest, a * 65535 fits in 32 bits for both sensors */
+int32_t fixedHumidityFromCode(uint16_t code)
+{
+	return (int32_t)(((12500UL * code) + 0x8000UL) >> 16) - 600;
+}
+
+int32_t fixedTemperatureFromCode(uint16_t code)
+{
+	return (int32_t)(((17572UL * code) + 0x8000UL) >> 16) - 4685;
+}
+
+char *fixedFormat(char *buf, size_t size, int32_t value)
+{
+	fmtFixed(buf, size, value, 2);
+	return buf;
+}
@@ -0,0 +1,71 @@
+/*
+ * @filename	: fixed_point.h
+ * @description	: This file contains header files for fixed_point.c
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ * 				  Si7021-A20 datasheet, section 5.1.1 and 5.1.2
+ *
+ * Sensor values are kept as integers in hundredths of their unit (centi %RH,
+ * centi degree Celsius, centimetres for distance) from conversion to display,
+ * so no float arithmetic or %f formatting is needed anywhere on the data path.
+ * The LPNs already publish temperature and distance as hundredths in the
+ * generic level state, accelerometer levels are raw counts.
+ */
+
+#ifndef SRC_FIXED_POINT_H_
+#define SRC_FIXED_POINT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*******************************************************************************
+ ********************************  DEFINES  ************************************
+ ******************************************************************************/
+
+#define FIXED_SCALE				100		//Fixed point values are hundredths
+#define FIXED_FROM_INT(value)	((int32_t)(value) * FIXED_SCALE)
+#define FIXED_FORMAT_LEN		13		//"-21474836.48" and the terminator
+
+/*******************************************************************************
+ **************************    FUNCTION PROTOTYPES    **************************
+ ******************************************************************************/
+
+/**************************************************************************//**
+ * @brief   Convert an Si7021 relative humidity code
+ *
+ * @detail  RH = 125 * code / 65536 - 6, rounded to the nearest hundredth
+ *
+ * @return  Relative humidity in hundredths of %RH
+ *****************************************************************************/
+int32_t fixedHumidityFromCode(uint16_t code);
+
+/**************************************************************************//**
+ * @brief   Convert an Si7021 temperature code
+ *
+ * @detail  T = 175.72 * code / 65536 - 46.85, rounded to the nearest hundredth
+ *
+ * @return  Temperature in hundredths of a degree Celsius
+ *****************************************************************************/
+int32_t fixedTemperatureFromCode(uint16_t code);
+
+/**************************************************************************//**
+ * @brief   Convert a generic level published by an LPN in hundredths
+ *
+ * @return  Temperature or distance in hundredths of its unit
+ *****************************************************************************/
+static inline int32_t fixedFromLevel(int16_t level)
+{
+	return level;
+}
+
+/**************************************************************************//**
+ * @brief   Format a fixed point value as a decimal string with two decimals
+ *
+ * @detail  -5 is formatted as "-0.05".  buf should hold FIXED_FORMAT_LEN chars
+ *
+ * @return  buf, so the call can be used as a %s argument
+ *****************************************************************************/
+char *fixedFormat(char *buf, size_t size, int32_t value);
+
+#endif /* SRC_FIXED_POINT_H_ */
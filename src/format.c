@@ -0,0 +1,318 @@
+/*
+ * @filename	: format.c
+ * @description	: This file contains the source code for the integer formatter
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ */
+
+#include "format.h"
+#include <stdbool.h>
+
+#define FMT_FLAG_LEFT	0x01	//'-', pad on the right
+#define FMT_FLAG_ZERO	0x02	//'0', pad numbers with zeros
+#define FMT_FLAG_UPPER	0x04	//%X
+#define FMT_DIGITS_MAX	20		//UINT64_MAX in decimal
+
+/* %zd reads a ptrdiff_t as the signed type of the width of size_t */
+typedef char fmt_ptrdiff_check[(sizeof(ptrdiff_t) == sizeof(size_t)) ? 1 : -1];
+
+/* Output cursor, counts every char so the untruncated length can be returned */
+struct fmt_out
+{
+	char *buf;
+	size_t size;
+	size_t len;
+};
+
+static void fmtPutc(struct fmt_out *out, char c)
+{
+	if((out->len + 1) < out->size)
+	{
+		out->buf[out->len] = c;
+	}
+	out->len++;
+}
+
+static void fmtPad(struct fmt_out *out, char c, int count)
+{
+	while(count-- > 0)
+	{
+		fmtPutc(out, c);
+	}
+}
+
+static void fmtTerminate(struct fmt_out *out)
+{
+	if(out->size != 0)
+	{
+		out->buf[(out->len < out->size) ? out->len : (out->size - 1)] = '\0';
+	}
+}
+
+/* Emit sign, prefix zeros and digits of a number into a field of width chars */
+static void fmtNumber(struct fmt_out *out, uint64_t value, bool negative, uint8_t base,
+					  uint8_t flags, int width, int precision)
+{
+	const char *digits = (flags & FMT_FLAG_UPPER) ? "0123456789ABCDEF" : "0123456789abcdef";
+	char tmp[FMT_DIGITS_MAX];
+	int count = 0;
+	int zeros;
+	int field;
+
+	/* C rule: a zero value with zero precision prints no digits */
+	while((value != 0) || ((count == 0) && (precision != 0)))
+	{
+		tmp[count++] = digits[value % base];
+		value /= base;
+	}
+	zeros = (precision > count) ? (precision - count) : 0;
+	field = count + zeros + (negative ? 1 : 0);
+
+	/* '0' is ignored with '-' or an explicit precision */
+	if((flags & FMT_FLAG_ZERO) && !(flags & FMT_FLAG_LEFT) && (precision < 0) && (width > field))
+	{
+		zeros += width - field;
+		field = width;
+	}
+	if(!(flags & FMT_FLAG_LEFT))
+	{
+		fmtPad(out, ' ', width - field);
+	}
+	if(negative)
+	{
+		fmtPutc(out, '-');
+	}
+	fmtPad(out, '0', zeros);
+	while(count > 0)
+	{
+		fmtPutc(out, tmp[--count]);
+	}
+	if(flags & FMT_FLAG_LEFT)
+	{
+		fmtPad(out, ' ', width - field);
+	}
+}
+
+static void fmtString(struct fmt_out *out, const char *str, uint8_t flags, int width, int precision)
+{
+	int len = 0;
+	int i;
+
+	if(str == NULL)
+	{
+		str = "(null)";
+	}
+	while(((precision < 0) || (len < precision)) && (str[len] != '\0'))
+	{
+		len++;
+	}
+	if(!(flags & FMT_FLAG_LEFT))
+	{
+		fmtPad(out, ' ', width - len);
+	}
+	for(i = 0; i < len; i++)
+	{
+		fmtPutc(out, str[i]);
+	}
+	if(flags & FMT_FLAG_LEFT)
+	{
+		fmtPad(out, ' ', width - len);
+	}
+}
+
+int fmtVsnprintf(char *buf, size_t size, const char *format, va_list args)
+{
+	struct fmt_out out = { buf, size, 0 };
+
+	while(*format != '\0')
+	{
+		uint8_t flags = 0;
+		uint8_t length = 0;		//Count of 'l', 2 for ll, 0xFF for z, 0xFE for h and hh
+		int width = 0;
+		int precision = -1;
+		uint64_t value;
+		bool negative = false;
+
+		if(*format != '%')
+		{
+			fmtPutc(&out, *format++);
+			continue;
+		}
+		format++;
+
+		for(;; format++)
+		{
+			if(*format == '-')
+			{
+				flags |= FMT_FLAG_LEFT;
+			}
+			else if(*format == '0')
+			{
+				flags |= FMT_FLAG_ZERO;
+			}
+			else
+			{
+				break;
+			}
+		}
+		while((*format >= '0') && (*format <= '9'))
+		{
+			width = (width * 10) + (*format++ - '0');
+		}
+		if(*format == '.')
+		{
+			format++;
+			precision = 0;
+			while((*format >= '0') && (*format <= '9'))
+			{
+				precision = (precision * 10) + (*format++ - '0');
+			}
+		}
+		while((*format == 'l') || (*format == 'h') || (*format == 'z'))
+		{
+			length = (*format == 'l') ? (uint8_t)(length + 1) : ((*format == 'z') ? 0xFF : 0xFE);
+			format++;
+		}
+
+		switch(*format)
+		{
+		case 'd':
+		case 'i':
+		{
+			int64_t svalue;
+			if(length == 2)
+			{
+				svalue = va_arg(args, long long);
+			}
+			else if(length == 1)
+			{
+				svalue = va_arg(args, long);
+			}
+			else if(length == 0xFF)
+			{
+				svalue = va_arg(args, ptrdiff_t); //Signed size_t, sign extended
+			}
+			else
+			{
+				svalue = va_arg(args, int); //h and hh are promoted to int
+			}
+			negative = (svalue < 0);
+			value = negative ? (0ULL - (uint64_t)svalue) : (uint64_t)svalue;
+			fmtNumber(&out, value, negative, 10, flags, width, precision);
+			break;
+		}
+		case 'u':
+		case 'x':
+		case 'X':
+			if(length == 2)
+			{
+				value = va_arg(args, unsigned long long);
+			}
+			else if(length == 1)
+			{
+				value = va_arg(args, unsigned long);
+			}
+			else if(length == 0xFF)
+			{
+				value = va_arg(args, size_t);
+			}
+			else
+			{
+				value = va_arg(args, unsigned int);
+			}
+			if(*format == 'X')
+			{
+				flags |= FMT_FLAG_UPPER;
+			}
+			fmtNumber(&out, value, false, (*format == 'u') ? 10 : 16, flags, width, precision);
+			break;
+		case 'p':
+			fmtPutc(&out, '0');
+			fmtPutc(&out, 'x');
+			fmtNumber(&out, (uintptr_t)va_arg(args, void *), false, 16, flags, width, precision);
+			break;
+		case 'c':
+		{
+			char c = (char)va_arg(args, int);
+			if(!(flags & FMT_FLAG_LEFT))
+			{
+				fmtPad(&out, ' ', width - 1);
+			}
+			fmtPutc(&out, c);
+			if(flags & FMT_FLAG_LEFT)
+			{
+				fmtPad(&out, ' ', width - 1);
+			}
+			break;
+		}
+		case 's':
+			fmtString(&out, va_arg(args, const char *), flags, width, precision);
+			break;
+		case '%':
+			fmtPutc(&out, '%');
+			break;
+		case '\0':
+			format--; //Lone '%' at the end, stop on the terminator
+			break;
+		default:
+			fmtPutc(&out, '%'); //Unsupported conversion, copied through
+			fmtPutc(&out, *format);
+			break;
+		}
+		format++;
+	}
+	fmtTerminate(&out);
+	return (int)out.len;
+}
+
+int fmtSnprintf(char *buf, size_t size, const char *format, ...)
+{
+	va_list args;
+	int len;
+
+	va_start(args, format);
+	len = fmtVsnprintf(buf, size, format, args);
+	va_end(args);
+	return len;
+}
+
+size_t fmtUint(char *buf, size_t size, uint32_t value, uint8_t width, char pad)
+{
+	struct fmt_out out = { buf, size, 0 };
+
+	fmtNumber(&out, value, false, 10, (pad == '0') ? FMT_FLAG_ZERO : 0, width, -1);
+	fmtTerminate(&out);
+	return out.len;
+}
+
+size_t fmtInt(char *buf, size_t size, int32_t value, uint8_t width, char pad)
+{
+	struct fmt_out out = { buf, size, 0 };
+	uint32_t magnitude = (value < 0) ? (0UL - (uint32_t)value) : (uint32_t)value;
+
+	fmtNumber(&out, magnitude, value < 0, 10, (pad == '0') ? FMT_FLAG_ZERO : 0, width, -1);
+	fmtTerminate(&out);
+	return out.len;
+}
+
+size_t fmtFixed(char *buf, size_t size, int32_t value, uint8_t decimals)
+{
+	struct fmt_out out = { buf, size, 0 };
+	uint32_t magnitude = (value < 0) ? (0UL - (uint32_t)value) : (uint32_t)value;
+	uint32_t scale = 1;
+	uint8_t i;
+
+	for(i = 0; (i < decimals) && (scale <= (UINT32_MAX / 10)); i++)
+	{
+		scale *= 10;
+	}
+	fmtNumber(&out, magnitude / scale, value < 0, 10, 0, 0, -1);
+	if(i != 0)
+	{
+		fmtPutc(&out, '.');
+		fmtNumber(&out, magnitude % scale, false, 10, 0, 0, i);
+	}
+	fmtTerminate(&out);
+	return out.len;
+}
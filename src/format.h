@@ -0,0 +1,76 @@
+/*
+ * @filename	: format.h
+ * @description	: This file contains header files for format.c
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Integer only replacement for snprintf on the display and log paths, so
+ * newlib's float printf is never linked in.  fmtVsnprintf() understands the
+ * subset of printf used in this project:
+ *   %d %i %u %x %X %c %s %p %%
+ *   flags '-' and '0', field width, precision, length modifiers hh h l ll z
+ * Width and precision may not be given as '*'.  Fixed point values are
+ * formatted with fmtFixed() and passed as %s.
+ */
+
+#ifndef SRC_FORMAT_H_
+#define SRC_FORMAT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+
+/*******************************************************************************
+ **************************    FUNCTION PROTOTYPES    **************************
+ ******************************************************************************/
+
+/**************************************************************************//**
+ * @brief   vsnprintf for the integer subset of printf
+ *
+ * @detail  Output is truncated to size - 1 chars and always terminated when
+ * 			size is non zero
+ *
+ * @return  Length of the untruncated output, as vsnprintf
+ *****************************************************************************/
+int fmtVsnprintf(char *buf, size_t size, const char *format, va_list args)
+	__attribute__((format(printf, 3, 0)));
+
+/**************************************************************************//**
+ * @brief   snprintf for the integer subset of printf
+ *
+ * @return  Length of the untruncated output, as snprintf
+ *****************************************************************************/
+int fmtSnprintf(char *buf, size_t size, const char *format, ...)
+	__attribute__((format(printf, 3, 4)));
+
+/**************************************************************************//**
+ * @brief   Format an unsigned decimal right aligned in a field
+ *
+ * @detail  Padded on the left with pad ('0' or ' ') up to width chars
+ *
+ * @return  Length of the untruncated output
+ *****************************************************************************/
+size_t fmtUint(char *buf, size_t size, uint32_t value, uint8_t width, char pad);
+
+/**************************************************************************//**
+ * @brief   Format a signed decimal right aligned in a field
+ *
+ * @detail  Padded on the left with pad ('0' or ' ') up to width chars, a zero
+ * 			padded sign goes before the zeros
+ *
+ * @return  Length of the untruncated output
+ *****************************************************************************/
+size_t fmtInt(char *buf, size_t size, int32_t value, uint8_t width, char pad);
+
+/**************************************************************************//**
+ * @brief   Format a fixed point decimal
+ *
+ * @detail  value is in units of 10^-decimals, fmtFixed(buf, size, -5, 2)
+ * 			gives "-0.05"
+ *
+ * @return  Length of the untruncated output
+ *****************************************************************************/
+size_t fmtFixed(char *buf, size_t size, int32_t value, uint8_t decimals);
+
+#endif /* SRC_FORMAT_H_ */
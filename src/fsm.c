@@ -0,0 +1,46 @@
+/*
+ * @filename	: fsm.c
+ * @description	: This file contains the source code for the state machine engine
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ */
+
+#include "fsm.h"
+#include <stddef.h>
+
+bool fsmDispatch(fsm_t *fsm, uint8_t event)
+{
+	const fsm_transition_t *transition;
+
+	if((event >= fsm->num_events) || (fsm->state >= fsm->num_states))
+	{
+		fsm->dropped_events++;
+		return false;
+	}
+	transition = &fsm->table[(fsm->state * fsm->num_events) + event];
+	if(!transition->valid)
+	{
+		fsm->dropped_events++;
+		return false;
+	}
+
+	fsm->state = transition->next;
+	if(transition->action != NULL)
+	{
+		transition->action();
+	}
+	if((transition->timeout_ms != 0) && (fsm->timer_start != NULL))
+	{
+		fsm->timer_start(transition->timeout_ms);
+	}
+	return true;
+}
+
+void fsmReset(fsm_t *fsm, uint8_t state)
+{
+	if(state < fsm->num_states)
+	{
+		fsm->state = state;
+	}
+}
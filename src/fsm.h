@@ -0,0 +1,93 @@
+/*
+ * @filename	: fsm.h
+ * @description	: This file contains the table driven state machine engine
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Each state machine is a const [state][event] table of transitions built with
+ * FSM_TRANSITION().  Dispatching an event is a single table lookup.  A transition
+ * with a non zero timeout starts the machine's timer on entry to the next state,
+ * the timer expiry must be dispatched back as FSM_EVENT_TIMEOUT.
+ * Events with no transition from the current state are dropped and counted.
+ */
+
+#ifndef SRC_FSM_H_
+#define SRC_FSM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ ********************************  DEFINES  ************************************
+ ******************************************************************************/
+
+/* Event 0 of every machine is the expiry of its transition timeout */
+#define FSM_EVENT_TIMEOUT	0
+
+typedef void (*fsm_action_t)(void);
+typedef void (*fsm_timer_start_t)(uint32_t ms);
+
+typedef struct
+{
+	fsm_action_t action;	//Run on the transition, may be NULL
+	uint8_t next;			//State entered
+	uint8_t valid;			//Set for transitions defined in the table
+	uint16_t timeout_ms;	//FSM_EVENT_TIMEOUT is due this long after entering next, 0 for none
+}fsm_transition_t;
+
+typedef struct
+{
+	const fsm_transition_t *table;
+	uint8_t num_states;
+	uint8_t num_events;
+	volatile uint8_t state;
+	fsm_timer_start_t timer_start;
+	uint32_t dropped_events;
+}fsm_t;
+
+/* Integer constant 0, fails to compile when cond is false */
+#define FSM_STATIC_CHECK(cond)	(0 * sizeof(char[(cond) ? 1 : -1]))
+
+/*
+ * Designated initializer for one entry of a [num_states][num_events] table.
+ * State, event and next state are range checked at compile time.
+ */
+#define FSM_TRANSITION(num_states, num_events, state, event, action, next, timeout_ms) \
+	[(state) + FSM_STATIC_CHECK((state) < (num_states))]                                \
+	[(event) + FSM_STATIC_CHECK((event) < (num_events))] =                              \
+	{ (action), (next) + FSM_STATIC_CHECK((next) < (num_states)), 1,                    \
+	  (timeout_ms) + FSM_STATIC_CHECK((timeout_ms) <= UINT16_MAX) }
+
+/* Initializer for an fsm_t running the two dimensional transition table */
+#define FSM_INIT(table, initial_state, timer_start)                                     \
+	{ &(table)[0][0], sizeof(table) / sizeof((table)[0]),                               \
+	  sizeof((table)[0]) / sizeof((table)[0][0]), (initial_state), (timer_start), 0 }
+
+/*******************************************************************************
+ **************************    FUNCTION PROTOTYPES    **************************
+ ******************************************************************************/
+
+/**************************************************************************//**
+ * @brief   Deliver an event to a state machine
+ *
+ * @detail  Looks up the transition for the current state and event, enters
+ * 			the next state, runs the action and starts the timeout if any
+ *
+ * @return  true if the event caused a transition
+ *****************************************************************************/
+bool fsmDispatch(fsm_t *fsm, uint8_t event);
+
+/**************************************************************************//**
+ * @brief   Put a state machine back in a state without running any action
+ *
+ * @return  Void
+ *****************************************************************************/
+void fsmReset(fsm_t *fsm, uint8_t state);
+
+static inline uint8_t fsmState(const fsm_t *fsm)
+{
+	return fsm->state;
+}
+
+#endif /* SRC_FSM_H_ */
@@ -102,7 +102,7 @@ void gpioint(uint8_t pin)
 {
   if (pin == PB0_Pin)
   {
-    gecko_external_signal(0x40);
+    signalPost(SIGNAL_PB0);
   }
 }
 
@@ -148,14 +148,11 @@ void pirInit(void)
 
 void motionDetected(uint8_t pin)
 {
-	CORE_DECLARE_IRQ_STATE;
 	if(pin == MOTION_PIN)
 	{
 		if(GPIO_PinInGet(MOTION_PORT, MOTION_PIN) == 1)
 		{
-			CORE_ENTER_CRITICAL();
-			gecko_external_signal(0x50);
-			CORE_EXIT_CRITICAL();
+			signalPost(SIGNAL_PIR);
 		}
 	}
 
@@ -167,8 +164,6 @@ void LPM_On(void)
 //	GPIO_PinOutSet(I2C0_ENABLE_PORT,I2C0_ENABLE_PIN);
 	GPIO_PinOutSet(I2C0_SCL_PORT, I2C0_SCL_PIN);
 	GPIO_PinOutSet(I2C0_SDA_PORT, I2C0_SDA_PIN);
-
-	timerWaitMs(80); //Time needed for power to stabilize = 80ms
 }
 
 void LPM_Off(void)
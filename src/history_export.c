@@ -0,0 +1,213 @@
+/*
+ * @filename	: history_export.c
+ * @description	: This file contains the source code for the GATT export of the journal
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ */
+
+#include "history_export.h"
+#include "journal.h"
+#include "gatt_db.h"
+#include "gecko_ble_errors.h"
+#include "log.h"
+
+#define HISTORY_NO_CONNECTION		0xFF
+#define HISTORY_DEFAULT_MTU			23
+#define HISTORY_ATT_HEADER			3		//Opcode and handle of a notification
+#define HISTORY_FRAME_MAX			(HISTORY_MAX_MTU - HISTORY_ATT_HEADER)
+#define HISTORY_RECORDS_MAX			((HISTORY_FRAME_MAX - HISTORY_HEADER_SIZE) / HISTORY_RECORD_SIZE)
+#define HISTORY_ATT_CCCD_IMPROPER	0xFD	//Notifications of History Data are not enabled
+#define HISTORY_RETRY_TICKS_MIN		246		//7.5 ms, shortest connection interval
+#define INTERVAL_TO_TICKS(interval)	(((uint32_t)(interval) * 32768UL * 5) / 4000)	//1.25 ms units to 32768 Hz ticks
+
+typedef char history_frame_check[((HISTORY_HEADER_SIZE + HISTORY_RECORD_SIZE) <= (HISTORY_DEFAULT_MTU - HISTORY_ATT_HEADER)) &&
+								 (HISTORY_RECORDS_MAX < HISTORY_FRAME_END) ? 1 : -1];
+
+static uint8_t history_connection = HISTORY_NO_CONNECTION;	//Connection the export runs on
+static uint16_t history_mtu = HISTORY_DEFAULT_MTU;
+static uint32_t history_retry_ticks = INTERVAL_TO_TICKS(40);	//Until the connection parameters are known
+static bool history_notify = false;						//Client enabled History Data notifications
+static bool history_active = false;
+static journal_cursor_t history_cursor;
+static uint32_t history_records_sent;
+
+static uint8_t *historyPut32(uint8_t *buf, uint32_t value)
+{
+	buf[0] = (uint8_t)value;
+	buf[1] = (uint8_t)(value >> 8);
+	buf[2] = (uint8_t)(value >> 16);
+	buf[3] = (uint8_t)(value >> 24);
+	return buf + 4;
+}
+
+/* Pack the records after the header, returns the frame length */
+static uint8_t historyFrame(uint8_t *frame, const journal_record_t *records, uint8_t count, bool end,
+							uint32_t position)
+{
+	uint8_t *p = frame;
+	uint8_t i;
+
+	*p++ = count | (end ? HISTORY_FRAME_END : 0);
+	p = historyPut32(p, position);
+	for(i = 0; i < count; i++)
+	{
+		p = historyPut32(p, records[i].timestamp_ms);
+		p = historyPut32(p, (uint32_t)records[i].value);
+		p = historyPut32(p, (uint32_t)records[i].aux);
+		*p++ = (uint8_t)records[i].address;
+		*p++ = (uint8_t)(records[i].address >> 8);
+		*p++ = records[i].type;
+	}
+	return (uint8_t)(p - frame);
+}
+
+static void historyStop(void)
+{
+	if(history_active)
+	{
+		BTSTACK_CHECK_RESPONSE(gecko_cmd_hardware_set_soft_timer(0, TIMER_ID_HISTORY_EXPORT, 1));
+	}
+	history_active = false;
+}
+
+void historyExportInit(void)
+{
+	BTSTACK_CHECK_RESPONSE(gecko_cmd_gatt_server_set_max_mtu(HISTORY_MAX_MTU));
+}
+
+void historyExportConnectionParameters(uint8_t connection, uint16_t interval)
+{
+	if((history_connection != HISTORY_NO_CONNECTION) && (connection != history_connection))
+	{
+		return;
+	}
+	history_retry_ticks = INTERVAL_TO_TICKS(interval);
+	if(history_retry_ticks < HISTORY_RETRY_TICKS_MIN)
+	{
+		history_retry_ticks = HISTORY_RETRY_TICKS_MIN;
+	}
+}
+
+void historyExportMtu(uint8_t connection, uint16_t mtu)
+{
+	if((history_connection != HISTORY_NO_CONNECTION) && (connection != history_connection))
+	{
+		return;
+	}
+	history_mtu = (mtu > HISTORY_MAX_MTU) ? HISTORY_MAX_MTU : mtu;
+}
+
+void historyExportConnectionClosed(uint8_t connection)
+{
+	if((history_connection != HISTORY_NO_CONNECTION) && (connection != history_connection))
+	{
+		return;
+	}
+	if(history_active)
+	{
+		LOG_INFO("History export interrupted after %lu records", (unsigned long)history_records_sent);
+	}
+	historyStop();
+	history_connection = HISTORY_NO_CONNECTION;
+	history_mtu = HISTORY_DEFAULT_MTU;
+	history_notify = false;
+}
+
+void historyExportStatus(struct gecko_msg_gatt_server_characteristic_status_evt_t *status)
+{
+	if((status->characteristic != gattdb_history_data) || (status->status_flags != gatt_server_client_config))
+	{
+		return;
+	}
+	history_connection = status->connection;
+	history_notify = (status->client_config_flags & gatt_notification) != 0;
+	if(!history_notify)
+	{
+		historyStop();
+	}
+}
+
+void historyExportControl(struct gecko_msg_gatt_server_user_write_request_evt_t *request)
+{
+	uint8_t att_error = 0;
+	const uint8_t *value = request->value.data;
+	uint32_t position;
+
+	if(request->value.len == 0)
+	{
+		att_error = (uint8_t)bg_err_att_invalid_att_length;
+	}
+	else if((value[0] != HISTORY_CMD_STOP) && (!history_notify || (request->connection != history_connection)))
+	{
+		att_error = HISTORY_ATT_CCCD_IMPROPER;
+	}
+	else if(value[0] == HISTORY_CMD_STOP)
+	{
+		historyStop();
+	}
+	else if((value[0] == HISTORY_CMD_START) && (request->value.len == 1))
+	{
+		journalCursorOldest(&history_cursor);
+		history_active = true;
+	}
+	else if((value[0] == HISTORY_CMD_RESUME) && (request->value.len == 5))
+	{
+		position = value[1] | ((uint32_t)value[2] << 8) | ((uint32_t)value[3] << 16) | ((uint32_t)value[4] << 24);
+		journalCursorSeek(&history_cursor, position);
+		history_active = true;
+	}
+	else
+	{
+		att_error = (uint8_t)bg_err_att_value_not_allowed;
+	}
+	BTSTACK_CHECK_RESPONSE(gecko_cmd_gatt_server_send_user_write_response(request->connection, gattdb_history_control,
+																		   att_error));
+	if((att_error == 0) && history_active)
+	{
+		LOG_INFO("History export from position %lu, %lu records stored",
+				 (unsigned long)journalCursorPosition(&history_cursor), (unsigned long)journalCount());
+		history_records_sent = 0;
+		historyExportPump();
+	}
+}
+
+void historyExportPump(void)
+{
+	journal_record_t records[HISTORY_RECORDS_MAX];
+	uint8_t frame[HISTORY_FRAME_MAX];
+	journal_cursor_t start;
+	uint8_t max, count, len;
+	uint16 result;
+	bool end;
+
+	max = (uint8_t)(((history_mtu - HISTORY_ATT_HEADER) - HISTORY_HEADER_SIZE) / HISTORY_RECORD_SIZE);
+	while(history_active && history_notify)
+	{
+		start = history_cursor;
+		count = (uint8_t)journalRead(&history_cursor, records, max);
+		end = count < max;
+		len = historyFrame(frame, records, count, end, journalCursorPosition(&history_cursor));
+		result = gecko_cmd_gatt_server_send_characteristic_notification(history_connection, gattdb_history_data,
+																		len, frame)->result;
+		if(result == bg_err_out_of_memory)
+		{
+			/* Queue is full, it drains at the next connection events */
+			history_cursor = start;
+			BTSTACK_CHECK_RESPONSE(gecko_cmd_hardware_set_soft_timer(history_retry_ticks, TIMER_ID_HISTORY_EXPORT, 1));
+			return;
+		}
+		if(result != bg_err_success)
+		{
+			LOG_ERROR("History notification failed, result 0x%x", result);
+			historyStop();
+			return;
+		}
+		history_records_sent += count;
+		if(end)
+		{
+			LOG_INFO("History export done, %lu records", (unsigned long)history_records_sent);
+			history_active = false;
+		}
+	}
+}
@@ -0,0 +1,104 @@
+/*
+ * @filename	: history_export.h
+ * @description	: This file contains header files for history_export.c
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Bulk export of the journal over the Patient History GATT service.  A client
+ * enables notifications of History Data and writes a command to History
+ * Control.  The records are then sent as History Data notifications, each one
+ * as large as the ATT MTU allows:
+ *
+ * 		byte 0		record count, HISTORY_FRAME_END set on the last frame
+ * 		bytes 1-4	journal position after the last record of the frame
+ * 		then		HISTORY_RECORD_SIZE bytes per record, as journal_record_t
+ * 					without the check byte
+ *
+ * All values are little endian.  Writing HISTORY_CMD_RESUME with the position
+ * of the last frame received continues an interrupted export.  Notifications
+ * are queued until the stack runs out of buffers, the queue is topped up again
+ * one connection interval later, so the export runs as fast as the connection
+ * interval lets it.
+ */
+
+#ifndef SRC_HISTORY_EXPORT_H_
+#define SRC_HISTORY_EXPORT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "native_gecko.h"
+
+/*******************************************************************************
+ ********************************  DEFINES  ************************************
+ ******************************************************************************/
+
+#define TIMER_ID_HISTORY_EXPORT		(3)		//Soft timer retrying when the notification queue is full
+#define HISTORY_MAX_MTU				247		//ATT MTU offered to clients
+#define HISTORY_HEADER_SIZE			5
+#define HISTORY_RECORD_SIZE			15
+#define HISTORY_FRAME_END			0x80	//Flag of the record count byte, no records left
+
+/* History Control commands, first byte of the write */
+#define HISTORY_CMD_STOP			0x00
+#define HISTORY_CMD_START			0x01	//Export from the oldest record
+#define HISTORY_CMD_RESUME			0x02	//Followed by a 4 byte journal position
+
+/*******************************************************************************
+ **************************    FUNCTION PROTOTYPES    **************************
+ ******************************************************************************/
+
+/**************************************************************************//**
+ * @brief   Raise the ATT MTU the stack accepts to HISTORY_MAX_MTU
+ *
+ * @detail  Call on the system boot event
+ *
+ * @return  Void
+ *****************************************************************************/
+void historyExportInit(void);
+
+/**************************************************************************//**
+ * @brief   Track the connection interval, from gecko_evt_le_connection_parameters
+ *
+ * @return  Void
+ *****************************************************************************/
+void historyExportConnectionParameters(uint8_t connection, uint16_t interval);
+
+/**************************************************************************//**
+ * @brief   Track the ATT MTU, from gecko_evt_gatt_mtu_exchanged
+ *
+ * @return  Void
+ *****************************************************************************/
+void historyExportMtu(uint8_t connection, uint16_t mtu);
+
+/**************************************************************************//**
+ * @brief   Stop the export of a closed connection
+ *
+ * @return  Void
+ *****************************************************************************/
+void historyExportConnectionClosed(uint8_t connection);
+
+/**************************************************************************//**
+ * @brief   Track the client configuration of History Data
+ *
+ * @return  Void
+ *****************************************************************************/
+void historyExportStatus(struct gecko_msg_gatt_server_characteristic_status_evt_t *status);
+
+/**************************************************************************//**
+ * @brief   Handle a write of History Control and send the write response
+ *
+ * @return  Void
+ *****************************************************************************/
+void historyExportControl(struct gecko_msg_gatt_server_user_write_request_evt_t *request);
+
+/**************************************************************************//**
+ * @brief   Queue notifications until the stack has no buffer left
+ *
+ * @detail  Call when TIMER_ID_HISTORY_EXPORT expires
+ *
+ * @return  Void
+ *****************************************************************************/
+void historyExportPump(void);
+
+#endif /* SRC_HISTORY_EXPORT_H_ */
@@ -8,6 +8,7 @@
  */
 
 #include "i2c.h"
+#include "ldma.h"
 
 uint8_t read_data[2];
 I2C_TransferSeq_TypeDef seq_write;
@@ -15,10 +16,20 @@ I2C_TransferSeq_TypeDef seq_read;
 uint8_t write_data = 0xE5; //No Master Hold Mode HUMIDITY
 
 uint32_t i2c_interrupt;
-float Received_Data;
+int32_t Received_Data; //Relative humidity in hundredths of %RH
+uint32_t i2c_error_count = 0;
 
+#if I2C_TRANSFER_MODE == I2C_TRANSFER_LDMA
+#define I2C_ERROR_FLAGS (I2C_IF_NACK | I2C_IF_ARBLOST | I2C_IF_BUSERR)
 
+static uint16_t read_len;
+#elif I2C_TRANSFER_MODE == I2C_TRANSFER_MOCK
+static uint16_t mock_humidity_code = I2C_MOCK_HUMIDITY_CODE;
+#endif
 
+
+
+#if I2C_TRANSFER_MODE != I2C_TRANSFER_MOCK
 void I2C_Initialize()
 {
 	I2CSPM_Init_TypeDef i2c_init =
@@ -37,6 +48,9 @@ void I2C_Initialize()
 	I2CSPM_Init(&i2c_init);
 	NVIC_EnableIRQ(I2C0_IRQn);
 }
+#endif
+
+#if I2C_TRANSFER_MODE == I2C_TRANSFER_IRQ
 
 void I2C_Write()
 {
@@ -72,25 +86,111 @@ void I2C_Read()
 
 }
 
+#elif I2C_TRANSFER_MODE == I2C_TRANSFER_LDMA
+
+/*
+ * Called once the transaction has ended, successfully or not
+ */
+static void I2C_TransferDone(void)
+{
+	I2C0->IEN = 0;
+	I2C0->CTRL &= ~(I2C_CTRL_AUTOACK | I2C_CTRL_AUTOSE);
+	signalPost(SIGNAL_I2C_DONE); //Setting signal event for next state
+}
+
+/*
+ * Clear any leftover state and send START with the address byte
+ */
+static void I2C_TransferStart(uint8_t addr, uint32_t ctrl, uint32_t ien)
+{
+	if(I2C0->STATE & I2C_STATE_BUSY)
+	{
+		I2C0->CMD = I2C_CMD_ABORT;
+	}
+	I2C0->CMD = I2C_CMD_CLEARTX | I2C_CMD_CLEARPC;
+	I2C0->IFC = _I2C_IF_MASK;
+	I2C0->CTRL = (I2C0->CTRL & ~(I2C_CTRL_AUTOACK | I2C_CTRL_AUTOSE)) | ctrl;
+	I2C0->IEN = ien | I2C_ERROR_FLAGS | I2C_IF_MSTOP;
+	I2C0->TXDATA = addr;
+	I2C0->CMD = I2C_CMD_START;
+}
+
+/*
+ * LDMA has read all but the last byte.  Stop auto acknowledging so the last
+ * byte can be NACKed from the RXDATAV interrupt.  At 100 kHz the last byte
+ * takes 90 us to arrive, well above the interrupt latency.
+ */
+static void I2C_ReadLastByte(void)
+{
+	I2C0->CTRL &= ~I2C_CTRL_AUTOACK;
+	I2C0->IEN |= I2C_IF_RXDATAV;
+}
+
+void I2C_Write()
+{
+	/* LDMA feeds the data bytes into TXDATA and AUTOSE sends STOP once it runs dry,
+	 * so the only interrupt of the write is MSTOP */
+	I2C_TransferStart(SLAVE_ADDRESS << 1, I2C_CTRL_AUTOSE, 0);
+	ldmaStartTransfer(LDMA_CHANNEL_I2C0_TX, DMAREQ_I2C0_TXBL, &write_data, &I2C0->TXDATA,
+					  sizeof(write_data), LDMA_CH_CTRL_SRCINC_ONE | LDMA_CH_CTRL_DSTINC_NONE, NULL);
+}
+
+void I2C_Read()
+{
+	read_len = sizeof(read_data);
+	if(read_len > 1)
+	{
+		I2C_TransferStart((SLAVE_ADDRESS << 1) | 1, I2C_CTRL_AUTOACK, 0);
+		ldmaStartTransfer(LDMA_CHANNEL_I2C0_RX, DMAREQ_I2C0_RXDATAV, &I2C0->RXDATA, read_data,
+						  read_len - 1, LDMA_CH_CTRL_SRCINC_NONE | LDMA_CH_CTRL_DSTINC_ONE, I2C_ReadLastByte);
+	}
+	else
+	{
+		I2C_TransferStart((SLAVE_ADDRESS << 1) | 1, 0, I2C_IF_RXDATAV);
+	}
+}
+
+#elif I2C_TRANSFER_MODE == I2C_TRANSFER_MOCK
+
+void I2C_Initialize()
+{
+}
+
+void I2C_MockSetHumidityCode(uint16_t code)
+{
+	mock_humidity_code = code;
+}
+
+void I2C_Write()
+{
+	signalPost(SIGNAL_I2C_DONE); //Transfer completes immediately
+}
+
+void I2C_Read()
+{
+	read_data[0] = mock_humidity_code >> 8;
+	read_data[1] = mock_humidity_code & 0xFF;
+	signalPost(SIGNAL_I2C_DONE); //Transfer completes immediately
+}
+
+#endif
+
 void Get_Humidity()
 {
-//	LOG_INFO("read_data[0] = %d",read_data[0]);
-//	LOG_INFO("read_data[1] = %d",read_data[1]);
-	Received_Data = (read_data[0]<<8) + read_data[1]; //To store the temperature sensed in one Word
-//	LOG_INFO("Received data = %f",Received_Data);
-	Received_Data = (((125 * Received_Data)/65536) - 6); //Calculation for temperature in degree Celsius
-	LOG_INFO("Humidity = %f",Received_Data);
+	Received_Data = fixedHumidityFromCode((read_data[0]<<8) + read_data[1]);
+	LOG_INFO("Humidity = %"PRId32" (0.01 %%RH)", Received_Data);
+	journalAppend(JOURNAL_HUMIDITY, JOURNAL_ADDRESS_LOCAL, Received_Data, 0);
+	telemetrySet(TELEMETRY_HUMIDITY, Received_Data);
 }
 
 
 void Hum_Buffer()
 {
-	char HumBufferChar[32]={0};
-	snprintf(HumBufferChar, sizeof (HumBufferChar), "%.2f", Received_Data);
-	displayPrintf(DISPLAY_ROW_HUMIDITY,HumBufferChar);
-
+	char HumBufferChar[FIXED_FORMAT_LEN];
+	displayPrintf(DISPLAY_ROW_HUMIDITY, "%s", fixedFormat(HumBufferChar, sizeof(HumBufferChar), Received_Data));
 }
 
+#if I2C_TRANSFER_MODE == I2C_TRANSFER_IRQ
 void I2C0_IRQHandler()
 {
 	I2C_TransferReturn_TypeDef interrupt = I2C_Transfer(I2C0);
@@ -98,18 +198,45 @@ void I2C0_IRQHandler()
 	if(interrupt != i2cTransferInProgress)
 	{
 
-		if(eNextState == READ_COMPLETE)
+		signalPost(SIGNAL_I2C_DONE); //Setting signal event for next state
+
+//		LOG_INFO("WRITE SUCCESS");
+	}
+}
+#elif I2C_TRANSFER_MODE == I2C_TRANSFER_LDMA
+void I2C0_IRQHandler()
+{
+	uint32_t flags = I2C0->IF & I2C0->IEN;
+	I2C0->IFC = flags;
+
+	if(flags & I2C_ERROR_FLAGS)
+	{
+		i2c_error_count++;
+		ldmaStopTransfer(LDMA_CHANNEL_I2C0_TX);
+		ldmaStopTransfer(LDMA_CHANNEL_I2C0_RX);
+		if(flags & I2C_IF_NACK)
 		{
-			gecko_external_signal(0x06); //Setting signal event for next state
+			I2C0->CMD = I2C_CMD_STOP; //Transfer ends on MSTOP
 		}
-		else if(eNextState == WRITE_COMPLETE)
+		else
 		{
-			gecko_external_signal(0x04); //Setting signal event for next state
+			I2C0->CMD = I2C_CMD_ABORT; //Bus lost, no STOP will follow
+			I2C_TransferDone();
+			return;
 		}
-
-//		LOG_INFO("WRITE SUCCESS");
+	}
+	if(flags & I2C_IF_RXDATAV)
+	{
+		read_data[read_len - 1] = I2C0->RXDATA;
+		I2C0->CMD = I2C_CMD_NACK | I2C_CMD_STOP;
+		I2C0->IEN &= ~I2C_IF_RXDATAV;
+	}
+	if(flags & I2C_IF_MSTOP)
+	{
+		I2C_TransferDone();
 	}
 }
+#endif
 
 
 
@@ -23,7 +23,26 @@
 #define I2C_COMPLETE 2
 #define I2C_FAIL 1
 
-extern float Received_Data;
+/*
+ * Transfer modes behind I2C_Write()/I2C_Read()
+ * I2C_TRANSFER_IRQ  - emlib I2C_Transfer() state machine, one interrupt per bus event
+ * I2C_TRANSFER_LDMA - LDMA moves the bytes, one MSTOP interrupt per write and
+ * 					   LDMA done, last byte and MSTOP interrupts per read
+ * I2C_TRANSFER_MOCK - no bus access, transfers complete immediately with a canned
+ * 					   humidity code so the state machine runs without the sensor
+ */
+#define I2C_TRANSFER_IRQ	0
+#define I2C_TRANSFER_LDMA	1
+#define I2C_TRANSFER_MOCK	2
+
+#ifndef I2C_TRANSFER_MODE
+#define I2C_TRANSFER_MODE	I2C_TRANSFER_LDMA
+#endif
+
+#define I2C_MOCK_HUMIDITY_CODE	0x7C80	//54.8 %RH
+
+extern int32_t Received_Data;
+extern uint32_t i2c_error_count;
 
 /*******************************************************************************
  **************************    FUNCTION PROTOTYPES    **************************
@@ -67,9 +86,10 @@ void I2C_Read(void);
 void I2C0_IRQHandler(void);
 
 /**************************************************************************//**
- * @brief   Calculates the temperature
+ * @brief   Calculates the relative humidity
  *
- * @detail  This function initializes read from I2C and calculates the temperature
+ * @detail  Converts the code read from the Si7021 into Received_Data, in
+ * 			hundredths of %RH
  *
  * @return  Void
  *****************************************************************************/
@@ -77,4 +97,13 @@ void Get_Humidity(void);
 
 void Hum_Buffer(void);
 
+#if I2C_TRANSFER_MODE == I2C_TRANSFER_MOCK
+/**************************************************************************//**
+ * @brief   Set the humidity code returned by the mock sensor
+ *
+ * @return  Void
+ *****************************************************************************/
+void I2C_MockSetHumidityCode(uint16_t code);
+#endif
+
 #endif /* SRC_I2C_H_ */
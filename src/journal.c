@@ -0,0 +1,473 @@
+/*
+ * @filename	: journal.c
+ * @description	: This file contains the source code for the flash journal
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ */
+
+#include "journal.h"
+#include "journal_flash.h"
+#include "timebase.h"
+#include "log.h"
+#include <stddef.h>
+#include <string.h>
+
+#define JOURNAL_MAGIC			0x4C4E524AUL	//"JRNL"
+#define JOURNAL_SLOTS			(JOURNAL_SECTOR_SIZE / JOURNAL_RECORD_SIZE)	//Header slot included
+#define JOURNAL_SLOT_OFFSET(sector, slot)	(((uint32_t)(sector) * JOURNAL_SECTOR_SIZE) + ((uint32_t)(slot) * JOURNAL_RECORD_SIZE))
+
+#define JOURNAL_SEQUENCE_RESERVED	0xFFFFFFFFUL	//Sequence of a header not programmed yet
+
+/*
+ * Slot 0 of every sector.  Erasing a sector ahead of the head programs magic
+ * and erase_count only, leaving sequence and sequence_inv erased, which is no
+ * valid header.  The head programs the whole header over it when it enters.
+ */
+typedef struct
+{
+	uint32_t magic;
+	uint32_t sequence;			//One more than the sector written before it
+	uint32_t erase_count;		//Erases of this sector, carried over each erase
+	uint32_t sequence_inv;		//~sequence, a header torn by a reset is not valid
+}journal_header_t;
+
+typedef char journal_header_size_check[(sizeof(journal_header_t) == JOURNAL_RECORD_SIZE) ? 1 : -1];
+typedef char journal_geometry_check[((JOURNAL_SECTOR_COUNT >= 2) && (JOURNAL_SECTOR_COUNT <= UINT16_MAX) &&
+									 ((JOURNAL_FLASH_SIZE % JOURNAL_SECTOR_SIZE) == 0)) ? 1 : -1];
+
+static uint16_t journal_head;				//Sector being written
+static uint32_t journal_head_sequence;
+static uint16_t journal_head_slot;			//First slot of the head sector not programmed yet
+static uint16_t journal_tail;				//Oldest sector
+static uint16_t journal_sectors = 0;		//Sectors holding records, tail to head
+static bool journal_ahead_erased = false;	//Sector after the head is erased
+static uint32_t journal_ahead_erase_count;	//Erase count for the header of that sector
+static journal_record_t journal_stage[JOURNAL_RECORDS_PER_PAGE];	//Records for the rest of the head page
+static uint8_t journal_staged = 0;
+static uint32_t journal_stage_ms;			//timebaseGetMs() of the first staged record
+static bool journal_ready = false;
+
+/* CRC-8, polynomial 0x07, of the record bytes before check */
+static uint8_t journalCheck(const journal_record_t *record)
+{
+	const uint8_t *data = (const uint8_t *)record;
+	uint8_t crc = 0;
+	uint8_t i, bit;
+
+	for(i = 0; i < offsetof(journal_record_t, check); i++)
+	{
+		crc ^= data[i];
+		for(bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+		}
+	}
+	return crc;
+}
+
+static bool journalRecordValid(const journal_record_t *record)
+{
+	return (record->type != JOURNAL_TYPE_EMPTY) && (record->check == journalCheck(record));
+}
+
+static bool journalSlotErased(uint16_t sector, uint16_t slot)
+{
+	uint8_t data[JOURNAL_RECORD_SIZE];
+	uint8_t i;
+
+	journalFlashRead(JOURNAL_SLOT_OFFSET(sector, slot), data, sizeof(data));
+	for(i = 0; i < sizeof(data); i++)
+	{
+		if(data[i] != 0xFF)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool journalHeaderRead(uint16_t sector, journal_header_t *header)
+{
+	return journalFlashRead(JOURNAL_SLOT_OFFSET(sector, 0), header, sizeof(*header)) &&
+		   (header->magic == JOURNAL_MAGIC) && (header->sequence_inv == ~header->sequence);
+}
+
+/* Header of a sector erased ahead of the head, not entered yet */
+static bool journalHeaderReserved(uint16_t sector, journal_header_t *header)
+{
+	return journalFlashRead(JOURNAL_SLOT_OFFSET(sector, 0), header, sizeof(*header)) &&
+		   (header->magic == JOURNAL_MAGIC) && (header->sequence == JOURNAL_SEQUENCE_RESERVED) &&
+		   (header->sequence_inv == JOURNAL_SEQUENCE_RESERVED);
+}
+
+/* All record slots of a sector are erased */
+static bool journalRecordsErased(uint16_t sector)
+{
+	uint16_t slot;
+
+	for(slot = 1; slot < JOURNAL_SLOTS; slot++)
+	{
+		if(!journalSlotErased(sector, slot))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Keep the erase count of a sector erased ahead of the head in flash.  Flash session must be open. */
+static void journalReserve(uint16_t sector, uint32_t erase_count)
+{
+	journal_header_t header;
+
+	header.magic = JOURNAL_MAGIC;
+	header.sequence = JOURNAL_SEQUENCE_RESERVED;
+	header.erase_count = erase_count;
+	header.sequence_inv = JOURNAL_SEQUENCE_RESERVED;
+	if(!journalFlashProgram(JOURNAL_SLOT_OFFSET(sector, 0), &header, sizeof(header)))
+	{
+		LOG_ERROR("Journal sector %d reserve failed", sector);
+	}
+	journal_ahead_erased = true;
+	journal_ahead_erase_count = erase_count;
+}
+
+static uint32_t journalSectorSequence(uint16_t sector)
+{
+	return journal_head_sequence - ((journal_head + JOURNAL_SECTOR_COUNT - sector) % JOURNAL_SECTOR_COUNT);
+}
+
+/*
+ * Erase a sector, dropping its records if it holds the oldest ones.
+ * Returns the erase count to write in its header.  Flash session must be open.
+ */
+static uint32_t journalEraseSector(uint16_t sector)
+{
+	journal_header_t header;
+	uint32_t erase_count = 1;
+
+	if(journalHeaderRead(sector, &header) || journalHeaderReserved(sector, &header))
+	{
+		erase_count = header.erase_count + 1;
+	}
+	if((journal_sectors != 0) && (sector == journal_tail))
+	{
+		journal_tail = (journal_tail + 1) % JOURNAL_SECTOR_COUNT;
+		journal_sectors--;
+	}
+	if(!journalFlashErase(JOURNAL_SLOT_OFFSET(sector, 0)))
+	{
+		LOG_ERROR("Journal sector %d erase failed", sector);
+	}
+	return erase_count;
+}
+
+/* Move the head to the next sector.  Flash session must be open. */
+static void journalOpenNext(void)
+{
+	journal_header_t header;
+	uint16_t next = (journal_head + 1) % JOURNAL_SECTOR_COUNT;
+
+	header.erase_count = journal_ahead_erased ? journal_ahead_erase_count : journalEraseSector(next);
+	journal_ahead_erased = false;
+	header.magic = JOURNAL_MAGIC;
+	header.sequence = journal_head_sequence + 1;
+	header.sequence_inv = ~header.sequence;
+	if(!journalFlashProgram(JOURNAL_SLOT_OFFSET(next, 0), &header, sizeof(header)))
+	{
+		LOG_ERROR("Journal sector %d header write failed", next);
+	}
+	if(journal_sectors == 0)
+	{
+		journal_tail = next;
+	}
+	journal_sectors++;
+	journal_head = next;
+	journal_head_sequence = header.sequence;
+	journal_head_slot = 1;
+}
+
+/* Program the staged records, they never cross the end of the head page.  Flash session must be open. */
+static void journalProgramStaged(void)
+{
+	if(journal_staged == 0)
+	{
+		return;
+	}
+	if(!journalFlashProgram(JOURNAL_SLOT_OFFSET(journal_head, journal_head_slot), journal_stage,
+							journal_staged * JOURNAL_RECORD_SIZE))
+	{
+		LOG_ERROR("Journal program of %d records failed", journal_staged);	//Slots are skipped as torn
+	}
+	journal_head_slot += journal_staged;
+	journal_staged = 0;
+	if(journal_head_slot >= JOURNAL_SLOTS)
+	{
+		journalOpenNext();
+	}
+}
+
+/* Staged records reach the end of the head page */
+static bool journalStageFull(void)
+{
+	return (journal_staged != 0) && (((journal_head_slot + journal_staged) % JOURNAL_RECORDS_PER_PAGE) == 0);
+}
+
+void journalInit(void)
+{
+	journal_header_t header;
+	uint32_t tail_sequence = UINT32_MAX;
+	uint32_t head_erase_count = 0;
+	uint16_t sector, ahead, low, high, mid;
+	bool found = false;
+
+	journal_staged = 0;
+	journal_ahead_erased = false;
+	journalFlashBegin();
+	for(sector = 0; sector < JOURNAL_SECTOR_COUNT; sector++)
+	{
+		if(!journalHeaderRead(sector, &header))
+		{
+			continue;
+		}
+		if(!found || (header.sequence > journal_head_sequence))
+		{
+			journal_head = sector;
+			journal_head_sequence = header.sequence;
+			head_erase_count = header.erase_count;
+		}
+		if(header.sequence < tail_sequence)
+		{
+			journal_tail = sector;
+			tail_sequence = header.sequence;
+		}
+		found = true;
+	}
+
+	if(!found)
+	{
+		LOG_INFO("Journal empty, formatting");
+		journal_head = JOURNAL_SECTOR_COUNT - 1;
+		journal_head_sequence = 0;
+		journal_sectors = 0;
+		journalOpenNext();
+	}
+	else
+	{
+		journal_sectors = (uint16_t)(journal_head_sequence - tail_sequence + 1);
+		/* Records are programmed in slot order, find the first erased slot */
+		low = 1;
+		high = JOURNAL_SLOTS;
+		while(low < high)
+		{
+			mid = (low + high) / 2;
+			if(journalSlotErased(journal_head, mid))
+			{
+				high = mid;
+			}
+			else
+			{
+				low = mid + 1;
+			}
+		}
+		journal_head_slot = low;
+
+		/* Sector erased ahead before the reset, a blank one gets the count of the lap of the head */
+		ahead = (journal_head + 1) % JOURNAL_SECTOR_COUNT;
+		if((journal_sectors < JOURNAL_SECTOR_COUNT) && journalRecordsErased(ahead))
+		{
+			if(journalHeaderReserved(ahead, &header))
+			{
+				journal_ahead_erased = true;
+				journal_ahead_erase_count = header.erase_count;
+			}
+			else if(journalSlotErased(ahead, 0))
+			{
+				journalReserve(ahead, head_erase_count + ((ahead == 0) ? 1 : 0));
+			}
+		}
+		if(journal_head_slot >= JOURNAL_SLOTS)
+		{
+			journalOpenNext();
+		}
+	}
+	journalFlashEnd();
+	journal_ready = true;
+	LOG_INFO("Journal: %d sectors, head %d slot %d", journal_sectors, journal_head, journal_head_slot);
+	journalAppend(JOURNAL_BOOT, JOURNAL_ADDRESS_LOCAL, 0, 0);
+}
+
+void journalAppend(eJournalType type, uint16_t address, int32_t value, int32_t aux)
+{
+	journal_record_t *record;
+
+	if(!journal_ready)
+	{
+		return;
+	}
+	if(journalStageFull())
+	{
+		journalFlush(); //More records than fit the page arrived without an idle window
+	}
+	record = &journal_stage[journal_staged];
+	record->timestamp_ms = (uint32_t)timebaseGetMs();
+	record->value = value;
+	record->aux = aux;
+	record->address = address;
+	record->type = (uint8_t)type;
+	record->check = journalCheck(record);
+	if(journal_staged++ == 0)
+	{
+		journal_stage_ms = record->timestamp_ms;
+	}
+}
+
+void journalFlush(void)
+{
+	if(!journal_ready || (journal_staged == 0))
+	{
+		return;
+	}
+	journalFlashBegin();
+	journalProgramStaged();
+	journalFlashEnd();
+}
+
+void journalIdle(void)
+{
+	uint16_t sector;
+
+	if(!journal_ready)
+	{
+		return;
+	}
+	if(journalStageFull() ||
+	   ((journal_staged != 0) && (((uint32_t)timebaseGetMs() - journal_stage_ms) >= JOURNAL_FLUSH_DELAY_MS)))
+	{
+		journalFlush();
+	}
+	if(!journal_ahead_erased)
+	{
+		journalFlashBegin();
+		sector = (journal_head + 1) % JOURNAL_SECTOR_COUNT;
+		journalReserve(sector, journalEraseSector(sector));
+		journalFlashEnd();
+	}
+}
+
+void journalCursorOldest(journal_cursor_t *cursor)
+{
+	cursor->sector = journal_tail;
+	cursor->slot = 1;
+	cursor->sequence = journalSectorSequence(journal_tail);
+}
+
+uint32_t journalCursorPosition(const journal_cursor_t *cursor)
+{
+	if(cursor->slot >= JOURNAL_SLOTS)
+	{
+		return ((cursor->sequence + 1) * JOURNAL_SLOTS) + 1;
+	}
+	return (cursor->sequence * JOURNAL_SLOTS) + cursor->slot;
+}
+
+void journalCursorSeek(journal_cursor_t *cursor, uint32_t position)
+{
+	uint32_t sequence = position / JOURNAL_SLOTS;
+	uint16_t slot = (uint16_t)(position % JOURNAL_SLOTS);
+
+	if(slot == 0)
+	{
+		slot = 1;
+	}
+	if((sequence == journal_head_sequence + 1) && (slot == 1))
+	{
+		/* End of a full head sector, the next sector is not opened until its first record */
+		sequence = journal_head_sequence;
+		slot = JOURNAL_SLOTS;
+	}
+	if(!journal_ready || (journal_sectors == 0) ||
+	   (sequence > journal_head_sequence) || (sequence < journalSectorSequence(journal_tail)))
+	{
+		journalCursorOldest(cursor);
+		return;
+	}
+	cursor->sector = (uint16_t)((journal_head + JOURNAL_SECTOR_COUNT - (journal_head_sequence - sequence)) % JOURNAL_SECTOR_COUNT);
+	cursor->slot = slot;
+	cursor->sequence = sequence;
+}
+
+uint16_t journalRead(journal_cursor_t *cursor, journal_record_t *records, uint16_t max)
+{
+	uint16_t count = 0;
+	uint16_t batch, kept, i;
+	bool session = false;
+
+	if(!journal_ready)
+	{
+		return 0;
+	}
+	if((cursor->sequence > journal_head_sequence) ||
+	   (cursor->sequence < journalSectorSequence(journal_tail)))
+	{
+		journalCursorOldest(cursor); //Sector under the cursor was recycled
+	}
+	while(count < max)
+	{
+		if((cursor->sequence == journal_head_sequence) && (cursor->slot >= journal_head_slot))
+		{
+			/* Past the programmed records, continue with the staged ones */
+			i = cursor->slot - journal_head_slot;
+			if(i >= journal_staged)
+			{
+				break;
+			}
+			records[count++] = journal_stage[i];
+			cursor->slot++;
+			continue;
+		}
+		if(cursor->slot >= JOURNAL_SLOTS)
+		{
+			cursor->sector = (cursor->sector + 1) % JOURNAL_SECTOR_COUNT;
+			cursor->sequence++;
+			cursor->slot = 1;
+			continue;
+		}
+		batch = ((cursor->sequence == journal_head_sequence) ? journal_head_slot : JOURNAL_SLOTS) - cursor->slot;
+		if(batch > (max - count))
+		{
+			batch = max - count;
+		}
+		if(!session)
+		{
+			journalFlashBegin();
+			session = true;
+		}
+		journalFlashRead(JOURNAL_SLOT_OFFSET(cursor->sector, cursor->slot), &records[count], batch * JOURNAL_RECORD_SIZE);
+		cursor->slot += batch;
+		kept = 0;
+		for(i = 0; i < batch; i++)
+		{
+			if(journalRecordValid(&records[count + i])) //Torn records are dropped
+			{
+				records[count + kept++] = records[count + i];
+			}
+		}
+		count += kept;
+	}
+	if(session)
+	{
+		journalFlashEnd();
+	}
+	return count;
+}
+
+uint32_t journalCount(void)
+{
+	if(journal_sectors == 0)
+	{
+		return journal_staged;
+	}
+	return ((uint32_t)(journal_sectors - 1) * JOURNAL_RECORDS_PER_SECTOR) + (journal_head_slot - 1) + journal_staged;
+}
@@ -0,0 +1,181 @@
+/*
+ * @filename	: journal.h
+ * @description	: This file contains header files for journal.c
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Append only journal of alerts, sensor readings and occupancy changes on the
+ * MX25 SPI flash.  The journal region is a circle of 4K sectors written in
+ * order, so every sector is erased once per lap and wear is level across the
+ * region.  Each sector starts with a header slot holding its sequence number
+ * and erase count, followed by fixed size records.
+ *
+ * Records are staged in RAM and programmed with one page program per flash page
+ * by journalIdle(), once the staged records reach the end of the page or the
+ * oldest is JOURNAL_FLUSH_DELAY_MS old, or by journalFlush().  When the head
+ * enters a sector, journalIdle() also erases the sector after it, dropping the
+ * oldest sector of records once the region is full, and programs the erase
+ * count of its header right away so a reset does not lose it.  The rest of
+ * the header is programmed when the head enters the sector.  Flash is only
+ * accessed on the event path if a page fills up without an idle window in
+ * between.
+ */
+
+#ifndef SRC_JOURNAL_H_
+#define SRC_JOURNAL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ ********************************  DEFINES  ************************************
+ ******************************************************************************/
+
+/* Journal region of the MX25, the lower half is left free for a bootloader storage slot */
+#ifndef JOURNAL_FLASH_BASE
+#define JOURNAL_FLASH_BASE			0x80000
+#endif
+#ifndef JOURNAL_FLASH_SIZE
+#define JOURNAL_FLASH_SIZE			0x80000
+#endif
+#define JOURNAL_SECTOR_SIZE			0x1000		//MX25 sector erase granularity
+#define JOURNAL_PAGE_SIZE			0x100		//MX25 page program granularity
+#define JOURNAL_SECTOR_COUNT		(JOURNAL_FLASH_SIZE / JOURNAL_SECTOR_SIZE)
+#define JOURNAL_RECORD_SIZE			16
+#define JOURNAL_RECORDS_PER_PAGE	(JOURNAL_PAGE_SIZE / JOURNAL_RECORD_SIZE)
+#define JOURNAL_RECORDS_PER_SECTOR	((JOURNAL_SECTOR_SIZE / JOURNAL_RECORD_SIZE) - 1)	//Less the header slot
+#define JOURNAL_FLUSH_DELAY_MS		30000		//Longest time a record stays in RAM only
+
+#define JOURNAL_ADDRESS_LOCAL		0x0000		//Record from a sensor of this node
+
+typedef enum
+{
+	JOURNAL_BOOT = 0,			//Node started, value unused
+	JOURNAL_TEMPERATURE,		//value: hundredths of a degree Celsius
+	JOURNAL_ACCELERATION,		//value: raw accelerometer level
+	JOURNAL_DISTANCE,			//value: ultrasonic distance, in hundredths
+	JOURNAL_HUMIDITY,			//value: hundredths of %RH
+	JOURNAL_ALERT_FEVER,		//value: temperature that raised the alert
+	JOURNAL_ALERT_FAINT,		//value: accelerometer level that raised the alert
+	JOURNAL_INTRUSION,			//Motion without a caretaker present
+	JOURNAL_ALERTS_CLEARED,		//value: alerts cleared count
+	JOURNAL_OCCUPANCY,			//value: 1 caretaker entered, 0 caretaker left
+	JOURNAL_FRIENDSHIP,			//value: 1 established, 0 terminated with the reason in aux
+	JOURNAL_TYPE_EMPTY = 0xFF	//Erased record slot
+}eJournalType;
+
+typedef struct
+{
+	uint32_t timestamp_ms;		//timebaseGetMs(), JOURNAL_BOOT records separate the boots
+	int32_t value;
+	int32_t aux;				//Second value of the record type, 0 if unused
+	uint16_t address;			//Unicast address of the LPN, JOURNAL_ADDRESS_LOCAL for this node
+	uint8_t type;				//eJournalType
+	uint8_t check;				//CRC-8 of the other bytes, detects records torn by a reset
+}journal_record_t;
+
+typedef char journal_record_size_check[(sizeof(journal_record_t) == JOURNAL_RECORD_SIZE) ? 1 : -1];
+
+/* Position of a reader, from journalCursorOldest() */
+typedef struct
+{
+	uint16_t sector;
+	uint16_t slot;				//Record slot in the sector, 1 is the first after the header
+	uint32_t sequence;			//Sequence number of sector, detects sectors recycled under the reader
+}journal_cursor_t;
+
+/*******************************************************************************
+ **************************    FUNCTION PROTOTYPES    **************************
+ ******************************************************************************/
+
+/**************************************************************************//**
+ * @brief   Find the head and tail of the journal and append a boot record
+ *
+ * @detail  Reads the header of every sector.  A region without a valid
+ * 			sector is formatted by erasing its first sector.  A sector after
+ * 			the head that was erased ahead is not erased again
+ *
+ * @return  Void
+ *****************************************************************************/
+void journalInit(void);
+
+/**************************************************************************//**
+ * @brief   Append a record
+ *
+ * @detail  Only copies the record to RAM, unless the staged records already
+ * 			fill their flash page.  Must not be called from an interrupt
+ *
+ * @return  Void
+ *****************************************************************************/
+void journalAppend(eJournalType type, uint16_t address, int32_t value, int32_t aux);
+
+/**************************************************************************//**
+ * @brief   Program all staged records
+ *
+ * @detail  Call before any reset
+ *
+ * @return  Void
+ *****************************************************************************/
+void journalFlush(void);
+
+/**************************************************************************//**
+ * @brief   Idle work of the journal
+ *
+ * @detail  Programs the staged records when they fill their page or are
+ * 			JOURNAL_FLUSH_DELAY_MS old, and erases the sector after the head.  Call from the main loop only when no
+ * 			stack event is pending, a sector erase blocks for tens of ms
+ *
+ * @return  Void
+ *****************************************************************************/
+void journalIdle(void);
+
+/**************************************************************************//**
+ * @brief   Point a cursor at the oldest record
+ *
+ * @return  Void
+ *****************************************************************************/
+void journalCursorOldest(journal_cursor_t *cursor);
+
+/**************************************************************************//**
+ * @brief   Position of a cursor as one number, for a reader to store
+ *
+ * @detail  sequence * (JOURNAL_RECORDS_PER_SECTOR + 1) + slot.  Positions grow
+ * 			with the records, a cursor at the end of a sector has the position
+ * 			of the first record of the next one
+ *
+ * @return  Position
+ *****************************************************************************/
+uint32_t journalCursorPosition(const journal_cursor_t *cursor);
+
+/**************************************************************************//**
+ * @brief   Point a cursor at a position from journalCursorPosition()
+ *
+ * @detail  A position whose sector was recycled, or that is past the newest
+ * 			record, points the cursor at the oldest record
+ *
+ * @return  Void
+ *****************************************************************************/
+void journalCursorSeek(journal_cursor_t *cursor, uint32_t position);
+
+/**************************************************************************//**
+ * @brief   Read the next records at a cursor and advance it
+ *
+ * @detail  Staged records are returned after the programmed ones.  Torn
+ * 			records are skipped.  If the sector under the cursor was recycled
+ * 			the cursor moves to the oldest record
+ *
+ * @return  Number of records copied to records, 0 at the end of the journal
+ *****************************************************************************/
+uint16_t journalRead(journal_cursor_t *cursor, journal_record_t *records, uint16_t max);
+
+/**************************************************************************//**
+ * @brief   Number of records in the journal, staged ones included
+ *
+ * @detail  Slots torn by a reset are counted, journalRead() skips them
+ *
+ * @return  Record count
+ *****************************************************************************/
+uint32_t journalCount(void);
+
+#endif /* SRC_JOURNAL_H_ */
@@ -0,0 +1,77 @@
+/*
+ * @filename	: journal_flash.h
+ * @description	: This file contains the flash access used by journal.c
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Addresses are offsets into the journal region.  journal_flash_mx25.c drives
+ * the MX25 on the board.  Building with JOURNAL_FLASH_SIM defined selects
+ * journal_flash_sim.c instead, a RAM image with the same program and erase
+ * rules, so the journal can be run and tested on a Linux host, see
+ * host/journal_test.c for the simulator hooks at the end.
+ */
+
+#ifndef SRC_JOURNAL_FLASH_H_
+#define SRC_JOURNAL_FLASH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ **************************    FUNCTION PROTOTYPES    **************************
+ ******************************************************************************/
+
+/**************************************************************************//**
+ * @brief   Power up the flash and take its SPI bus
+ *
+ * @detail  Every other call must be between journalFlashBegin() and
+ * 			journalFlashEnd()
+ *
+ * @return  Void
+ *****************************************************************************/
+void journalFlashBegin(void);
+
+/**************************************************************************//**
+ * @brief   Put the flash in deep power down and give back its SPI bus
+ *
+ * @return  Void
+ *****************************************************************************/
+void journalFlashEnd(void);
+
+/**************************************************************************//**
+ * @brief   Read len bytes at offset
+ *
+ * @return  true on success
+ *****************************************************************************/
+bool journalFlashRead(uint32_t offset, void *data, uint32_t len);
+
+/**************************************************************************//**
+ * @brief   Program len bytes at offset
+ *
+ * @detail  The bytes must not cross a JOURNAL_PAGE_SIZE boundary.  Programming
+ * 			can only clear bits, the bytes must be erased first
+ *
+ * @return  true on success
+ *****************************************************************************/
+bool journalFlashProgram(uint32_t offset, const void *data, uint32_t len);
+
+/**************************************************************************//**
+ * @brief   Erase the JOURNAL_SECTOR_SIZE sector at offset to 0xFF
+ *
+ * @return  true on success
+ *****************************************************************************/
+bool journalFlashErase(uint32_t offset);
+
+#if defined(JOURNAL_FLASH_SIM)
+/* Simulator only: erase the whole image and clear the statistics */
+void journalFlashSimReset(void);
+/* Simulator only: erases of a sector since journalFlashSimReset() */
+uint32_t journalFlashSimEraseCount(uint16_t sector);
+/* Simulator only: page programs since journalFlashSimReset() */
+uint32_t journalFlashSimProgramCount(void);
+/* Simulator only: stop programming after bytes more bytes, as a reset in the middle of a program would */
+void journalFlashSimFailAfter(uint32_t bytes);
+#endif
+
+#endif /* SRC_JOURNAL_FLASH_H_ */
@@ -0,0 +1,64 @@
+/*
+ * @filename	: journal_flash_mx25.c
+ * @description	: This file contains the MX25 SPI flash access for journal.c
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * The MX25 shares USART1 with the memory LCD.  MX25_init() reconfigures the
+ * USART for the flash and MX25_deinit() resets it, so the display SPI is set up
+ * again at the end of every session.  Both are only used from the main loop.
+ */
+
+#if !defined(JOURNAL_FLASH_SIM)
+
+#include "journal_flash.h"
+#include "journal.h"
+#include "display.h"
+#include "mx25flash_spi.h"
+#if ECEN5823_INCLUDE_DISPLAY_SUPPORT
+#include "displaypal.h"
+#endif
+
+#define MX25_WAKE_POLLS	100		//RDID polls waiting for tRES1 after the release from deep power down
+
+void journalFlashBegin(void)
+{
+	uint8_t electronic_id;
+	uint32_t id = 0;
+	uint8_t polls;
+
+	MX25_init();
+	MX25_RES(&electronic_id); //Release from the deep power down initBoard() left it in
+	/* RDID is ignored until the flash is awake */
+	for(polls = 0; (polls < MX25_WAKE_POLLS) && (id != FlashID); polls++)
+	{
+		MX25_RDID(&id);
+	}
+}
+
+void journalFlashEnd(void)
+{
+	MX25_DP();
+	MX25_deinit();
+#if ECEN5823_INCLUDE_DISPLAY_SUPPORT
+	PAL_SpiInit();
+#endif
+}
+
+bool journalFlashRead(uint32_t offset, void *data, uint32_t len)
+{
+	return MX25_READ(JOURNAL_FLASH_BASE + offset, data, len) == FlashOperationSuccess;
+}
+
+bool journalFlashProgram(uint32_t offset, const void *data, uint32_t len)
+{
+	return MX25_PP(JOURNAL_FLASH_BASE + offset, (uint8_t *)data, len) == FlashOperationSuccess;
+}
+
+bool journalFlashErase(uint32_t offset)
+{
+	return MX25_SE(JOURNAL_FLASH_BASE + offset) == FlashOperationSuccess;
+}
+
+#endif /* !JOURNAL_FLASH_SIM */
@@ -0,0 +1,108 @@
+/*
+ * @filename	: journal_flash_sim.c
+ * @description	: This file contains the RAM flash simulator for journal.c
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Models the MX25 rules the journal depends on: programming only clears bits,
+ * a page program wraps at the end of the page, and erasing sets a whole sector
+ * to 0xFF.  Accesses outside a begin/end session or the region fail.
+ */
+
+#if defined(JOURNAL_FLASH_SIM)
+
+#include "journal_flash.h"
+#include "journal.h"
+#include <string.h>
+
+static uint8_t sim_image[JOURNAL_FLASH_SIZE];
+static uint32_t sim_erase_count[JOURNAL_SECTOR_COUNT];
+static uint32_t sim_program_count = 0;
+static uint32_t sim_fail_after = UINT32_MAX;	//Bytes programmed before the simulated reset
+static bool sim_session = false;
+
+void journalFlashSimReset(void)
+{
+	memset(sim_image, 0xFF, sizeof(sim_image));
+	memset(sim_erase_count, 0, sizeof(sim_erase_count));
+	sim_program_count = 0;
+	sim_fail_after = UINT32_MAX;
+	sim_session = false;
+}
+
+uint32_t journalFlashSimEraseCount(uint16_t sector)
+{
+	return (sector < JOURNAL_SECTOR_COUNT) ? sim_erase_count[sector] : 0;
+}
+
+uint32_t journalFlashSimProgramCount(void)
+{
+	return sim_program_count;
+}
+
+void journalFlashSimFailAfter(uint32_t bytes)
+{
+	sim_fail_after = bytes;
+}
+
+void journalFlashBegin(void)
+{
+	sim_session = true;
+}
+
+void journalFlashEnd(void)
+{
+	sim_session = false;
+}
+
+bool journalFlashRead(uint32_t offset, void *data, uint32_t len)
+{
+	if(!sim_session || (offset > JOURNAL_FLASH_SIZE) || (len > (JOURNAL_FLASH_SIZE - offset)))
+	{
+		return false;
+	}
+	memcpy(data, &sim_image[offset], len);
+	return true;
+}
+
+bool journalFlashProgram(uint32_t offset, const void *data, uint32_t len)
+{
+	const uint8_t *bytes = data;
+	uint32_t page = offset & ~(uint32_t)(JOURNAL_PAGE_SIZE - 1);
+	uint32_t i;
+
+	if(!sim_session || (offset >= JOURNAL_FLASH_SIZE) || (len > JOURNAL_PAGE_SIZE))
+	{
+		return false;
+	}
+	sim_program_count++;
+	for(i = 0; i < len; i++)
+	{
+		if(sim_fail_after == 0)
+		{
+			return false;
+		}
+		if(sim_fail_after != UINT32_MAX)
+		{
+			sim_fail_after--;
+		}
+		/* Like the MX25, the address wraps to the start of the page */
+		sim_image[page + ((offset + i) & (JOURNAL_PAGE_SIZE - 1))] &= bytes[i];
+	}
+	return true;
+}
+
+bool journalFlashErase(uint32_t offset)
+{
+	if(!sim_session || (offset >= JOURNAL_FLASH_SIZE))
+	{
+		return false;
+	}
+	offset &= ~(uint32_t)(JOURNAL_SECTOR_SIZE - 1);
+	memset(&sim_image[offset], 0xFF, JOURNAL_SECTOR_SIZE);
+	sim_erase_count[offset / JOURNAL_SECTOR_SIZE]++;
+	return true;
+}
+
+#endif /* JOURNAL_FLASH_SIM */
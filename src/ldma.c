@@ -0,0 +1,110 @@
+/*
+ * @filename	: ldma.c
+ * @description	: This file contains the source code for peripheral LDMA transfers
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ * 				  EFR32xG13 Reference Manual, LDMA chapter
+ */
+
+#include "ldma.h"
+#include "main.h"
+
+static ldma_callback_t ldma_callbacks[LDMA_CHANNEL_COUNT];
+uint32_t ldma_error_count = 0;
+
+void ldmaInit(void)
+{
+	CMU_ClockEnable(cmuClock_LDMA, true);
+	LDMA->CTRL = 0; //All channels fixed priority, no synchronization
+	LDMA->CHEN = 0;
+	LDMA->REQDIS = 0;
+	LDMA->IEN = LDMA_IF_ERROR;
+	LDMA->IFC = 0xFFFFFFFF;
+	NVIC_ClearPendingIRQ(LDMA_IRQn);
+	NVIC_EnableIRQ(LDMA_IRQn);
+}
+
+void ldmaStartTransfer(uint8_t channel, uint32_t reqsel, volatile const void *src,
+					   volatile void *dst, uint16_t len, uint32_t inc, ldma_callback_t callback)
+{
+	uint32_t mask = 1UL << channel;
+
+	if((channel >= LDMA_CHANNEL_COUNT) || (len == 0))
+	{
+		return;
+	}
+	LDMA->CHEN &= ~mask; //Channel must be stopped while it is reconfigured
+	ldma_callbacks[channel] = callback;
+
+	LDMA->CH[channel].REQSEL = reqsel;
+	LDMA->CH[channel].CFG = 0;
+	LDMA->CH[channel].LOOP = 0;
+	LDMA->CH[channel].SRC = (uint32_t)src;
+	LDMA->CH[channel].DST = (uint32_t)dst;
+	LDMA->CH[channel].LINK = 0;
+	LDMA->CH[channel].CTRL = LDMA_CH_CTRL_STRUCTTYPE_TRANSFER
+							 | ((uint32_t)(len - 1) << _LDMA_CH_CTRL_XFERCNT_SHIFT)
+							 | LDMA_CH_CTRL_BLOCKSIZE_UNIT1
+							 | LDMA_CH_CTRL_REQMODE_BLOCK
+							 | LDMA_CH_CTRL_SIZE_BYTE
+							 | LDMA_CH_CTRL_DONEIFSEN
+							 | inc;
+
+	LDMA->IFC = mask;
+	if(callback != NULL)
+	{
+		LDMA->IEN |= mask;
+	}
+	else
+	{
+		LDMA->IEN &= ~mask;
+	}
+	LDMA->CHDONE &= ~mask;
+	LDMA->CHEN |= mask;
+}
+
+void ldmaStopTransfer(uint8_t channel)
+{
+	uint32_t mask = 1UL << channel;
+
+	if(channel >= LDMA_CHANNEL_COUNT)
+	{
+		return;
+	}
+	LDMA->IEN &= ~mask;
+	LDMA->CHEN &= ~mask;
+	LDMA->IFC = mask;
+	ldma_callbacks[channel] = NULL;
+}
+
+bool ldmaTransferActive(uint8_t channel)
+{
+	uint32_t mask = 1UL << channel;
+
+	return ((LDMA->CHEN & mask) != 0) && ((LDMA->CHDONE & mask) == 0);
+}
+
+void LDMA_IRQHandler(void)
+{
+	uint32_t pending = LDMA->IF & LDMA->IEN;
+	uint8_t channel;
+
+	if(pending & LDMA_IF_ERROR)
+	{
+		LDMA->IFC = LDMA_IF_ERROR;
+		ldma_error_count++;
+	}
+	for(channel = 0; channel < LDMA_CHANNEL_COUNT; channel++)
+	{
+		if(pending & (1UL << channel))
+		{
+			LDMA->IFC = 1UL << channel;
+			LDMA->IEN &= ~(1UL << channel); //One callback per started transfer
+			if(ldma_callbacks[channel] != NULL)
+			{
+				ldma_callbacks[channel]();
+			}
+		}
+	}
+}
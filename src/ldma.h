@@ -0,0 +1,71 @@
+/*
+ * @filename	: ldma.h
+ * @description	: This file contains header files for ldma.c
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ */
+
+#ifndef SRC_LDMA_H_
+#define SRC_LDMA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_device.h"
+
+/*******************************************************************************
+ ********************************  DEFINES  ************************************
+ ******************************************************************************/
+
+/* Channel allocation, one channel per peripheral stream */
+#define LDMA_CHANNEL_I2C0_TX	0
+#define LDMA_CHANNEL_I2C0_RX	1
+#define LDMA_CHANNEL_UART_TX	2
+#define LDMA_CHANNEL_COUNT		3
+
+typedef void (*ldma_callback_t)(void);
+
+extern uint32_t ldma_error_count;
+
+/*******************************************************************************
+ **************************    FUNCTION PROTOTYPES    **************************
+ ******************************************************************************/
+
+/**************************************************************************//**
+ * @brief   Initialize the LDMA
+ *
+ * @detail  Enables the LDMA clock and interrupt with all channels stopped
+ *
+ * @return  Void
+ *****************************************************************************/
+void ldmaInit(void);
+
+/**************************************************************************//**
+ * @brief   Start a byte wide peripheral transfer on a channel
+ *
+ * @detail  Moves len bytes between src and dst, one byte per request from reqsel.
+ * 			Exactly one of src and dst should be a peripheral data register, pass
+ * 			the matching LDMA_CH_CTRL_SRCINC_NONE or LDMA_CH_CTRL_DSTINC_NONE in inc.
+ * 			callback is run from the LDMA interrupt once all bytes are moved, or
+ * 			not at all if NULL.
+ *
+ * @return  Void
+ *****************************************************************************/
+void ldmaStartTransfer(uint8_t channel, uint32_t reqsel, volatile const void *src,
+					   volatile void *dst, uint16_t len, uint32_t inc, ldma_callback_t callback);
+
+/**************************************************************************//**
+ * @brief   Stop a channel
+ *
+ * @return  Void
+ *****************************************************************************/
+void ldmaStopTransfer(uint8_t channel);
+
+/**************************************************************************//**
+ * @brief   Check whether a channel is still moving data
+ *
+ * @return  true while the channel is enabled and has bytes left
+ *****************************************************************************/
+bool ldmaTransferActive(uint8_t channel);
+
+#endif /* SRC_LDMA_H_ */
@@ -7,10 +7,23 @@
  */
 
 #include "letimer.h"
-extern bool interrupt_flag;
+#define TIMER_MIN_TICKS 2	/* Deadlines closer than this expire immediately, COMP1 could miss them */
+
+/* Software timer slot, deadlines are absolute LETIMER0 ticks since it was enabled */
+struct soft_timer
+{
+	bool active;
+	uint32_t deadline;
+	uint32_t period;			/* 0 for one-shot timers */
+	timer_callback_t callback;
+};
+
 /* Global variable declarations */
 uint16_t On_val;
 uint32_t overflow_count = 0;
+static uint32_t letimer_freq;
+static struct soft_timer soft_timers[TIMER_HANDLE_COUNT];
+static volatile uint32_t timers_expired = 0;
 
 /* Function to initialize LETIMER0 */
 void letimer_Init(void)
@@ -40,99 +53,162 @@ void letimer_Init(void)
 /* Function to compute the COMP0 register values for ON and OFF times */
 void compute_CompVal(void)
 {
-	uint32_t clock_freq;
-	clock_freq = CMU_ClockFreqGet(cmuClock_LETIMER0);
-	On_val = ((On_Time)*clock_freq)/1000;
+	letimer_freq = CMU_ClockFreqGet(cmuClock_LETIMER0);
+	On_val = ((On_Time)*letimer_freq)/1000;
 }
 
-/* LETIMER0 Interrupt Handler */
-void LETIMER0_IRQHandler(void)
+/* Function to get the ticks elapsed since LETIMER0 was enabled, call with interrupts disabled */
+static uint32_t timerNowTicks(void)
 {
-	CORE_DECLARE_IRQ_STATE;
-	uint32_t interrupt = LETIMER_IntGet(LETIMER0);
-	if(interrupt & LETIMER_IF_COMP1)
+	uint32_t count = LETIMER_CounterGet(LETIMER0);
+	uint32_t overflows = overflow_count;
+
+	/* Underflow not yet counted by the ISR, or happened between the two reads (counter counts down) */
+	if((LETIMER_IntGet(LETIMER0) & LETIMER_IF_UF) || (LETIMER_CounterGet(LETIMER0) > count))
 	{
-		LETIMER_CompareSet(LETIMER0, 1, 0xFFFF); //Load values to COMP1
-		LETIMER_IntDisable(LETIMER0,LETIMER_IEN_COMP1); //Disable COMP1 interrupt
+		count = LETIMER_CounterGet(LETIMER0);
+		overflows++;
+	}
+	return (overflows * ((uint32_t)On_val + 1)) + (On_val - count);
+}
 
-		if(eNextState == WRITE_START)
+/* Function to mark expired timers and program COMP1 for the nearest remaining deadline, call with interrupts disabled */
+static void timerSchedule(void)
+{
+	uint32_t now = timerNowTicks();
+	uint32_t expired = 0;
+	int32_t nearest = INT32_MAX;
+	int32_t remaining;
+	uint8_t handle;
+
+	for(handle = 0; handle < TIMER_HANDLE_COUNT; handle++)
+	{
+		struct soft_timer *timer = &soft_timers[handle];
+		if(!timer->active)
 		{
-			gecko_external_signal(0x03);
+			continue;
 		}
-		else if(eNextState == READ_START)
+		remaining = (int32_t)(timer->deadline - now); //Signed difference handles tick wraparound
+		if(remaining < TIMER_MIN_TICKS)
 		{
-			gecko_external_signal(0x05);
+			expired |= (1UL << handle);
+			if(timer->period)
+			{
+				timer->deadline += timer->period;
+				remaining = (int32_t)(timer->deadline - now);
+				if(remaining < TIMER_MIN_TICKS)
+				{
+					timer->deadline = now + timer->period; //Fell behind, skip the missed periods
+					remaining = timer->period;
+				}
+			}
+			else
+			{
+				timer->active = false;
+				continue;
+			}
 		}
+		if(remaining < nearest)
+		{
+			nearest = remaining;
+		}
+	}
 
+	/* COMP1 can only match before the next underflow, later deadlines are rescheduled from the UF interrupt */
+	if(nearest <= (int32_t)LETIMER_CounterGet(LETIMER0))
+	{
+		LETIMER_CompareSet(LETIMER0, 1, LETIMER_CounterGet(LETIMER0) - nearest);
+		LETIMER_IntClear(LETIMER0, LETIMER_IF_COMP1);
+		LETIMER_IntEnable(LETIMER0, LETIMER_IEN_COMP1);
 	}
+	else
+	{
+		LETIMER_IntDisable(LETIMER0, LETIMER_IEN_COMP1);
+	}
+
+	if(expired)
+	{
+		timers_expired |= expired;
+		signalPost(SIGNAL_LETIMER_COMP1);
+	}
+}
+
+/* LETIMER0 Interrupt Handler */
+void LETIMER0_IRQHandler(void)
+{
+	uint32_t interrupt = LETIMER_IntGetEnabled(LETIMER0);
+	LETIMER_IntClear(LETIMER0, interrupt); //Clear LETIMER0 interrupt before timerNowTicks() looks at UF
 	if(interrupt & LETIMER_IF_UF)
 	{
 		overflow_count++;
-		CORE_ENTER_CRITICAL(); //Critical section starts
-		interrupt_flag = true; //Set the event
-		eNextState = POWER_UP; //Select the next state after POWER_OFF
-		gecko_external_signal(0x02);
-		CORE_EXIT_CRITICAL(); //Critical section ends
+		signalPost(SIGNAL_LETIMER_UF);
 		LETIMER_CompareSet(LETIMER0, 0, On_val);
 	}
-	LETIMER_IntClear(LETIMER0, interrupt); //Clear LETIMER0 interrupt
+	if(interrupt & (LETIMER_IF_COMP1 | LETIMER_IF_UF))
+	{
+		timerSchedule();
+	}
 }
 
-/* Function to get the run time in milliseconds */
+/* Function to get the run time in milliseconds, from the same timebase as the log timestamps */
 uint32_t timerGetRunTimeMilliseconds(void)
 {
-	volatile uint32_t milli_sec, curr_ticks, tot_ticks;
-	uint32_t clock_freq;
-	curr_ticks = LETIMER_CounterGet(LETIMER0);
-	tot_ticks = LETIMER_CompareGet(LETIMER0,0);
-	clock_freq = CMU_ClockFreqGet(cmuClock_LETIMER0);
-	milli_sec = ((tot_ticks - curr_ticks)*1000)/clock_freq;
-	milli_sec += (overflow_count*tot_ticks);
-	return milli_sec;
+	return (uint32_t)timebaseGetMs();
 }
 
-void timerWaitMs(uint32_t ms_wait)
+/* Function to start a one-shot or periodic timer, restarts the timer if already running */
+void timerSetEventInMs(uint8_t handle, uint32_t ms_until_wakeup, bool periodic, timer_callback_t callback)
 {
-	uint32_t ticks = 0, delay = 0;
-	uint32_t delay_s = 0;
-
-	//To get the current number of ticks (in seconds)
-	ticks=LETIMER_CounterGet(LETIMER0);
-
-	//Converts the given ms_wait value to seconds
-	delay_s = (ms_wait*CMU_ClockFreqGet(cmuClock_LETIMER0))/1000;
+	CORE_DECLARE_IRQ_STATE;
+	uint32_t ticks = (uint32_t)(((uint64_t)ms_until_wakeup * letimer_freq) / 1000);
 
-	if(ticks >= delay_s)
+	if(handle >= TIMER_HANDLE_COUNT)
 	{
-		delay = (ticks - delay_s); //Wait until the current ticks is equal to the difference between the ticks and delays
+		return;
 	}
-	else
+	CORE_ENTER_CRITICAL(); //Critical section starts
+	soft_timers[handle].deadline = timerNowTicks() + ticks;
+	soft_timers[handle].period = periodic ? ticks : 0;
+	soft_timers[handle].callback = callback;
+	soft_timers[handle].active = true;
+	timers_expired &= ~(1UL << handle);
+	timerSchedule();
+	CORE_EXIT_CRITICAL(); //Critical section ends
+}
+
+/* Function to stop a timer, a pending expiry of the timer is discarded */
+void timerStop(uint8_t handle)
+{
+	CORE_DECLARE_IRQ_STATE;
+
+	if(handle >= TIMER_HANDLE_COUNT)
 	{
-		delay = (LETIMER_CompareGet(LETIMER0,0) - (delay_s - ticks)); //Calculation for when the tick values is lesser than the delay mentioned
+		return;
 	}
-
-	LETIMER_CompareSet(LETIMER0, 1, delay);
-	LETIMER_IntEnable(LETIMER0, LETIMER_IEN_COMP1);
+	CORE_ENTER_CRITICAL(); //Critical section starts
+	soft_timers[handle].active = false;
+	timers_expired &= ~(1UL << handle);
+	timerSchedule();
+	CORE_EXIT_CRITICAL(); //Critical section ends
 }
 
+/* Function to run the callbacks of expired timers, called from the main loop */
+void timerProcessExpired(void)
+{
+	CORE_DECLARE_IRQ_STATE;
+	uint32_t expired;
+	uint8_t handle;
 
+	CORE_ENTER_CRITICAL(); //Critical section starts
+	expired = timers_expired;
+	timers_expired = 0;
+	CORE_EXIT_CRITICAL(); //Critical section ends
 
-///* Function to wait for a given millisecond */
-//void timerSetEventInMs(uint32_t ms_until_wakeup)
-//{
-//	uint32_t wait_val, curr_val, tot_val, new_val;
-//	uint32_t clock_freq = CMU_ClockFreqGet(cmuClock_LETIMER0);
-//	wait_val = (ms_until_wakeup * clock_freq)/1000;
-//	curr_val = LETIMER_CounterGet(LETIMER0);
-//	tot_val = LETIMER_CompareGet(LETIMER0,0);
-//	if(curr_val >= wait_val)
-//	{
-//		new_val = curr_val - wait_val;
-//	}
-//	else
-//	{
-//		new_val = tot_val - (wait_val - curr_val);
-//	}
-//	LETIMER_CompareSet(LETIMER0,1,new_val);
-//	LETIMER_IntEnable(LETIMER0,LETIMER_IEN_COMP1);
-//}
+	for(handle = 0; handle < TIMER_HANDLE_COUNT; handle++)
+	{
+		if((expired & (1UL << handle)) && (soft_timers[handle].callback != NULL))
+		{
+			soft_timers[handle].callback();
+		}
+	}
+}
@@ -19,12 +19,20 @@
 #define On_Time 6000
 #define TIMER_SUPPORTS_1HZ_TIMER_EVENT	1
 
+/* Software timer handles multiplexed on LETIMER0 COMP1 */
+#define TIMER_HANDLE_HUMIDITY	0
+#define TIMER_HANDLE_COUNT		8
+
+typedef void (*timer_callback_t)(void);
+
 extern bool flag;
 /********* Function Prototypes *******/
 void letimer_Init(void);							/* Function to initialize LETIMER0 */
 void compute_CompVal(void);							/* Function to compute the COMP0 register values for ON and OFF times */
 void timerWaitUs(uint32_t wait_us);					/* Function to wait for a given microseconds */
 uint32_t timerGetRunTimeMilliseconds(void);			/* Function to get the run time in milliseconds */
-void timerWaitMs(uint32_t ms_wait);					/* Function to wait for a given millisecond */
+void timerSetEventInMs(uint8_t handle, uint32_t ms_until_wakeup, bool periodic, timer_callback_t callback);	/* Function to start a one-shot or periodic timer */
+void timerStop(uint8_t handle);						/* Function to stop a timer */
+void timerProcessExpired(void);						/* Function to run the callbacks of expired timers, called from the main loop */
 
 #endif /* SRC_LETIMER_H_ */
@@ -7,22 +7,259 @@
 
 #include "retargetserial.h"
 #include "log.h"
+#include "timebase.h"
+#include "format.h"
+#include "ldma.h"
+#include "energy.h"
+#include <stdarg.h>
 #include <stdbool.h>
+#include <em_core.h>
+#include <em_usart.h>
+
+#if defined(HAL_CONFIG)
+#include "retargetserialhalconfig.h"
+#else
+#include "retargetserialconfig.h"
+#endif
 
 #if INCLUDE_LOGGING
-uint16_t overflow_count;
+
+#if !defined(RETARGET_USART) || (RETARGET_UART_INDEX != 0)
+#error "The log drain is written for the VCOM on USART0"
+#endif
+#define LOG_UART				USART0
+#define LOG_UART_TX_IRQn		USART0_TX_IRQn
+#define LOG_UART_TX_IRQHandler	USART0_TX_IRQHandler
+#define LOG_UART_DMAREQ			DMAREQ_USART0_TXBL
+
+#define LOG_RING_MASK	(LOG_RING_SIZE - 1)
+
+/*
+ * Log lines are queued here and sent by the LDMA.  head and tail run freely and
+ * are masked on access, head - tail is the number of queued bytes.  Only the
+ * LDMA done interrupt moves tail, producers move head.
+ */
+static char log_ring[LOG_RING_SIZE];
+static volatile uint32_t log_head = 0;
+static volatile uint32_t log_tail = 0;
+static volatile uint16_t log_dma_len = 0;		//Bytes in the LDMA transfer in flight, 0 when idle
+static volatile bool log_tx_active = false;		//EM2 blocked until the last queued byte has left the shift register
+static bool log_initialized = false;
+uint32_t log_dropped_lines = 0;
+
+static void logDrain(void);
+
+/**
+ * LDMA done callback, the bytes of the transfer have all been written to TXDATA
+ */
+static void logDmaDone(void)
+{
+	log_tail += log_dma_len;
+	log_dma_len = 0;
+	if(log_head != log_tail)
+	{
+		logDrain();
+	}
+	else
+	{
+		/* Wait for the shift register to empty before sleep is allowed again */
+		USART_IntClear(LOG_UART, USART_IF_TXC);
+		USART_IntEnable(LOG_UART, USART_IEN_TXC);
+	}
+}
+
+/**
+ * Start an LDMA transfer of the queued bytes up to the end of the ring, if none is running
+ */
+static void logDrain(void)
+{
+	CORE_DECLARE_IRQ_STATE;
+	uint32_t start, len;
+
+	CORE_ENTER_ATOMIC();
+	if((log_dma_len == 0) && (log_head != log_tail))
+	{
+		start = log_tail & LOG_RING_MASK;
+		len = log_head - log_tail;
+		if(len > (LOG_RING_SIZE - start))
+		{
+			len = LOG_RING_SIZE - start; //Rest is sent from the start of the ring by the next transfer
+		}
+		if(!log_tx_active)
+		{
+			log_tx_active = true;
+			energyBlockBegin(ENERGY_CAUSE_LOG, sleepEM2); //USART0 is not clocked in EM2
+		}
+		USART_IntDisable(LOG_UART, USART_IEN_TXC);
+		log_dma_len = len;
+		ldmaStartTransfer(LDMA_CHANNEL_UART_TX, LOG_UART_DMAREQ, &log_ring[start], &LOG_UART->TXDATA,
+						  len, LDMA_CH_CTRL_SRCINC_ONE | LDMA_CH_CTRL_DSTINC_NONE, logDmaDone);
+	}
+	CORE_EXIT_ATOMIC();
+}
+
+/**
+ * USART0 TX complete, the last queued byte is out
+ */
+void LOG_UART_TX_IRQHandler(void)
+{
+	USART_IntClear(LOG_UART, USART_IF_TXC);
+	USART_IntDisable(LOG_UART, USART_IEN_TXC);
+	if((log_dma_len == 0) && (log_head == log_tail) && log_tx_active)
+	{
+		log_tx_active = false;
+		energyBlockEnd(ENERGY_CAUSE_LOG, sleepEM2);
+	}
+}
+
 /**
  * @return a timestamp value for the logger, typically based on a free running timer.
  * This will be printed at the beginning of each log message.
  */
 uint32_t loggerGetTimestamp(void)
 {
-	uint32_t current_ticks, max_ticks, time_ms=0;
-	max_ticks=LETIMER_CompareGet(LETIMER0,0);
-	current_ticks=LETIMER_CounterGet(LETIMER0);
-	time_ms=((max_ticks-current_ticks)*1000)/CMU_ClockFreqGet(cmuClock_LETIMER0);
-	time_ms+=(overflow_count*max_ticks);
-	return time_ms;
+	return (uint32_t)timebaseGetMs();
+}
+
+/**
+ * Copy bytes into the ring and start the LDMA.  Never blocks, data that does not fit
+ * in the ring is dropped whole and counted in log_dropped_lines, so lines logged from
+ * interrupts are never interleaved.  With crlf set each LF goes out as CRLF, the terminal needs the CR.
+ */
+static void logQueue(const char *data, uint32_t len, bool crlf)
+{
+	CORE_DECLARE_IRQ_STATE;
+	uint32_t needed = len;
+	uint32_t head, i;
+
+	if(crlf)
+	{
+		for(i = 0; i < len; i++)
+		{
+			if(data[i] == '\n')
+			{
+				needed++;
+			}
+		}
+	}
+
+	CORE_ENTER_ATOMIC();
+	if((LOG_RING_SIZE - (log_head - log_tail)) < needed)
+	{
+		log_dropped_lines++;
+		CORE_EXIT_ATOMIC();
+		return;
+	}
+	head = log_head;
+	for(i = 0; i < len; i++)
+	{
+		if(crlf && (data[i] == '\n'))
+		{
+			log_ring[head++ & LOG_RING_MASK] = '\r';
+		}
+		log_ring[head++ & LOG_RING_MASK] = data[i];
+	}
+	log_head = head;
+	CORE_EXIT_ATOMIC();
+
+	if(log_initialized)
+	{
+		logDrain();
+	}
+}
+
+/**
+ * Format a log line with the integer only formatter and queue it for the LDMA.
+ */
+void logPrintf(const char *format, ...)
+{
+	char line[LOG_LINE_LEN];
+	va_list args;
+	int len;
+
+	va_start(args, format);
+	len = fmtVsnprintf(line, sizeof(line), format, args);
+	va_end(args);
+	if(len >= (int)sizeof(line))
+	{
+		len = sizeof(line) - 1;
+		line[len - 1] = '\n'; //Keep the line ending of a truncated line
+	}
+	logQueue(line, len, true);
+}
+
+/* Append value as an unsigned LEB128 varint, small values take one byte */
+static uint32_t logPutVarint(char *frame, uint32_t pos, uint64_t value)
+{
+	do
+	{
+		frame[pos++] = (char)((value & 0x7F) | ((value > 0x7F) ? 0x80 : 0));
+		value >>= 7;
+	}while(value != 0);
+	return pos;
+}
+
+/**
+ * Queue a tokenized log frame, see LOG_TOKENIZED in log.h for the layout.
+ * types holds LOG_ARG_TYPE() of each argument, two bits per argument starting at bit 0.
+ */
+void logTokenized(uint16_t id, uint16_t types, ...)
+{
+	char frame[LOG_FRAME_MAX];
+	va_list args;
+	uint32_t pos = LOG_FRAME_HEADER_LEN;
+	uint32_t timestamp = loggerGetTimestamp();
+	uint8_t checksum = 0;
+	uint32_t i;
+
+	frame[0] = LOG_FRAME_SYNC;
+	frame[2] = (char)(id & 0xFF);
+	frame[3] = (char)(id >> 8);
+	frame[4] = (char)(timestamp & 0xFF);
+	frame[5] = (char)((timestamp >> 8) & 0xFF);
+	frame[6] = (char)((timestamp >> 16) & 0xFF);
+	frame[7] = (char)(timestamp >> 24);
+
+	va_start(args, types);
+	for(; types != 0; types >>= 2)
+	{
+		switch(types & 0x3)
+		{
+		case LOG_ARG_INT:
+			pos = logPutVarint(frame, pos, va_arg(args, unsigned int));
+			break;
+		case LOG_ARG_INT64:
+			pos = logPutVarint(frame, pos, va_arg(args, unsigned long long));
+			break;
+		case LOG_ARG_STRING:
+		{
+			const char *str = va_arg(args, const char *);
+			for(i = 0; (str != NULL) && (str[i] != '\0') && (i < LOG_FRAME_STRING_MAX); i++)
+			{
+				frame[pos++] = str[i];
+			}
+			frame[pos++] = '\0';
+			break;
+		}
+		}
+	}
+	va_end(args);
+
+	frame[1] = (char)(pos - 2); //Payload length, id to last argument
+	for(i = 2; i < pos; i++)
+	{
+		checksum ^= (uint8_t)frame[i];
+	}
+	frame[pos++] = (char)checksum;
+	logQueue(frame, pos, false);
+}
+
+/**
+ * @return true while queued log bytes are still being sent
+ */
+bool logTxActive(void)
+{
+	return log_tx_active || (log_head != log_tail);
 }
 
 /**
@@ -35,16 +272,28 @@ void logInit(void)
 	/**
 	 * See https://siliconlabs.github.io/Gecko_SDK_Doc/efm32g/html/group__RetargetIo.html#ga9e36c68713259dd181ef349430ba0096
 	 * RETARGET_SerialCrLf() ensures each linefeed also includes carriage return.  Without it, the first character is shifted in TeraTerm
+	 * The log drain does its own CRLF conversion, this covers any direct use of RETARGET_WriteChar()
 	 */
 	RETARGET_SerialCrLf(true);
+	NVIC_ClearPendingIRQ(LOG_UART_TX_IRQn);
+	NVIC_EnableIRQ(LOG_UART_TX_IRQn);
+	log_initialized = true;
 	LOG_INFO("Initialized Logging");
 }
 
 /**
- * Block for chars to be flushed out of the serial port.  Important to do this before entering SLEEP() or you may see garbage chars output.
+ * Block until all queued log lines are out of the serial port.  Only needed before a
+ * reset or an EM3/EM4 entry that bypasses the sleep driver, the EM2 block covers normal sleep.
  */
 void logFlush(void)
 {
-	RETARGET_SerialFlush();
+	if(!log_initialized)
+	{
+		return;
+	}
+	logDrain();
+	while(logTxActive())
+	{
+	}
 }
 #endif
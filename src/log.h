@@ -9,6 +9,7 @@
 #define SRC_LOG_H_
 #include "stdio.h"
 #include <inttypes.h>
+#include <stdbool.h>
 #include "letimer.h"
 /**
  * Instructions for using this module:
@@ -59,10 +60,75 @@
 #endif
 
 
+/**
+ * Tokenized logging, #define LOG_TOKENIZED 1 in the project configuration to enable.
+ * Each LOG_XXX format string, prefixed with level, file and line, is placed in the .log_strings
+ * section.  The linker script keeps that section in the ELF file but not in flash.  Only a binary
+ * frame goes out on the serial port:
+ *   0xA5, payload length, string id (2 bytes LE), timestamp in ms (4 bytes LE), arguments, checksum
+ * The string id is the offset of the format string in .log_strings.  Integer arguments are LEB128
+ * varints of their bit pattern, strings are sent up to LOG_FRAME_STRING_MAX chars plus a NUL.
+ * The checksum is the XOR of the payload bytes.  tools/log_decoder.py rebuilds the text lines
+ * from the frames and the ELF file.  At most 8 arguments per log call.
+ */
+#ifndef LOG_TOKENIZED
+#define LOG_TOKENIZED 0
+#endif
+
 #if INCLUDE_LOGGING
+#if LOG_TOKENIZED
 #define LOG_DO(message,level, ...) \
-	printf( "%5"PRIu32":%s:%s: " message "\n", loggerGetTimestamp(), level, __func__, ##__VA_ARGS__ )
+	do { \
+		static const char log_token[] __attribute__((section(".log_strings"), used)) = \
+			level ":" __FILE__ ":" LOG_STRINGIFY(__LINE__) ": " message; \
+		logTokenized((uint16_t)(uintptr_t)log_token, LOG_ARG_TYPES(message, ##__VA_ARGS__), ##__VA_ARGS__); \
+	} while(0)
+#else
+#define LOG_DO(message,level, ...) \
+	logPrintf( "%5"PRIu32":%s:%s: " message "\n", loggerGetTimestamp(), level, __func__, ##__VA_ARGS__ )
+#endif
+
+#define LOG_STRINGIFY(x)	LOG_STRINGIFY_(x)
+#define LOG_STRINGIFY_(x)	#x
+#define LOG_CAT(a, b)		LOG_CAT_(a, b)
+#define LOG_CAT_(a, b)		a##b
+
+/* Argument encodings of a tokenized frame, two bits each */
+#define LOG_ARG_INT		1
+#define LOG_ARG_STRING	2
+#define LOG_ARG_INT64	3
+#define LOG_ARG_TYPE(arg) \
+	_Generic((arg), char *: LOG_ARG_STRING, const char *: LOG_ARG_STRING, \
+			 long long: LOG_ARG_INT64, unsigned long long: LOG_ARG_INT64, default: LOG_ARG_INT)
+
+/* Count of the arguments after the format string, 0 to 8 */
+#define LOG_NARGS(...)	LOG_NARGS_(__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_NARGS_(fmt, _1, _2, _3, _4, _5, _6, _7, _8, n, ...)	n
+
+/* LOG_ARG_TYPE() of each argument after the format string, two bits per argument */
+#define LOG_ARG_TYPES(fmt, ...)	LOG_CAT(LOG_ARG_TYPES_, LOG_NARGS(fmt, ##__VA_ARGS__))(__VA_ARGS__)
+#define LOG_ARG_TYPES_0()							0
+#define LOG_ARG_TYPES_1(a)							LOG_ARG_TYPE(a)
+#define LOG_ARG_TYPES_2(a, b)						(LOG_ARG_TYPES_1(a) | (LOG_ARG_TYPE(b) << 2))
+#define LOG_ARG_TYPES_3(a, b, c)					(LOG_ARG_TYPES_2(a, b) | (LOG_ARG_TYPE(c) << 4))
+#define LOG_ARG_TYPES_4(a, b, c, d)					(LOG_ARG_TYPES_3(a, b, c) | (LOG_ARG_TYPE(d) << 6))
+#define LOG_ARG_TYPES_5(a, b, c, d, e)				(LOG_ARG_TYPES_4(a, b, c, d) | (LOG_ARG_TYPE(e) << 8))
+#define LOG_ARG_TYPES_6(a, b, c, d, e, f)			(LOG_ARG_TYPES_5(a, b, c, d, e) | (LOG_ARG_TYPE(f) << 10))
+#define LOG_ARG_TYPES_7(a, b, c, d, e, f, g)		(LOG_ARG_TYPES_6(a, b, c, d, e, f) | (LOG_ARG_TYPE(g) << 12))
+#define LOG_ARG_TYPES_8(a, b, c, d, e, f, g, h)		(LOG_ARG_TYPES_7(a, b, c, d, e, f, g) | (LOG_ARG_TYPE(h) << 14))
+
+#define LOG_FRAME_SYNC			0xA5
+#define LOG_FRAME_HEADER_LEN	8		//Sync, length, id, timestamp
+#define LOG_FRAME_STRING_MAX	24		//Longer string arguments are truncated
+#define LOG_FRAME_MAX			(LOG_FRAME_HEADER_LEN + (8 * (LOG_FRAME_STRING_MAX + 1)) + 1)
+
+#define LOG_LINE_LEN	128		//Longer log lines are truncated
+#define LOG_RING_SIZE	1024	//Queued log bytes, power of two
+extern uint32_t log_dropped_lines;
 void logInit();
+void logPrintf(const char *format, ...) __attribute__((format(printf, 1, 2)));
+void logTokenized(uint16_t id, uint16_t types, ...);
+bool logTxActive();
 uint32_t loggerGetTimestamp();
 void logFlush();
 #else
@@ -72,6 +138,7 @@ void logFlush();
 #define LOG_DO(message,level, ...)
 static inline void logInit() {}
 static inline void logFlush() {}
+static inline bool logTxActive() { return false; }
 #endif
 
 
@@ -6,7 +6,21 @@
 
 #include "lpn_data.h"
 
-static bool rec_temp = 0, rec_acc = 0;
+/*
+ * @brief	Registry slot of the LPN a request came from, NULL if it is not befriended
+ */
+static lpn_entry_t *lpn_lookup(uint16_t client_addr)
+{
+	lpn_entry_t *lpn = lpnRegistryFind(client_addr);
+	if(lpn == NULL)
+	{
+		LOG_WARN("Request from unknown node 0x%x ignored", client_addr);
+		return NULL;
+	}
+	lpn->messages++;
+	lpn->last_seen_ms = (uint32_t)timebaseGetMs();
+	return lpn;
+}
 
 void onoff_request(uint16_t model_id,
                           uint16_t element_index,
@@ -18,15 +32,20 @@ void onoff_request(uint16_t model_id,
                           uint16_t delay_ms,
                           uint8_t request_flags)
 {
-	switch(client_addr)
+	lpn_entry_t *lpn = lpn_lookup(client_addr);
+	if(lpn == NULL)
+	{
+		return;
+	}
+	switch(lpn->role)
 	{
-	case 3:
+	case LPN_ROLE_CARETAKER:
 		if(request->on_off == 1)
 		{
-	    	if(authorized_personnel)
+	    	if(lpn->present)
 	    	{
 	    		GPIO_ExtIntConfig(MOTION_PORT, MOTION_PIN, MOTION_PIN, true, true, true);
-	    		authorized_personnel = 0;
+	    		lpn->present = false;
 	    		LOG_INFO("Authorized personnel leaving");
 	    		displayPrintf(DISPLAY_ROW_AUTHORITY, "Authority Left");
 	    	}
@@ -34,28 +53,90 @@ void onoff_request(uint16_t model_id,
 	    	{
 	    		LOG_INFO("Authorized personnel entered");
 	    		GPIO_ExtIntConfig(MOTION_PORT, MOTION_PIN, MOTION_PIN, true, true, false);
-	    		authorized_personnel = 1;
+	    		lpn->present = true;
 	    		displayPrintf(DISPLAY_ROW_AUTHORITY, "Authority Present");
 	    	}
-	    	psDataSave(AUTHORIZED_PERSONNEL, &authorized_personnel, sizeof(authorized_personnel));
+	    	authorized_personnel = lpn->present;
+	    	journalAppend(JOURNAL_OCCUPANCY, lpn->address, lpn->present, 0);
+	    	psCacheWrite(AUTHORIZED_PERSONNEL, &authorized_personnel, sizeof(authorized_personnel));
 		}
 
 		break;
-	case 2:
-		if(request->on_off == 1)
-		{
-			rec_temp = 0;
-			rec_acc = 1;
-		}
-		else
-		{
-			rec_acc = 0;
-			rec_temp = 1;
-		}
+	case LPN_ROLE_PATIENT:
+		lpn->mode = (request->on_off == 1) ? LPN_MODE_ACCELEROMETER : LPN_MODE_TEMPERATURE;
 		break;
 	}
 }
 
+/*
+ * @brief	Record a patient temperature, hundredths of a degree Celsius
+ */
+static void lpn_temperature(lpn_entry_t *lpn, int32_t temperature)
+{
+	char data_str[FIXED_FORMAT_LEN];
+
+	lpn->temperature = temperature;
+	journalAppend(JOURNAL_TEMPERATURE, lpn->address, temperature, 0);
+	telemetrySet(TELEMETRY_TEMPERATURE, temperature);
+	fixedFormat(data_str, sizeof(data_str), lpn->temperature);
+	LOG_INFO("Temperature Data ----- %s", data_str);
+	displayPrintf(DISPLAY_ROW_TEMPERATURE, "%s", data_str);
+	if (lpn->temperature>lpn->max_temperature)
+	{
+		lpn->max_temperature = lpn->temperature;
+	}
+	if (lpn->temperature>high_temp)
+	{
+		high_temp = lpn->temperature;
+		psCacheWrite(MAX_TEMP, &high_temp, sizeof(high_temp));
+	}
+	if (lpn->temperature>TEMP_ALERT_THRESHOLD)
+	{
+		lpn->alerts++;
+		counterIncrement(COUNTER_FEVER_ALERTS);
+		journalAppend(JOURNAL_ALERT_FEVER, lpn->address, temperature, 0);
+		telemetryAlertSet(TELEMETRY_ALERT_FEVER);
+		redAlert();
+		displayPrintf(DISPLAY_ROW_ALERT_PATIENT, "High temperature");
+	}
+}
+
+/*
+ * @brief	Record a patient accelerometer level
+ */
+static void lpn_acceleration(lpn_entry_t *lpn, int16_t acceleration)
+{
+	lpn->acceleration = acceleration;
+	journalAppend(JOURNAL_ACCELERATION, lpn->address, acceleration, 0);
+	telemetrySet(TELEMETRY_ACCELERATION, acceleration);
+	LOG_INFO("Accelerometer Data ----- %d", acceleration);
+	if (acceleration>ACC_FALL_THRESHOLD)
+	{
+		lpn->alerts++;
+		counterIncrement(COUNTER_FAINT_ALERTS);
+		journalAppend(JOURNAL_ALERT_FAINT, lpn->address, acceleration, 0);
+		telemetryAlertSet(TELEMETRY_ALERT_FAINT);
+		redAlert();
+		displayPrintf(DISPLAY_ROW_ALERT_PATIENT, "Patient Fainted");
+	}
+	displayPrintf(DISPLAY_ROW_ACCELEROMETER, "%d", acceleration);
+}
+
+/*
+ * @brief	Record a caretaker ultrasonic distance, in hundredths
+ */
+static void lpn_distance(lpn_entry_t *lpn, int32_t distance)
+{
+	char data_str[FIXED_FORMAT_LEN];
+
+	lpn->distance = distance;
+	journalAppend(JOURNAL_DISTANCE, lpn->address, distance, 0);
+	telemetrySet(TELEMETRY_DISTANCE, distance);
+	fixedFormat(data_str, sizeof(data_str), lpn->distance);
+	LOG_INFO("Ultrasonic Data ----- %s", data_str);
+	displayPrintf(DISPLAY_ROW_ULTRASONIC, "%s", data_str);
+}
+
 void level_request(uint16_t model_id,
         		   uint16_t element_index,
 				   uint16_t client_addr,
@@ -66,43 +147,77 @@ void level_request(uint16_t model_id,
 				   uint16_t delay_ms,
 				   uint8_t request_flags)
 {
-	static float data = 0;
-	switch(client_addr)
+	lpn_entry_t *lpn = lpn_lookup(client_addr);
+	if(lpn == NULL)
 	{
-	case 3:
-		data = (float)(request->level)/100;
-		LOG_INFO("Ultrasonic Data ----- %f", data);
-		displayPrintf(DISPLAY_ROW_ULTRASONIC, "%.2f",data);
+		return;
+	}
+	switch(lpn->role)
+	{
+	case LPN_ROLE_CARETAKER:
+		lpn_distance(lpn, fixedFromLevel(request->level));
 		break;
-	case 2:
-		if (rec_temp)
+	case LPN_ROLE_PATIENT:
+		if (lpn->mode == LPN_MODE_TEMPERATURE)
+		{
+			lpn_temperature(lpn, fixedFromLevel(request->level));
+		}
+		else if (lpn->mode == LPN_MODE_ACCELEROMETER)
 		{
-			data = (float)(request->level)/100;
-			LOG_INFO("Temperature Data ----- %f", data);
-			displayPrintf(DISPLAY_ROW_TEMPERATURE, "%.2f", data);
-			psDataLoad(MAX_TEMP, &high_temp, sizeof(high_temp));
-			if (data>high_temp)
+			lpn_acceleration(lpn, request->level);
+		}
+		break;
+	}
+}
+
+void sensor_status(const struct gecko_msg_mesh_sensor_client_status_evt_t *status)
+{
+	const uint8_t *data = status->sensor_data.data;
+	uint8_t len = status->sensor_data.len;
+	uint16_t property_id;
+	uint8_t value_len;
+	uint8_t pos = 0;
+	lpn_entry_t *lpn = lpn_lookup(status->server_address);
+	if(lpn == NULL)
+	{
+		return;
+	}
+	/* Marshalled by the stack as property ID, value length, value for each sensor */
+	while((len - pos) >= SENSOR_STATUS_HEADER_LEN)
+	{
+		property_id = (uint16_t)(data[pos] | (data[pos + 1] << 8));
+		value_len = data[pos + 2];
+		pos += SENSOR_STATUS_HEADER_LEN;
+		if(value_len > (len - pos))
+		{
+			LOG_WARN("Truncated sensor status from 0x%x", status->server_address);
+			return;
+		}
+		switch(property_id)
+		{
+		case PRESENT_DEVICE_OPERATING_TEMPERATURE:
+			if(value_len == sizeof(temperature_t))
 			{
-				psDataSave(MAX_TEMP, &high_temp, sizeof(high_temp));
+				/* Signed 0.01 degree Celsius, the same scale as the fixed point values, decoded into the uint16 member */
+				lpn_temperature(lpn, (int16_t)mesh_sensor_data_from_buf(property_id, &data[pos]).uint16);
 			}
-			if (data>34)
+			break;
+		case LPN_PROPERTY_ACCELERATION:
+			if(value_len == sizeof(int16_t))
 			{
-				redAlert();
-				displayPrintf(DISPLAY_ROW_ALERT_PATIENT, "High temperature");
+				lpn_acceleration(lpn, (int16_t)(data[pos] | (data[pos + 1] << 8)));
 			}
-
-
-		}
-		else if (rec_acc)
-		{
-			LOG_INFO("Accelerometer Data ----- %d", request->level);
-			if ((request->level)>2900)
+			break;
+		case LPN_PROPERTY_DISTANCE:
+			if(value_len == sizeof(int16_t))
 			{
-				redAlert();
-				displayPrintf(DISPLAY_ROW_ALERT_PATIENT, "Patient Fainted");
+				lpn_distance(lpn, (int16_t)(data[pos] | (data[pos + 1] << 8)));
 			}
-			displayPrintf(DISPLAY_ROW_ACCELEROMETER, "%d", request->level);
+			break;
+		default:
+			LOG_WARN("Sensor property 0x%x from 0x%x ignored", property_id, status->server_address);
+			break;
 		}
-		break;
+		pos += value_len;
 	}
 }
@@ -12,10 +12,27 @@
 #include "mesh_generic_model_capi_types.h"
 #include "mesh_lighting_model_capi_types.h"
 #include "mesh_lib.h"
-//Persistent storage keys
-#define MAX_TEMP (0xa000)
+#include "mesh_sensor.h"
+#include "mesh_device_properties.h"
+#include "lpn_registry.h"
+//Persistent storage keys, fields of the record in ps_cache.c
+#define MAX_TEMP (0xa001)	//int32_t hundredths of a degree, 0xa000 held a float
 #define AUTHORIZED_PERSONNEL (0xb000)
-#define BUTTON_COUNT (0xc000)
+#define BUTTON_COUNT (0xc000)	//uint8_t, read once to seed COUNTER_ALERTS_CLEARED
+
+//Alert thresholds
+#define TEMP_ALERT_THRESHOLD	FIXED_FROM_INT(34)	//Hundredths of a degree Celsius
+#define ACC_FALL_THRESHOLD		2900				//Raw accelerometer level
+
+/*
+ * Sensor Status properties.  Temperature is the SIG Present Device Operating
+ * Temperature, the accelerometer level and the ultrasonic distance have no SIG
+ * property and use IDs from the manufacturer range, both are int16 values in the
+ * same units as the level messages.
+ */
+#define LPN_PROPERTY_ACCELERATION	0xFF01	//Raw accelerometer level
+#define LPN_PROPERTY_DISTANCE		0xFF02	//Ultrasonic distance, in hundredths
+#define SENSOR_STATUS_HEADER_LEN	3		//Property ID and value length preceding each value
 
 /*
  * @brief	Callback function to handle onoff data received by publishers
@@ -44,7 +61,14 @@ void level_request(uint16_t model_id,
 				   uint16_t delay_ms,
 				   uint8_t request_flags);
 
-extern uint8_t authorized_personnel;
-extern float high_temp;
+/*
+ * @brief	Handle a Sensor Status received by the sensor client
+ * 			Each property in the status is handled like the level message carrying the
+ * 			same value, the onoff mode selection is not needed
+ */
+void sensor_status(const struct gecko_msg_mesh_sensor_client_status_evt_t *status);
+
+extern uint8_t authorized_personnel;	//Set while a caretaker is present, persisted
+extern int32_t high_temp;	//Highest temperature of any patient, hundredths of a degree Celsius, persisted
 
 #endif
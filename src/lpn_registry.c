@@ -0,0 +1,152 @@
+/*
+ * @filename	: lpn_registry.c
+ * @description	: This file contains the source code for the per LPN state registry
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ */
+
+#include "lpn_registry.h"
+#include "timebase.h"
+#include <stddef.h>
+#include <string.h>
+
+/*
+ * Open addressed hash of unicast address to slot index, linear probing.  At least
+ * twice as many buckets as slots keeps probe chains short, unicast addresses are
+ * assigned sequentially so the low bits spread them evenly.
+ */
+#define LPN_HASH_SIZE	(((LPN_REGISTRY_SIZE * 2) <= 4) ? 4 : ((LPN_REGISTRY_SIZE * 2) <= 8) ? 8 : \
+						 ((LPN_REGISTRY_SIZE * 2) <= 16) ? 16 : ((LPN_REGISTRY_SIZE * 2) <= 32) ? 32 : 64)
+#define LPN_HASH_MASK	(LPN_HASH_SIZE - 1)
+#define LPN_HASH_EMPTY	0xFF
+
+typedef char lpn_registry_size_check[(LPN_REGISTRY_SIZE <= 32) ? 1 : -1];
+
+static lpn_entry_t lpn_entries[LPN_REGISTRY_SIZE];
+static uint8_t lpn_hash[LPN_HASH_SIZE];
+
+static void lpnHashInsert(uint16_t address, uint8_t index)
+{
+	uint8_t bucket = address & LPN_HASH_MASK;
+
+	while(lpn_hash[bucket] != LPN_HASH_EMPTY)
+	{
+		bucket = (bucket + 1) & LPN_HASH_MASK;
+	}
+	lpn_hash[bucket] = index;
+}
+
+/* Rebuild the hash from the slots, only needed when an LPN is dropped */
+static void lpnHashRebuild(void)
+{
+	uint8_t index;
+
+	memset(lpn_hash, LPN_HASH_EMPTY, sizeof(lpn_hash));
+	for(index = 0; index < LPN_REGISTRY_SIZE; index++)
+	{
+		if(lpn_entries[index].address != LPN_ADDRESS_UNUSED)
+		{
+			lpnHashInsert(lpn_entries[index].address, index);
+		}
+	}
+}
+
+void lpnRegistryInit(void)
+{
+	memset(lpn_entries, 0, sizeof(lpn_entries));
+	memset(lpn_hash, LPN_HASH_EMPTY, sizeof(lpn_hash));
+}
+
+lpn_entry_t *lpnRegistryFind(uint16_t address)
+{
+	uint8_t bucket = address & LPN_HASH_MASK;
+	uint8_t probes;
+
+	for(probes = 0; probes < LPN_HASH_SIZE; probes++)
+	{
+		uint8_t index = lpn_hash[bucket];
+		if(index == LPN_HASH_EMPTY)
+		{
+			break;
+		}
+		if(lpn_entries[index].address == address)
+		{
+			return &lpn_entries[index];
+		}
+		bucket = (bucket + 1) & LPN_HASH_MASK;
+	}
+	return NULL;
+}
+
+lpn_entry_t *lpnRegistryAdd(uint16_t address)
+{
+	lpn_entry_t *entry;
+	uint8_t index, slot = 0;
+	bool evict = true;
+
+	if((address == LPN_ADDRESS_UNUSED) || (address & 0x8000))
+	{
+		return NULL; //Not a unicast address
+	}
+	entry = lpnRegistryFind(address);
+	if(entry != NULL)
+	{
+		entry->last_seen_ms = (uint32_t)timebaseGetMs();
+		return entry;
+	}
+
+	for(index = 0; index < LPN_REGISTRY_SIZE; index++)
+	{
+		if(lpn_entries[index].address == LPN_ADDRESS_UNUSED)
+		{
+			slot = index;
+			evict = false;
+			break;
+		}
+		if((int32_t)(lpn_entries[index].last_seen_ms - lpn_entries[slot].last_seen_ms) < 0)
+		{
+			slot = index;
+		}
+	}
+
+	entry = &lpn_entries[slot];
+	memset(entry, 0, sizeof(*entry));
+	entry->address = address;
+	entry->role = LPN_ROLE_FROM_ADDRESS(address);
+	entry->mode = LPN_MODE_NONE;
+	entry->max_temperature = INT32_MIN;
+	entry->last_seen_ms = (uint32_t)timebaseGetMs();
+	if(evict)
+	{
+		lpnHashRebuild();
+	}
+	else
+	{
+		lpnHashInsert(address, slot);
+	}
+	return entry;
+}
+
+uint8_t lpnRegistryCount(void)
+{
+	uint8_t index, count = 0;
+
+	for(index = 0; index < LPN_REGISTRY_SIZE; index++)
+	{
+		if(lpn_entries[index].address != LPN_ADDRESS_UNUSED)
+		{
+			count++;
+		}
+	}
+	return count;
+}
+
+lpn_entry_t *lpnRegistryEntry(uint8_t index)
+{
+	if((index >= LPN_REGISTRY_SIZE) || (lpn_entries[index].address == LPN_ADDRESS_UNUSED))
+	{
+		return NULL;
+	}
+	return &lpn_entries[index];
+}
@@ -0,0 +1,110 @@
+/*
+ * @filename	: lpn_registry.h
+ * @description	: This file contains header files for lpn_registry.c
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * State of each LPN befriended by this node, keyed by its unicast address.
+ * A slot is allocated when the friendship is established, so the node serves
+ * up to MESH_CFG_MAX_FRIENDSHIPS LPNs.  The friendship terminated event does
+ * not carry the LPN address, so slots are only reused when a new LPN needs
+ * one, the LPN heard from least recently gives up its slot.
+ */
+
+#ifndef SRC_LPN_REGISTRY_H_
+#define SRC_LPN_REGISTRY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "mesh_app_memory_config.h"
+
+/*******************************************************************************
+ ********************************  DEFINES  ************************************
+ ******************************************************************************/
+
+#define LPN_REGISTRY_SIZE		MESH_CFG_MAX_FRIENDSHIPS
+#define LPN_ADDRESS_UNUSED		0x0000		//Unassigned address, marks a free slot
+
+typedef enum
+{
+	LPN_ROLE_PATIENT = 0,		//Publishes temperature or accelerometer levels, onoff selects which
+	LPN_ROLE_CARETAKER			//Onoff toggles caretaker presence, publishes ultrasonic distance levels
+}eLpnRole;
+
+typedef enum
+{
+	LPN_MODE_NONE = 0,			//No onoff received yet, levels are ignored
+	LPN_MODE_TEMPERATURE,
+	LPN_MODE_ACCELEROMETER
+}eLpnMode;
+
+/*
+ * Each room is provisioned as a patient LPN followed by its caretaker LPN, so
+ * patients get even and caretakers odd unicast addresses.  Define
+ * LPN_ROLE_FROM_ADDRESS in the project configuration for another scheme.
+ */
+#ifndef LPN_ROLE_FROM_ADDRESS
+#define LPN_ROLE_FROM_ADDRESS(address)	(((address) & 1) ? LPN_ROLE_CARETAKER : LPN_ROLE_PATIENT)
+#endif
+
+typedef struct
+{
+	uint16_t address;			//LPN_ADDRESS_UNUSED for a free slot
+	uint8_t role;				//eLpnRole
+	uint8_t mode;				//eLpnMode, patients only
+	bool present;				//Caretaker in the room, caretakers only
+	int16_t acceleration;		//Last accelerometer level
+	int32_t temperature;		//Last temperature, hundredths of a degree Celsius
+	int32_t max_temperature;	//Highest temperature since the friendship was established
+	int32_t distance;			//Last ultrasonic distance, in hundredths
+	uint32_t messages;			//Onoff, level and sensor status messages received
+	uint16_t alerts;			//Alerts raised by this LPN
+	uint32_t last_seen_ms;		//timebaseGetMs() of the last message or of the friendship
+}lpn_entry_t;
+
+/*******************************************************************************
+ **************************    FUNCTION PROTOTYPES    **************************
+ ******************************************************************************/
+
+/**************************************************************************//**
+ * @brief   Free all slots
+ *
+ * @return  Void
+ *****************************************************************************/
+void lpnRegistryInit(void);
+
+/**************************************************************************//**
+ * @brief   Allocate the slot of a newly befriended LPN
+ *
+ * @detail  Returns the existing slot if the LPN is already registered, its
+ * 			state is kept.  A new slot starts with the role given by
+ * 			LPN_ROLE_FROM_ADDRESS().  When all slots are taken the least
+ * 			recently heard LPN is dropped
+ *
+ * @return  Slot of the LPN, NULL for an invalid address
+ *****************************************************************************/
+lpn_entry_t *lpnRegistryAdd(uint16_t address);
+
+/**************************************************************************//**
+ * @brief   Look up an LPN by unicast address
+ *
+ * @return  Slot of the LPN, NULL if it is not registered
+ *****************************************************************************/
+lpn_entry_t *lpnRegistryFind(uint16_t address);
+
+/**************************************************************************//**
+ * @brief   Number of registered LPNs
+ *
+ * @return  Count of used slots
+ *****************************************************************************/
+uint8_t lpnRegistryCount(void);
+
+/**************************************************************************//**
+ * @brief   Access a slot by index, for iterating over the registry
+ *
+ * @return  Slot, NULL if index is out of range or the slot is free
+ *****************************************************************************/
+lpn_entry_t *lpnRegistryEntry(uint8_t index);
+
+#endif /* SRC_LPN_REGISTRY_H_ */
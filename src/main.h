@@ -30,6 +30,18 @@
 #include "state_machine.h"
 #include "i2c.h"
 #include "lpn_data.h"
+#include "signals.h"
+#include "ldma.h"
+#include "timebase.h"
+#include "fixed_point.h"
+#include "format.h"
+#include "ps_cache.h"
+#include "counters.h"
+#include "journal.h"
+#include "history_export.h"
+#include "telemetry.h"
+#include "trace.h"
+#include "profile.h"
 
 
 #endif
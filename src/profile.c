@@ -0,0 +1,278 @@
+/*
+ * @filename	: profile.c
+ * @description	: This file contains the source code for the cycle profile of the event handlers
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ */
+
+#include "profile.h"
+#include "em_cmu.h"
+#include "gatt_db.h"
+#include "history_export.h"
+#include "gecko_ble_errors.h"
+#include "log.h"
+#include "energy.h"
+#include "signals.h"
+#include <string.h>
+
+#define PROFILE_READ_MAX			(HISTORY_MAX_MTU - 1)	//Longest read response, the largest ATT MTU offered
+#define PROFILE_BUCKETS_PER_LINE	8		//Log arguments of a tokenized line
+
+typedef struct
+{
+	uint32_t key;
+	uint32_t count;
+	uint32_t min;
+	uint32_t max;
+	uint64_t total;
+	uint16_t buckets[PROFILE_BUCKETS];		//Saturate at UINT16_MAX
+}profile_entry_t;
+
+typedef char profile_buckets_check[(PROFILE_BUCKETS == (2 * PROFILE_BUCKETS_PER_LINE)) ? 1 : -1];
+
+#if INCLUDE_PROFILE
+#if INCLUDE_LOGGING
+static const char *const profile_section_names[PROFILE_SECTIONS] =
+{
+	[PROFILE_DISPLAY_PRINTF] = "displayPrintf",
+	[PROFILE_DISPLAY_COMMIT] = "displayCommit",
+	[PROFILE_PS_SAVE] = "ps save",
+};
+#endif
+
+/* Event slots first, then one per section */
+static profile_entry_t profile_entries[PROFILE_ENTRIES];
+static uint8_t profile_events_used = 0;
+static uint32_t profile_untracked = 0;
+static uint32_t profile_frequency = 0;
+static uint8_t profile_summary[sizeof(profile_summary_t) + (PROFILE_ENTRIES * sizeof(profile_summary_entry_t))];
+
+static void profileAdd(profile_entry_t *entry, uint32_t cycles)
+{
+	uint8_t bucket = 0;
+	uint8_t bits;
+
+	if(cycles)
+	{
+		bits = (uint8_t)(32 - __builtin_clz(cycles));
+		if(bits > PROFILE_BUCKET_SHIFT)
+		{
+			bucket = bits - PROFILE_BUCKET_SHIFT;
+		}
+		if(bucket >= PROFILE_BUCKETS)
+		{
+			bucket = PROFILE_BUCKETS - 1;
+		}
+	}
+	if((entry->count == 0) || (cycles < entry->min))
+	{
+		entry->min = cycles;
+	}
+	if(cycles > entry->max)
+	{
+		entry->max = cycles;
+	}
+	entry->count++;
+	entry->total += cycles;
+	if(entry->buckets[bucket] < UINT16_MAX)
+	{
+		entry->buckets[bucket]++;
+	}
+}
+
+/* Copy the table into profile_summary */
+static void profileSummarize(void)
+{
+	profile_summary_t header;
+	profile_summary_entry_t summary;
+	uint8_t *p = profile_summary;
+	uint8_t i;
+
+	header.version = PROFILE_SUMMARY_VERSION;
+	header.entries = PROFILE_ENTRIES;
+	header.frequency = profile_frequency;
+	header.untracked = profile_untracked;
+	memcpy(p, &header, sizeof(header));
+	p += sizeof(header);
+	for(i = 0; i < PROFILE_ENTRIES; i++)
+	{
+		summary.key = profile_entries[i].key;
+		summary.count = profile_entries[i].count;
+		summary.min = profile_entries[i].min;
+		summary.avg = profile_entries[i].count ? (uint32_t)(profile_entries[i].total / profile_entries[i].count) : 0;
+		summary.max = profile_entries[i].max;
+		memcpy(p, &summary, sizeof(summary));
+		p += sizeof(summary);
+	}
+}
+#endif
+
+void profileInit(void)
+{
+#if INCLUDE_PROFILE
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	profile_frequency = CMU_ClockFreqGet(cmuClock_CORE);
+	profileReset();
+#endif
+}
+
+void profileEvent(uint32_t evt_id, uint32_t start)
+{
+#if INCLUDE_PROFILE
+	uint32_t cycles = DWT->CYCCNT - start;
+	uint8_t i;
+
+	for(i = 0; i < profile_events_used; i++)
+	{
+		if(profile_entries[i].key == evt_id)
+		{
+			profileAdd(&profile_entries[i], cycles);
+			return;
+		}
+	}
+	if(profile_events_used == PROFILE_EVENT_SLOTS)
+	{
+		profile_untracked++;
+		return;
+	}
+	profile_entries[profile_events_used].key = evt_id;
+	profileAdd(&profile_entries[profile_events_used++], cycles);
+#else
+	(void)evt_id;
+	(void)start;
+#endif
+}
+
+void profileSection(eProfileSection section, uint32_t start)
+{
+#if INCLUDE_PROFILE
+	if(section < PROFILE_SECTIONS)
+	{
+		profileAdd(&profile_entries[PROFILE_EVENT_SLOTS + section], DWT->CYCCNT - start);
+	}
+#else
+	(void)section;
+	(void)start;
+#endif
+}
+
+void profileReset(void)
+{
+#if INCLUDE_PROFILE
+	uint8_t i;
+
+	memset(profile_entries, 0, sizeof(profile_entries));
+	for(i = 0; i < PROFILE_SECTIONS; i++)
+	{
+		profile_entries[PROFILE_EVENT_SLOTS + i].key = PROFILE_KEY_SECTION | ((uint32_t)i << 8);
+	}
+	profile_events_used = 0;
+	profile_untracked = 0;
+#endif
+}
+
+void profileDump(void)
+{
+#if INCLUDE_PROFILE
+	const profile_entry_t *entry;
+	const uint16_t *b;
+	uint8_t i;
+
+	LOG_INFO("Profile at %lu cycles/s, %lu events untracked", (unsigned long)profile_frequency,
+			 (unsigned long)profile_untracked);
+	logFlush();
+	for(i = 0; i < PROFILE_ENTRIES; i++)
+	{
+		entry = &profile_entries[i];
+		if(entry->count == 0)
+		{
+			continue;
+		}
+		if(i < PROFILE_EVENT_SLOTS)
+		{
+			LOG_INFO("evt 0x%08lx n=%lu min=%lu avg=%lu max=%lu", (unsigned long)entry->key,
+					 (unsigned long)entry->count, (unsigned long)entry->min,
+					 (unsigned long)(entry->total / entry->count), (unsigned long)entry->max);
+		}
+		else
+		{
+			LOG_INFO("%s n=%lu min=%lu avg=%lu max=%lu", profile_section_names[i - PROFILE_EVENT_SLOTS],
+					 (unsigned long)entry->count, (unsigned long)entry->min,
+					 (unsigned long)(entry->total / entry->count), (unsigned long)entry->max);
+		}
+		b = entry->buckets;
+		LOG_INFO("  <2^8..<2^15   %u %u %u %u %u %u %u %u", b[0], b[1], b[2], b[3], b[4], b[5], b[6], b[7]);
+		b += PROFILE_BUCKETS_PER_LINE;
+		LOG_INFO("  <2^16..>=2^22 %u %u %u %u %u %u %u %u", b[0], b[1], b[2], b[3], b[4], b[5], b[6], b[7]);
+		logFlush();
+	}
+#endif
+	signalReport();
+	logFlush();
+}
+
+void profileControl(struct gecko_msg_gatt_server_user_write_request_evt_t *request)
+{
+	uint8_t att_error = 0;
+
+	if(request->value.len != 1)
+	{
+		att_error = (uint8_t)bg_err_att_invalid_att_length;
+	}
+	else if(request->value.data[0] == PROFILE_CMD_RESET)
+	{
+		profileReset();
+	}
+	else if(request->value.data[0] == PROFILE_CMD_DUMP)
+	{
+		profileDump();
+	}
+	else if(request->value.data[0] == PROFILE_CMD_ENERGY)
+	{
+		energyReport();
+	}
+	else
+	{
+		att_error = (uint8_t)bg_err_att_value_not_allowed;
+	}
+	BTSTACK_CHECK_RESPONSE(gecko_cmd_gatt_server_send_user_write_response(request->connection, gattdb_event_profile,
+																		   att_error));
+}
+
+void profileRead(struct gecko_msg_gatt_server_user_read_request_evt_t *request)
+{
+#if INCLUDE_PROFILE
+	struct gecko_msg_gatt_server_get_mtu_rsp_t *mtu;
+	uint16_t len;
+
+	if(request->offset == 0)
+	{
+		profileSummarize();
+	}
+	if(request->offset > sizeof(profile_summary))
+	{
+		BTSTACK_CHECK_RESPONSE(gecko_cmd_gatt_server_send_user_read_response(request->connection,
+			gattdb_event_profile, (uint8_t)bg_err_att_invalid_offset, 0, NULL));
+		return;
+	}
+	/* A response of ATT_MTU - 1 bytes makes the client read on from the next offset */
+	len = sizeof(profile_summary) - request->offset;
+	mtu = gecko_cmd_gatt_server_get_mtu(request->connection);
+	if((mtu->result == bg_err_success) && (len > (mtu->mtu - 1)))
+	{
+		len = mtu->mtu - 1;
+	}
+	if(len > PROFILE_READ_MAX)
+	{
+		len = PROFILE_READ_MAX;
+	}
+	BTSTACK_CHECK_RESPONSE(gecko_cmd_gatt_server_send_user_read_response(request->connection, gattdb_event_profile,
+		0, (uint8_t)len, &profile_summary[request->offset]));
+#else
+	BTSTACK_CHECK_RESPONSE(gecko_cmd_gatt_server_send_user_read_response(request->connection, gattdb_event_profile,
+		0, 0, NULL));
+#endif
+}
@@ -0,0 +1,160 @@
+/*
+ * @filename	: profile.h
+ * @description	: This file contains header files for profile.c
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Cycle profile of the event handlers.  The core cycle counter, DWT CYCCNT, is
+ * read by main() before each event is handled and after its display rows are
+ * committed, and the cycles are added to the entry of its event ID: count,
+ * minimum, maximum, total and a histogram of PROFILE_BUCKETS powers of two.  The sections that block inside a handler,
+ * displayPrintf(), displayCommit() and the PS save, have an entry each.  Events
+ * after the first PROFILE_EVENT_SLOTS IDs are only counted.
+ *
+ * profileDump() writes the table to the log.  The Event Profile characteristic
+ * of the Node Diagnostics GATT service reads the table without the histograms
+ * as a profile_summary_t then PROFILE_ENTRIES profile_summary_entry_t, and takes
+ * the PROFILE_CMD_ commands.  The host build reads a host clock scaled to the
+ * core clock in place of CYCCNT, see host/include/em_device.h.
+ */
+
+#ifndef SRC_PROFILE_H_
+#define SRC_PROFILE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_device.h"
+#include "native_gecko.h"
+
+/*******************************************************************************
+ ********************************  DEFINES  ************************************
+ ******************************************************************************/
+
+#ifndef INCLUDE_PROFILE
+#define INCLUDE_PROFILE				1
+#endif
+#define PROFILE_EVENT_SLOTS			20		//Event IDs with an entry of their own
+#define PROFILE_BUCKETS				16
+#define PROFILE_BUCKET_SHIFT		8		//Bucket 0 is below 256 cycles, bucket n from 2^(n+7), the last one open
+#define PROFILE_SUMMARY_VERSION		1
+
+/* Event Profile commands, first byte of the write */
+#define PROFILE_CMD_RESET			0x00	//Empty the table
+#define PROFILE_CMD_DUMP			0x01	//Write the table to the log
+#define PROFILE_CMD_ENERGY			0x02	//Write the energy report to the log, see energy.h
+
+/* Key of a section entry, no BGAPI event ID has bits 0-2 set */
+#define PROFILE_KEY_SECTION			0x00000007UL
+
+typedef enum
+{
+	PROFILE_DISPLAY_PRINTF = 0,
+	PROFILE_DISPLAY_COMMIT,
+	PROFILE_PS_SAVE,
+	PROFILE_SECTIONS
+}eProfileSection;
+
+#define PROFILE_ENTRIES				(PROFILE_EVENT_SLOTS + PROFILE_SECTIONS)
+
+/* Start of the Event Profile value, little endian */
+typedef struct __attribute__((packed))
+{
+	uint8_t version;				//PROFILE_SUMMARY_VERSION
+	uint8_t entries;				//PROFILE_ENTRIES, the sections last
+	uint32_t frequency;				//Counter cycles per second
+	uint32_t untracked;				//Events of IDs without a slot
+}profile_summary_t;
+
+/* Entry of the Event Profile value, count 0 for an unused slot */
+typedef struct __attribute__((packed))
+{
+	uint32_t key;					//Event ID, or PROFILE_KEY_SECTION | eProfileSection << 8
+	uint32_t count;
+	uint32_t min;					//Cycles
+	uint32_t avg;
+	uint32_t max;
+}profile_summary_entry_t;
+
+/* ATT attribute values are at most 512 bytes */
+typedef char profile_summary_size_check[(sizeof(profile_summary_t) + (PROFILE_ENTRIES * sizeof(profile_summary_entry_t)) <= 512) ? 1 : -1];
+
+/*******************************************************************************
+ **************************    FUNCTION PROTOTYPES    **************************
+ ******************************************************************************/
+
+/**************************************************************************//**
+ * @brief   Start the cycle counter and empty the table
+ *
+ * @detail  Call after cmuInit(), the core clock frequency is read once
+ *
+ * @return  Void
+ *****************************************************************************/
+void profileInit(void);
+
+/**************************************************************************//**
+ * @brief   Cycle counter, for the start argument of profileEvent() and
+ * 			profileSection()
+ *
+ * @return  Cycles, wrapping every 2^32
+ *****************************************************************************/
+static inline uint32_t profileStart(void)
+{
+#if INCLUDE_PROFILE
+	return DWT->CYCCNT;
+#else
+	return 0;
+#endif
+}
+
+/**************************************************************************//**
+ * @brief   Add the cycles since start to the entry of an event ID
+ *
+ * @return  Void
+ *****************************************************************************/
+void profileEvent(uint32_t evt_id, uint32_t start);
+
+/**************************************************************************//**
+ * @brief   Add the cycles since start to the entry of a section
+ *
+ * @return  Void
+ *****************************************************************************/
+void profileSection(eProfileSection section, uint32_t start);
+
+/**************************************************************************//**
+ * @brief   Empty the table
+ *
+ * @return  Void
+ *****************************************************************************/
+void profileReset(void);
+
+/**************************************************************************//**
+ * @brief   Write the table with its histograms to the log
+ *
+ * @detail  Waits for each line to be sent, so none is dropped from the log
+ * 			ring.  The event asking for the dump takes as long as the log.
+ * 			The signal overruns follow the table, see signalReport()
+ *
+ * @return  Void
+ *****************************************************************************/
+void profileDump(void);
+
+/**************************************************************************//**
+ * @brief   Handle a write of Event Profile and send the write response
+ *
+ * @return  Void
+ *****************************************************************************/
+void profileControl(struct gecko_msg_gatt_server_user_write_request_evt_t *request);
+
+/**************************************************************************//**
+ * @brief   Send the summary of the table from the offset of a read of Event
+ * 			Profile
+ *
+ * @detail  The table is copied at the read with offset 0, the read blob
+ * 			requests that follow get the rest of that copy
+ *
+ * @return  Void
+ *****************************************************************************/
+void profileRead(struct gecko_msg_gatt_server_user_read_request_evt_t *request);
+
+#endif /* SRC_PROFILE_H_ */
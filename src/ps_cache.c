@@ -0,0 +1,308 @@
+/*
+ * @filename	: ps_cache.c
+ * @description	: This file contains the source code for the persistent store cache
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ */
+
+#include "ps_cache.h"
+#include "main.h"
+#include <stddef.h>
+#include <string.h>
+
+/*
+ * Stored in PS_RECORD_KEY as the header followed by length bytes of the record.
+ * Fields are only ever appended to the record, so a shorter record from older
+ * firmware restores the fields it has and the rest keep their defaults, and older
+ * firmware restores the leading fields of a longer record.  version is only
+ * increased when an existing field changes, records of an older version are
+ * converted by psRecordMigrate().
+ */
+typedef struct __attribute__((packed))
+{
+	uint8_t version;
+	uint8_t length;		//Record bytes following the header
+	uint16_t crc;		//CRC-16/CCITT of the record bytes
+}ps_record_header_t;
+
+typedef struct __attribute__((packed))
+{
+	int32_t high_temp;				//MAX_TEMP
+	uint8_t authorized_personnel;	//AUTHORIZED_PERSONNEL
+	uint8_t button_count;			//BUTTON_COUNT
+}ps_record_t;
+
+typedef struct
+{
+	uint16_t key;
+	uint8_t offset;
+	uint8_t size;
+}ps_field_t;
+
+/* Every persistent key of the application and where it lives in the record */
+static const ps_field_t ps_fields[] =
+{
+	{ MAX_TEMP,				offsetof(ps_record_t, high_temp),				sizeof(int32_t) },
+	{ AUTHORIZED_PERSONNEL,	offsetof(ps_record_t, authorized_personnel),	sizeof(uint8_t) },
+	{ BUTTON_COUNT,			offsetof(ps_record_t, button_count),			sizeof(uint8_t) },
+};
+
+#define PS_FIELDS	(sizeof(ps_fields) / sizeof(ps_fields[0]))
+
+typedef char ps_record_size_check[((sizeof(ps_record_header_t) + sizeof(ps_record_t)) <= PS_RECORD_MAX) ? 1 : -1];
+typedef char ps_field_count_check[(PS_FIELDS <= 32) ? 1 : -1];
+
+static ps_record_t ps_record;
+static uint32_t ps_valid = 0;			//Bit per ps_fields entry, restored or written since
+static bool ps_dirty = false;			//RAM record newer than flash
+static bool ps_legacy_keys = false;		//Record built from the per field keys, erase them once it is saved
+static bool ps_newer_record = false;	//Flash holds a record of newer firmware, never overwritten
+static bool ps_newer_warned = false;
+static uint8_t ps_pending_writes = 0;	//Writes since the last flush
+static bool ps_timer_running = false;
+
+/* CRC-16/CCITT-FALSE, the record is a few bytes so no table */
+static uint16_t psCrc16(const uint8_t *data, uint8_t len)
+{
+	uint16_t crc = 0xFFFF;
+	uint8_t bit;
+
+	while(len--)
+	{
+		crc ^= (uint16_t)(*data++) << 8;
+		for(bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+		}
+	}
+	return crc;
+}
+
+static int8_t psFieldFind(uint16_t key, uint8_t size)
+{
+	uint8_t i;
+
+	for(i = 0; i < PS_FIELDS; i++)
+	{
+		if(ps_fields[i].key == key)
+		{
+			if(size != ps_fields[i].size)
+			{
+				LOG_ERROR("PS key 0x%x accessed with size %d, stored size %d", key, size, ps_fields[i].size);
+				return -1;
+			}
+			return i;
+		}
+	}
+	LOG_ERROR("PS key 0x%x is not in the record", key);
+	return -1;
+}
+
+/* Mark the fields fully contained in the first length record bytes as restored */
+static void psRecordRestored(uint8_t length)
+{
+	uint8_t i;
+
+	for(i = 0; i < PS_FIELDS; i++)
+	{
+		if((ps_fields[i].offset + ps_fields[i].size) <= length)
+		{
+			ps_valid |= 1UL << i;
+		}
+	}
+}
+
+/*
+ * Convert a record of an older version to PS_RECORD_VERSION in place.
+ * Version 1 is the first record layout, there is nothing to convert yet.
+ */
+static bool psRecordMigrate(uint8_t version, uint8_t *length)
+{
+	(void)length;
+	return version == PS_RECORD_VERSION;
+}
+
+/* Build the record from the per field keys of firmware before the record existed */
+static void psRecordLoadLegacy(void)
+{
+	struct gecko_msg_flash_ps_load_rsp_t *resp;
+	uint8_t i;
+
+	for(i = 0; i < PS_FIELDS; i++)
+	{
+		resp = gecko_cmd_flash_ps_load(ps_fields[i].key);
+		if((resp->result == 0) && (resp->value.len == ps_fields[i].size))
+		{
+			memcpy((uint8_t *)&ps_record + ps_fields[i].offset, resp->value.data, ps_fields[i].size);
+			ps_valid |= 1UL << i;
+			ps_legacy_keys = true;
+		}
+	}
+	if(ps_legacy_keys)
+	{
+		LOG_INFO("PS record built from the per field keys");
+		ps_dirty = true;
+	}
+}
+
+void psCacheInit(void)
+{
+	struct gecko_msg_flash_ps_load_rsp_t *resp;
+	ps_record_header_t header;
+	uint8_t length;
+
+	psCacheDiscard();
+	memset(&ps_record, 0, sizeof(ps_record));
+	ps_record.high_temp = INT32_MIN;
+	ps_valid = 0;
+	ps_legacy_keys = false;
+	ps_newer_record = false;
+	ps_newer_warned = false;
+
+	resp = gecko_cmd_flash_ps_load(PS_RECORD_KEY);
+	if((resp->result != 0) || (resp->value.len < sizeof(header)))
+	{
+		LOG_WARN("No PS record, result 0x%x", resp->result);
+		psRecordLoadLegacy();
+		return;
+	}
+	memcpy(&header, resp->value.data, sizeof(header));
+	length = header.length;
+	if((length != (resp->value.len - sizeof(header))) ||
+	   (psCrc16(&resp->value.data[sizeof(header)], length) != header.crc))
+	{
+		LOG_ERROR("PS record corrupt, restoring the per field keys");
+		psRecordLoadLegacy();
+		return;
+	}
+	if(header.version > PS_RECORD_VERSION)
+	{
+		/* Written by newer firmware that changed the meaning of a field, the defaults are safer */
+		LOG_WARN("PS record version %d is newer than %d, not restored", header.version, PS_RECORD_VERSION);
+		ps_newer_record = true;
+		return;
+	}
+	if(length > sizeof(ps_record))
+	{
+		length = sizeof(ps_record); //Fields appended by newer firmware are dropped
+	}
+	memcpy(&ps_record, &resp->value.data[sizeof(header)], length);
+	if(!psRecordMigrate(header.version, &length))
+	{
+		LOG_ERROR("PS record version %d cannot be migrated", header.version);
+		memset(&ps_record, 0, sizeof(ps_record));
+		ps_record.high_temp = INT32_MIN;
+		return;
+	}
+	psRecordRestored(length);
+	if((header.version != PS_RECORD_VERSION) || (length < sizeof(ps_record)))
+	{
+		ps_dirty = true; //Saved in the current layout by the next flush
+	}
+}
+
+bool psCacheRead(uint16_t key, void *value, uint8_t size)
+{
+	int8_t field = psFieldFind(key, size);
+
+	if((field < 0) || !(ps_valid & (1UL << field)))
+	{
+		return false;
+	}
+	memcpy(value, (uint8_t *)&ps_record + ps_fields[field].offset, size);
+	return true;
+}
+
+void psCacheWrite(uint16_t key, const void *value, uint8_t size)
+{
+	int8_t field = psFieldFind(key, size);
+	uint8_t *stored;
+
+	if(field < 0)
+	{
+		return;
+	}
+	stored = (uint8_t *)&ps_record + ps_fields[field].offset;
+	if((ps_valid & (1UL << field)) && (memcmp(stored, value, size) == 0))
+	{
+		return;
+	}
+	memcpy(stored, value, size);
+	ps_valid |= 1UL << field;
+	ps_dirty = true;
+	if(++ps_pending_writes >= PS_CACHE_FLUSH_THRESHOLD)
+	{
+		psCacheFlush();
+	}
+	else if(!ps_timer_running)
+	{
+		ps_timer_running = true;
+		BTSTACK_CHECK_RESPONSE(gecko_cmd_hardware_set_soft_timer((PS_CACHE_FLUSH_DELAY_MS * 32768UL) / 1000,
+																 TIMER_ID_PS_FLUSH, 1));
+	}
+}
+
+void psCacheFlush(void)
+{
+	struct gecko_msg_flash_ps_save_rsp_t *resp;
+	uint8_t buf[sizeof(ps_record_header_t) + sizeof(ps_record_t)];
+	ps_record_header_t header;
+	uint32_t cycles;
+	uint8_t i;
+
+	if(ps_timer_running)
+	{
+		ps_timer_running = false;
+		gecko_cmd_hardware_set_soft_timer(0, TIMER_ID_PS_FLUSH, 1);
+	}
+	ps_pending_writes = 0;
+	if(!ps_dirty)
+	{
+		return;
+	}
+	if(ps_newer_record)
+	{
+		/* Kept for the newer firmware to restore after an upgrade, this one runs from RAM */
+		if(!ps_newer_warned)
+		{
+			LOG_WARN("PS record of newer firmware kept, changes are not saved");
+			ps_newer_warned = true;
+		}
+		ps_dirty = false;
+		return;
+	}
+	header.version = PS_RECORD_VERSION;
+	header.length = sizeof(ps_record);
+	header.crc = psCrc16((const uint8_t *)&ps_record, sizeof(ps_record));
+	memcpy(buf, &header, sizeof(header));
+	memcpy(&buf[sizeof(header)], &ps_record, sizeof(ps_record));
+	cycles = profileStart();
+	resp = gecko_cmd_flash_ps_save(PS_RECORD_KEY, sizeof(buf), buf);
+	profileSection(PROFILE_PS_SAVE, cycles);
+	if(resp->result != 0)
+	{
+		LOG_ERROR("Error saving the PS record, result 0x%x", resp->result);
+		return; //Stays dirty, retried by the next flush
+	}
+	ps_dirty = false;
+	if(ps_legacy_keys)
+	{
+		for(i = 0; i < PS_FIELDS; i++)
+		{
+			gecko_cmd_flash_ps_erase(ps_fields[i].key);
+		}
+		ps_legacy_keys = false;
+	}
+}
+
+void psCacheDiscard(void)
+{
+	if(ps_timer_running)
+	{
+		ps_timer_running = false;
+		gecko_cmd_hardware_set_soft_timer(0, TIMER_ID_PS_FLUSH, 1);
+	}
+	ps_dirty = false;
+	ps_pending_writes = 0;
+}
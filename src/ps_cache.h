@@ -0,0 +1,92 @@
+/*
+ * @filename	: ps_cache.h
+ * @description	: This file contains header files for ps_cache.c
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Write back RAM cache of the application persistent store keys.  The keys are
+ * fields of one versioned, CRC protected record stored in PS_RECORD_KEY, so the
+ * whole application state is restored with one PS load when the node is
+ * initialized, however many keys are added.  Reads are served from RAM.  Writes
+ * only mark the record dirty, it is saved with one PS save when the flush timer
+ * expires, when PS_CACHE_FLUSH_THRESHOLD writes are pending, or when
+ * psCacheFlush() is called before a reset.  Writing the value a key already
+ * holds does not touch flash at all.
+ */
+
+#ifndef SRC_PS_CACHE_H_
+#define SRC_PS_CACHE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ ********************************  DEFINES  ************************************
+ ******************************************************************************/
+
+#define TIMER_ID_PS_FLUSH			(2)		//Soft timer flushing the dirty keys
+#define PS_CACHE_FLUSH_DELAY_MS		10000	//Longest time a write stays in RAM only
+#define PS_CACHE_FLUSH_THRESHOLD	8		//Pending writes that flush without waiting for the timer
+#define PS_RECORD_KEY				(0xd000)	//PS key holding the record
+#define PS_RECORD_VERSION			1		//Increase only when an existing field changes, not to append one
+#define PS_RECORD_MAX				56		//Largest value gecko_cmd_flash_ps_save() takes
+
+/*******************************************************************************
+ **************************    FUNCTION PROTOTYPES    **************************
+ ******************************************************************************/
+
+/**************************************************************************//**
+ * @brief   Restore the record from flash
+ *
+ * @detail  Pending writes are discarded.  Without a valid record the keys
+ * 			stored one by one by older firmware are restored instead, and the
+ * 			record replaces them at the next flush.  A record of a newer
+ * 			version is not restored and never overwritten, the node runs from
+ * 			the defaults in RAM until it is upgraded again.  Call once the
+ * 			stack is booted, before the first psCacheRead()
+ *
+ * @return  Void
+ *****************************************************************************/
+void psCacheInit(void);
+
+/**************************************************************************//**
+ * @brief   Read a key from the cache
+ *
+ * @detail  value is left unchanged if the key was never written or is not in
+ * 			the stored record
+ *
+ * @return  true if value was filled in
+ *****************************************************************************/
+bool psCacheRead(uint16_t key, void *value, uint8_t size);
+
+/**************************************************************************//**
+ * @brief   Write a key to the cache
+ *
+ * @detail  The key is written to flash by the next flush, nothing happens if
+ * 			the value is unchanged
+ *
+ * @return  Void
+ *****************************************************************************/
+void psCacheWrite(uint16_t key, const void *value, uint8_t size);
+
+/**************************************************************************//**
+ * @brief   Save the record to flash if any key changed
+ *
+ * @detail  Call before any reset, and on expiry of TIMER_ID_PS_FLUSH.  Does
+ * 			not save over a record of newer firmware, warns once instead
+ *
+ * @return  Void
+ *****************************************************************************/
+void psCacheFlush(void);
+
+/**************************************************************************//**
+ * @brief   Drop all pending writes
+ *
+ * @detail  For a factory reset, so the erased keys are not written back
+ *
+ * @return  Void
+ *****************************************************************************/
+void psCacheDiscard(void);
+
+#endif /* SRC_PS_CACHE_H_ */
@@ -0,0 +1,100 @@
+/*
+ * @filename	: signals.c
+ * @description	: This file contains the source code for external signal dispatch
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ */
+
+#include "signals.h"
+#include "main.h"
+
+static const char *const signal_names[SIGNAL_COUNT] =
+{
+	[SIGNAL_I2C_DONE] = "i2c",
+	[SIGNAL_LETIMER_COMP1] = "comp1",
+	[SIGNAL_LETIMER_UF] = "uf",
+	[SIGNAL_PB0] = "pb0",
+	[SIGNAL_PIR] = "pir",
+};
+
+static signal_handler_t signal_handlers[SIGNAL_COUNT];
+static volatile uint32_t signal_overruns[SIGNAL_COUNT];
+static volatile uint32_t signals_pending = 0;
+
+void signalHandlerRegister(eSignal signal, signal_handler_t handler)
+{
+	if(signal < SIGNAL_COUNT)
+	{
+		signal_handlers[signal] = handler;
+	}
+}
+
+void signalPost(eSignal signal)
+{
+	CORE_DECLARE_IRQ_STATE;
+	uint32_t mask = SIGNAL_MASK(signal);
+
+	CORE_ENTER_CRITICAL(); //Critical section starts
+	if(signals_pending & mask)
+	{
+		signal_overruns[signal]++; //Previous post not handled yet, this one merges into it
+	}
+	signals_pending |= mask;
+	gecko_external_signal(mask);
+	CORE_EXIT_CRITICAL(); //Critical section ends
+}
+
+void signalDispatch(uint32_t extsignals)
+{
+	CORE_DECLARE_IRQ_STATE;
+	eSignal signal;
+
+	CORE_ENTER_CRITICAL(); //Critical section starts
+	signals_pending &= ~extsignals; //Posts from now on are new events
+	CORE_EXIT_CRITICAL(); //Critical section ends
+
+	for(signal = 0; signal < SIGNAL_COUNT; signal++)
+	{
+		if((extsignals & SIGNAL_MASK(signal)) == 0)
+		{
+			continue;
+		}
+		if(signal_handlers[signal] != NULL)
+		{
+			signal_handlers[signal]();
+		}
+		else
+		{
+			LOG_WARN("No handler registered for signal %d", signal);
+		}
+	}
+}
+
+uint32_t signalOverrunCount(eSignal signal)
+{
+	if(signal < SIGNAL_COUNT)
+	{
+		return signal_overruns[signal];
+	}
+	return 0;
+}
+
+const char *signalName(eSignal signal)
+{
+	if(signal < SIGNAL_COUNT)
+	{
+		return signal_names[signal];
+	}
+	return "?";
+}
+
+void signalReport(void)
+{
+	eSignal signal;
+
+	for(signal = 0; signal < SIGNAL_COUNT; signal++)
+	{
+		LOG_INFO("signal %s overruns=%lu", signalName(signal), (unsigned long)signal_overruns[signal]);
+	}
+}
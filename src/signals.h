@@ -0,0 +1,94 @@
+/*
+ * @filename	: signals.h
+ * @description	: This file contains header files for signals.c
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ */
+
+#ifndef SRC_SIGNALS_H_
+#define SRC_SIGNALS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ ********************************  DEFINES  ************************************
+ ******************************************************************************/
+
+/*
+ * One external signal bit per interrupt source.  gecko_external_signal() ORs
+ * pending bits together, so every source needs its own bit.  Handlers run in
+ * bit order, lowest bit first, so the order below is also the dispatch priority.
+ */
+typedef enum
+{
+	SIGNAL_I2C_DONE = 0,		//I2C0 transfer complete
+	SIGNAL_LETIMER_COMP1,		//LETIMER0 software timer expired
+	SIGNAL_LETIMER_UF,			//LETIMER0 underflow, start of a humidity measurement
+	SIGNAL_PB0,					//PB0 pressed or released
+	SIGNAL_PIR,					//PIR sensor detected motion
+	SIGNAL_COUNT
+}eSignal;
+
+#define SIGNAL_MASK(signal)		(1UL << (signal))
+
+typedef void (*signal_handler_t)(void);
+
+/*******************************************************************************
+ **************************    FUNCTION PROTOTYPES    **************************
+ ******************************************************************************/
+
+/**************************************************************************//**
+ * @brief   Register the handler for a signal
+ *
+ * @detail  Replaces any handler previously registered for the signal
+ *
+ * @return  Void
+ *****************************************************************************/
+void signalHandlerRegister(eSignal signal, signal_handler_t handler);
+
+/**************************************************************************//**
+ * @brief   Post a signal to the main loop
+ *
+ * @detail  Safe to call from ISR context.  If the signal is still pending from
+ * 			an earlier post, the overrun counter for the signal is incremented
+ *
+ * @return  Void
+ *****************************************************************************/
+void signalPost(eSignal signal);
+
+/**************************************************************************//**
+ * @brief   Dispatch the signals of a gecko_evt_system_external_signal_id event
+ *
+ * @detail  Runs the handler of every bit set in extsignals, in priority order
+ *
+ * @return  Void
+ *****************************************************************************/
+void signalDispatch(uint32_t extsignals);
+
+/**************************************************************************//**
+ * @brief   Number of posts of a signal merged into an earlier pending post
+ *
+ * @return  Overrun count since boot
+ *****************************************************************************/
+uint32_t signalOverrunCount(eSignal signal);
+
+/**************************************************************************//**
+ * @brief   Short name of a signal, for reports
+ *
+ * @return  Name, "?" for a value that is not a signal
+ *****************************************************************************/
+const char *signalName(eSignal signal);
+
+/**************************************************************************//**
+ * @brief   Write the overrun count of every signal to the log
+ *
+ * @detail  One line per signal.  Called by profileDump(), so the counts come
+ * 			out with the profile on a dump request
+ *
+ * @return  Void
+ *****************************************************************************/
+void signalReport(void);
+
+#endif /* SRC_SIGNALS_H_ */
@@ -8,55 +8,48 @@
  */
 #include "state_machine.h"
 
-bool interrupt_flag;
+#define POWER_UP_TIME_MS	80	//Time needed for power to stabilize
+#define CONVERSION_TIME_MS	10	//Wait for write complete
 
+static void power_up(void)
+{
+	energyBlockBegin(ENERGY_CAUSE_I2C, sleepEM2);
+	LPM_On(); //Turn on GPIO pins for I2C
+}
+
+static void power_off(void)
+{
+	Get_Humidity(); //Calculate humidity read
+	LPM_Off();  //Turn off GPIO pins for I2C
+	energyBlockEnd(ENERGY_CAUSE_I2C, sleepEM2);
+	Hum_Buffer(); //Loading humidity buffer with appropriate values
+}
+
+static void humidity_timeout(void)
+{
+	fsmDispatch(&humidity_fsm, HUM_EVENT_TIMEOUT);
+}
 
-void state(void)
+static void humidity_timer_start(uint32_t ms)
 {
+	timerSetEventInMs(TIMER_HANDLE_HUMIDITY, ms, false, humidity_timeout);
+}
 
-		switch(eNextState)
-		{
-
-		case POWER_OFF: //LOG_INFO("POWER_OFF STATE");
-			eNextState = POWER_UP;
-			LPM_Off();  //Turn off GPIO pins for I2C
-			SLEEP_SleepBlockEnd(sleepEM2);
-			CORE_DECLARE_IRQ_STATE;
-			CORE_ENTER_CRITICAL(); //Critical section starts
-			interrupt_flag = false;
-			CORE_EXIT_CRITICAL(); //Critical section ends
-		break;
-
-		case POWER_UP:
-//			LOG_INFO("POWER_UP STATE");
-			eNextState = WRITE_START;
-			SLEEP_SleepBlockBegin(sleepEM2);
-			LPM_On(); //Turn on GPIO pins for I2C
-		break;
-
-		case WRITE_START:
-//			LOG_INFO("WRITE_START STATE");
-			eNextState = WRITE_COMPLETE;
-			I2C_Write(); //Initiate I2C write
-		break;
-
-		case WRITE_COMPLETE:
-//			LOG_INFO("WRITE_COMPLETE STATE");
-			eNextState = READ_START;
-			timerWaitMs(10); //Wait for write complete
-		break;
-
-		case READ_START:
-//			LOG_INFO("READ_START STATE");
-			eNextState = READ_COMPLETE;
-			I2C_Read(); //Initiate I2C read
-		break;
-
-		case READ_COMPLETE:
-//			LOG_INFO("READ_COMPLETE STATE");
-			eNextState = POWER_OFF;
-			Get_Humidity(); //Calculate temperature read
-			gecko_external_signal(0x01); //Setting signal event for next state
-		break;
-		}
+#define HUM_TRANSITION(state, event, action, next, timeout_ms) \
+	FSM_TRANSITION(HUM_STATE_COUNT, HUM_EVENT_COUNT, state, event, action, next, timeout_ms)
+
+static const fsm_transition_t humidity_table[HUM_STATE_COUNT][HUM_EVENT_COUNT] =
+{
+	HUM_TRANSITION(HUM_STATE_OFF,		HUM_EVENT_PERIOD,	power_up,		HUM_STATE_POWER_UP,	POWER_UP_TIME_MS),
+	HUM_TRANSITION(HUM_STATE_POWER_UP,	HUM_EVENT_TIMEOUT,	I2C_Write,		HUM_STATE_WRITE,	0),
+	HUM_TRANSITION(HUM_STATE_WRITE,		HUM_EVENT_I2C_DONE,	NULL,			HUM_STATE_CONVERT,	CONVERSION_TIME_MS),
+	HUM_TRANSITION(HUM_STATE_CONVERT,	HUM_EVENT_TIMEOUT,	I2C_Read,		HUM_STATE_READ,		0),
+	HUM_TRANSITION(HUM_STATE_READ,		HUM_EVENT_I2C_DONE,	power_off,		HUM_STATE_OFF,		0),
+};
+
+fsm_t humidity_fsm = FSM_INIT(humidity_table, HUM_STATE_OFF, humidity_timer_start);
+
+void state(eEvent event)
+{
+	fsmDispatch(&humidity_fsm, event);
 }
@@ -11,32 +11,44 @@
 
 #include <stdbool.h>
 #include "em_core.h"
+#include "fsm.h"
 #include "main.h"
 
 #define SCHEDULER_SUPPORTS_DISPLAY_UPDATE_EVENT 1
 
+/* States of the humidity sensor pipeline, named after what the state waits for */
 typedef enum
 {
-	POWER_OFF=1,
-	POWER_UP,
-	WRITE_START,
-	WRITE_COMPLETE,
-	READ_START,
-	READ_COMPLETE
+	HUM_STATE_OFF=0,		//Sensor unpowered, waiting for the next measurement period
+	HUM_STATE_POWER_UP,		//Waiting for load power to stabilize
+	HUM_STATE_WRITE,		//Waiting for the measure command write to complete
+	HUM_STATE_CONVERT,		//Waiting for the sensor conversion time
+	HUM_STATE_READ,			//Waiting for the measurement read to complete
+	HUM_STATE_COUNT
 }eState;
-extern eState eNextState;
+
+/* Events of the humidity sensor pipeline */
+typedef enum
+{
+	HUM_EVENT_TIMEOUT = FSM_EVENT_TIMEOUT,	//Transition timeout expired
+	HUM_EVENT_PERIOD,						//Start of a measurement period
+	HUM_EVENT_I2C_DONE,						//I2C transfer finished
+	HUM_EVENT_COUNT
+}eEvent;
+
+extern fsm_t humidity_fsm;
 
 /*******************************************************************************
  **************************    FUNCTION PROTOTYPES    **************************
  ******************************************************************************/
 
 /**************************************************************************//**
- * @brief   State machine implementation
+ * @brief   Deliver an event to the humidity state machine
  *
- * @detail  Different states for I2C transfer of Temperature
+ * @detail  Different states for I2C transfer of Humidity, see humidity_table
  *
  * @return  Void
  *****************************************************************************/
-void state(void);
+void state(eEvent event);
 
 #endif /* SRC_STATE_MACHINE_H_ */
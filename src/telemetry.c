@@ -0,0 +1,253 @@
+/*
+ * @filename	: telemetry.c
+ * @description	: This file contains the source code for the Live Telemetry characteristic
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ */
+
+#include "telemetry.h"
+#include "gatt_db.h"
+#include "gecko_ble_errors.h"
+#include "timebase.h"
+#include "log.h"
+#include <string.h>
+
+#define TELEMETRY_NO_CONNECTION		0xFF
+#define TELEMETRY_RETRY_MS			50		//Wait when the stack has no buffer for the notification
+#define MS_TO_TICKS(ms)				(((uint32_t)(ms) * 32768UL) / 1000)
+
+typedef struct
+{
+	uint8_t connection;							//TELEMETRY_NO_CONNECTION when the slot is free
+	bool pending;								//Change past the deadband not sent yet
+	uint32_t sent_ms;							//timebaseGetMs() of the last notification
+	int32_t sent[TELEMETRY_FIELD_COUNT];		//Readings of the last notification
+	uint8_t sent_alerts;
+}telemetry_client_t;
+
+static const int32_t telemetry_deadband[TELEMETRY_FIELD_COUNT] =
+{
+	[TELEMETRY_HUMIDITY] = TELEMETRY_DEADBAND_HUMIDITY,
+	[TELEMETRY_TEMPERATURE] = TELEMETRY_DEADBAND_TEMPERATURE,
+	[TELEMETRY_DISTANCE] = TELEMETRY_DEADBAND_DISTANCE,
+	[TELEMETRY_ACCELERATION] = TELEMETRY_DEADBAND_ACCELERATION,
+};
+
+static int32_t telemetry_values[TELEMETRY_FIELD_COUNT] =
+{
+	TELEMETRY_UNKNOWN, TELEMETRY_UNKNOWN, TELEMETRY_UNKNOWN, TELEMETRY_UNKNOWN
+};
+static uint8_t telemetry_alerts = 0;
+static telemetry_client_t telemetry_clients[TELEMETRY_MAX_CLIENTS];		//Freed by telemetryInit()
+static bool telemetry_ready = false;
+
+/* Slots are counted in a uint8_t and no connection handle reaches TELEMETRY_NO_CONNECTION */
+typedef char telemetry_clients_check[((TELEMETRY_MAX_CLIENTS > 0) && (TELEMETRY_MAX_CLIENTS < TELEMETRY_NO_CONNECTION)) ? 1 : -1];
+
+static void telemetryPack(telemetry_t *value)
+{
+	value->humidity = telemetry_values[TELEMETRY_HUMIDITY];
+	value->temperature = telemetry_values[TELEMETRY_TEMPERATURE];
+	value->distance = telemetry_values[TELEMETRY_DISTANCE];
+	value->acceleration = (telemetry_values[TELEMETRY_ACCELERATION] == TELEMETRY_UNKNOWN) ?
+						  INT16_MIN : (int16_t)telemetry_values[TELEMETRY_ACCELERATION];
+	value->alerts = telemetry_alerts;
+}
+
+/* A reading moved past its deadband, or the alerts changed, since the client was last notified */
+static bool telemetryChanged(const telemetry_client_t *client)
+{
+	int64_t delta;
+	uint8_t i;
+
+	if(client->sent_alerts != telemetry_alerts)
+	{
+		return true;
+	}
+	for(i = 0; i < TELEMETRY_FIELD_COUNT; i++)
+	{
+		delta = (int64_t)telemetry_values[i] - client->sent[i];
+		if((delta > telemetry_deadband[i]) || (delta < -telemetry_deadband[i]))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/* Notify the pending clients whose interval has passed and arm the timer for the others */
+static void telemetryService(void)
+{
+	telemetry_t value;
+	telemetry_client_t *client;
+	uint32_t now = (uint32_t)timebaseGetMs();
+	uint32_t elapsed, wait_ms = UINT32_MAX;
+	uint16 result;
+	uint8_t i;
+
+	if(!telemetry_ready)
+	{
+		return;
+	}
+	telemetryPack(&value);
+	for(i = 0; i < TELEMETRY_MAX_CLIENTS; i++)
+	{
+		client = &telemetry_clients[i];
+		if(client->connection == TELEMETRY_NO_CONNECTION)
+		{
+			continue;
+		}
+		client->pending = client->pending || telemetryChanged(client);
+		if(!client->pending)
+		{
+			continue;
+		}
+		elapsed = now - client->sent_ms;
+		if(elapsed < TELEMETRY_MIN_INTERVAL_MS)
+		{
+			if((TELEMETRY_MIN_INTERVAL_MS - elapsed) < wait_ms)
+			{
+				wait_ms = TELEMETRY_MIN_INTERVAL_MS - elapsed;
+			}
+			continue;
+		}
+		result = gecko_cmd_gatt_server_send_characteristic_notification(client->connection, gattdb_live_telemetry,
+																		sizeof(value), (const uint8 *)&value)->result;
+		if(result == bg_err_success)
+		{
+			client->pending = false;
+			client->sent_ms = now;
+			memcpy(client->sent, telemetry_values, sizeof(client->sent));
+			client->sent_alerts = telemetry_alerts;
+		}
+		else if(result == bg_err_out_of_memory)
+		{
+			if(TELEMETRY_RETRY_MS < wait_ms)
+			{
+				wait_ms = TELEMETRY_RETRY_MS;
+			}
+		}
+		else
+		{
+			LOG_ERROR("Telemetry notification to connection %d failed, result 0x%x", client->connection, result);
+			client->pending = false;
+		}
+	}
+	if(wait_ms != UINT32_MAX)
+	{
+		BTSTACK_CHECK_RESPONSE(gecko_cmd_hardware_set_soft_timer(MS_TO_TICKS(wait_ms), TIMER_ID_TELEMETRY, 1));
+	}
+}
+
+/* Update the value read by clients and notify the changes */
+static void telemetryUpdate(void)
+{
+	telemetry_t value;
+
+	if(!telemetry_ready)
+	{
+		return;
+	}
+	telemetryPack(&value);
+	BTSTACK_CHECK_RESPONSE(gecko_cmd_gatt_server_write_attribute_value(gattdb_live_telemetry, 0, sizeof(value),
+																	   (const uint8 *)&value));
+	telemetryService();
+}
+
+void telemetryInit(void)
+{
+	uint8_t i;
+
+	/* Connections do not outlive a boot */
+	memset(telemetry_clients, 0, sizeof(telemetry_clients));
+	for(i = 0; i < TELEMETRY_MAX_CLIENTS; i++)
+	{
+		telemetry_clients[i].connection = TELEMETRY_NO_CONNECTION;
+	}
+	telemetry_ready = true;
+	telemetryUpdate();
+}
+
+void telemetrySet(eTelemetryField field, int32_t value)
+{
+	if((field >= TELEMETRY_FIELD_COUNT) || (telemetry_values[field] == value))
+	{
+		return;
+	}
+	telemetry_values[field] = value;
+	telemetryUpdate();
+}
+
+void telemetryAlertSet(uint8_t alerts)
+{
+	if((telemetry_alerts | alerts) == telemetry_alerts)
+	{
+		return;
+	}
+	telemetry_alerts |= alerts;
+	telemetryUpdate();
+}
+
+void telemetryAlertsClear(void)
+{
+	if(telemetry_alerts == 0)
+	{
+		return;
+	}
+	telemetry_alerts = 0;
+	telemetryUpdate();
+}
+
+void telemetryStatus(struct gecko_msg_gatt_server_characteristic_status_evt_t *status)
+{
+	telemetry_client_t *client = NULL;
+	uint8_t i;
+
+	if((status->characteristic != gattdb_live_telemetry) || (status->status_flags != gatt_server_client_config))
+	{
+		return;
+	}
+	telemetryConnectionClosed(status->connection);
+	if((status->client_config_flags & gatt_notification) == 0)
+	{
+		return;
+	}
+	for(i = 0; i < TELEMETRY_MAX_CLIENTS; i++)
+	{
+		if(telemetry_clients[i].connection == TELEMETRY_NO_CONNECTION)
+		{
+			client = &telemetry_clients[i];
+			break;
+		}
+	}
+	if(client == NULL)
+	{
+		LOG_WARN("No telemetry slot for connection %d", status->connection);
+		return;
+	}
+	client->connection = status->connection;
+	client->pending = true;			//Current value goes out right away
+	client->sent_ms = (uint32_t)timebaseGetMs() - TELEMETRY_MIN_INTERVAL_MS;
+	LOG_INFO("Telemetry notifications enabled on connection %d", status->connection);
+	telemetryService();
+}
+
+void telemetryConnectionClosed(uint8_t connection)
+{
+	uint8_t i;
+
+	for(i = 0; i < TELEMETRY_MAX_CLIENTS; i++)
+	{
+		if(telemetry_clients[i].connection == connection)
+		{
+			telemetry_clients[i].connection = TELEMETRY_NO_CONNECTION;
+			telemetry_clients[i].pending = false;
+		}
+	}
+}
+
+void telemetryTimer(void)
+{
+	telemetryService();
+}
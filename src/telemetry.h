@@ -0,0 +1,137 @@
+/*
+ * @filename	: telemetry.h
+ * @description	: This file contains header files for telemetry.c
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Live Telemetry characteristic of the Patient Telemetry GATT service.  Its
+ * value is a telemetry_t holding the latest reading of every sensor and the
+ * alerts raised since they were last cleared.  The value can always be read.
+ * A client that enables notifications is notified when a reading moves past
+ * its deadband from the value that client was last sent, or when the alerts
+ * change, at most once per TELEMETRY_MIN_INTERVAL_MS.  A change inside the
+ * interval is sent, with every later change, when the interval ends.
+ */
+
+#ifndef SRC_TELEMETRY_H_
+#define SRC_TELEMETRY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "native_gecko.h"
+#include "ble_mesh_device_type.h"
+
+/*******************************************************************************
+ ********************************  DEFINES  ************************************
+ ******************************************************************************/
+
+#define TIMER_ID_TELEMETRY			(4)		//Soft timer sending the notifications held back
+#define TELEMETRY_MAX_CLIENTS		MAX_CONNECTIONS		//One client per connection
+#define TELEMETRY_UNKNOWN			INT32_MIN	//Reading not received yet
+
+/* Shortest time between two notifications to a client */
+#ifndef TELEMETRY_MIN_INTERVAL_MS
+#define TELEMETRY_MIN_INTERVAL_MS		1000
+#endif
+/* Change of a reading that is notified, in the units of the reading */
+#ifndef TELEMETRY_DEADBAND_HUMIDITY
+#define TELEMETRY_DEADBAND_HUMIDITY		100		//1 %RH
+#endif
+#ifndef TELEMETRY_DEADBAND_TEMPERATURE
+#define TELEMETRY_DEADBAND_TEMPERATURE	10		//0.1 degree Celsius
+#endif
+#ifndef TELEMETRY_DEADBAND_DISTANCE
+#define TELEMETRY_DEADBAND_DISTANCE		100
+#endif
+#ifndef TELEMETRY_DEADBAND_ACCELERATION
+#define TELEMETRY_DEADBAND_ACCELERATION	100
+#endif
+
+/* Bits of the alert bitmap */
+#define TELEMETRY_ALERT_FEVER		0x01
+#define TELEMETRY_ALERT_FAINT		0x02
+#define TELEMETRY_ALERT_INTRUSION	0x04
+
+typedef enum
+{
+	TELEMETRY_HUMIDITY = 0,			//Hundredths of %RH, from the Si7021
+	TELEMETRY_TEMPERATURE,			//Hundredths of a degree Celsius, last patient reading
+	TELEMETRY_DISTANCE,				//Ultrasonic distance in hundredths, last caretaker reading
+	TELEMETRY_ACCELERATION,			//Raw accelerometer level, last patient reading
+	TELEMETRY_FIELD_COUNT
+}eTelemetryField;
+
+/* Value of the characteristic, little endian.  TELEMETRY_UNKNOWN, or INT16_MIN for acceleration, until a reading arrives */
+typedef struct __attribute__((packed))
+{
+	int32_t humidity;
+	int32_t temperature;
+	int32_t distance;
+	int16_t acceleration;
+	uint8_t alerts;					//TELEMETRY_ALERT_ bits
+}telemetry_t;
+
+typedef char telemetry_size_check[(sizeof(telemetry_t) == 15) ? 1 : -1];	//Length in gatt.xml
+
+/*******************************************************************************
+ **************************    FUNCTION PROTOTYPES    **************************
+ ******************************************************************************/
+
+/**************************************************************************//**
+ * @brief   Write the current value to the GATT database
+ *
+ * @detail  Call on the system boot event.  Frees every client slot.  Readings
+ * 			set before only update RAM
+ *
+ * @return  Void
+ *****************************************************************************/
+void telemetryInit(void);
+
+/**************************************************************************//**
+ * @brief   Update a reading
+ *
+ * @return  Void
+ *****************************************************************************/
+void telemetrySet(eTelemetryField field, int32_t value);
+
+/**************************************************************************//**
+ * @brief   Raise alerts
+ *
+ * @return  Void
+ *****************************************************************************/
+void telemetryAlertSet(uint8_t alerts);
+
+/**************************************************************************//**
+ * @brief   Clear all alerts
+ *
+ * @return  Void
+ *****************************************************************************/
+void telemetryAlertsClear(void);
+
+/**************************************************************************//**
+ * @brief   Track the client configuration of Live Telemetry
+ *
+ * @detail  A client enabling notifications is sent the current value
+ *
+ * @return  Void
+ *****************************************************************************/
+void telemetryStatus(struct gecko_msg_gatt_server_characteristic_status_evt_t *status);
+
+/**************************************************************************//**
+ * @brief   Forget the client of a closed connection
+ *
+ * @return  Void
+ *****************************************************************************/
+void telemetryConnectionClosed(uint8_t connection);
+
+/**************************************************************************//**
+ * @brief   Send the notifications held back by the rate limit
+ *
+ * @detail  Call when TIMER_ID_TELEMETRY expires
+ *
+ * @return  Void
+ *****************************************************************************/
+void telemetryTimer(void);
+
+#endif /* SRC_TELEMETRY_H_ */
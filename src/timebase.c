@@ -0,0 +1,64 @@
+/*
+ * @filename	: timebase.c
+ * @description	: This file contains the source code for the monotonic timebase
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ */
+
+#include "timebase.h"
+#include "sl_sleeptimer.h"
+#include <stdbool.h>
+
+static uint32_t timebase_freq = 0;
+static uint8_t timebase_shift = 0;		//log2(timebase_freq) when it is a power of two
+static bool timebase_pow2 = false;
+
+void timebaseInit(void)
+{
+	uint32_t freq;
+
+	sl_sleeptimer_init(); //Does nothing if already initialized
+	freq = sl_sleeptimer_get_timer_frequency();
+
+	/* The RTCC runs from LFXO, 32768 Hz or a divided power of two, so the ms conversion is a shift */
+	timebase_pow2 = (freq != 0) && ((freq & (freq - 1)) == 0);
+	timebase_shift = 0;
+	while(timebase_pow2 && ((1UL << timebase_shift) < freq))
+	{
+		timebase_shift++;
+	}
+	timebase_freq = freq;
+}
+
+uint64_t timebaseGetTicks(void)
+{
+	if(timebase_freq == 0)
+	{
+		return 0;
+	}
+	return sl_sleeptimer_get_tick_count64();
+}
+
+uint32_t timebaseGetFrequency(void)
+{
+	return timebase_freq;
+}
+
+uint64_t timebaseTicksToMs(uint64_t ticks)
+{
+	if(timebase_freq == 0)
+	{
+		return 0;
+	}
+	if(timebase_pow2)
+	{
+		return (ticks * 1000) >> timebase_shift;
+	}
+	return ((ticks / timebase_freq) * 1000) + (((ticks % timebase_freq) * 1000) / timebase_freq);
+}
+
+uint64_t timebaseGetMs(void)
+{
+	return timebaseTicksToMs(timebaseGetTicks());
+}
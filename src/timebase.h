@@ -0,0 +1,61 @@
+/*
+ * @filename	: timebase.h
+ * @description	: This file contains header files for timebase.c
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Single monotonic clock for the application.  Log timestamps, run time and
+ * sample timestamps all read this clock so they can be compared with each other.
+ * It is the 64 bit sleeptimer tick count, which runs from boot in EM0 to EM3 and
+ * never wraps in practice.  All functions are safe to call from ISR context.
+ */
+
+#ifndef SRC_TIMEBASE_H_
+#define SRC_TIMEBASE_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+ **************************    FUNCTION PROTOTYPES    **************************
+ ******************************************************************************/
+
+/**************************************************************************//**
+ * @brief   Initialize the timebase
+ *
+ * @detail  Starts the sleeptimer if the stack has not done so yet and caches
+ * 			its frequency.  Call before logInit()
+ *
+ * @return  Void
+ *****************************************************************************/
+void timebaseInit(void);
+
+/**************************************************************************//**
+ * @brief   Ticks since boot
+ *
+ * @return  64 bit tick count, 0 before timebaseInit()
+ *****************************************************************************/
+uint64_t timebaseGetTicks(void);
+
+/**************************************************************************//**
+ * @brief   Tick frequency
+ *
+ * @return  Ticks per second, 0 before timebaseInit()
+ *****************************************************************************/
+uint32_t timebaseGetFrequency(void);
+
+/**************************************************************************//**
+ * @brief   Convert a tick count or interval to milliseconds
+ *
+ * @return  Milliseconds, rounded down
+ *****************************************************************************/
+uint64_t timebaseTicksToMs(uint64_t ticks);
+
+/**************************************************************************//**
+ * @brief   Milliseconds since boot
+ *
+ * @return  64 bit millisecond count
+ *****************************************************************************/
+uint64_t timebaseGetMs(void);
+
+#endif /* SRC_TIMEBASE_H_ */
@@ -0,0 +1,164 @@
+/*
+ * @filename	: trace.c
+ * @description	: This file contains the source code for the event trace recorder
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ */
+
+#include "trace.h"
+#include "timebase.h"
+#include "gpio.h"
+#include <string.h>
+
+#if INCLUDE_TRACE
+/* Not static, a debugger saves it by name */
+trace_image_t trace_image;
+#endif
+
+/* Copy into the ring at offset, wrapping at the end */
+static void traceRingWrite(uint8_t *ring, uint32_t size, uint32_t offset, const void *data, uint32_t len)
+{
+	uint32_t first = ((size - offset) < len) ? (size - offset) : len;
+
+	memcpy(&ring[offset], data, first);
+	memcpy(ring, (const uint8_t *)data + first, len - first);
+}
+
+/* Copy out of the ring from offset, wrapping at the end */
+static void traceRingRead(const uint8_t *ring, uint32_t size, uint32_t offset, void *data, uint32_t len)
+{
+	uint32_t first = ((size - offset) < len) ? (size - offset) : len;
+
+	memcpy(data, &ring[offset], first);
+	memcpy((uint8_t *)data + first, ring, len - first);
+}
+
+/* Bytes of the record with this BGAPI header */
+static uint32_t traceRecordSize(uint32_t header)
+{
+	uint32_t len = BGLIB_MSG_LEN(header);
+
+	return TRACE_RECORD_HEADER_SIZE + ((len > TRACE_PAYLOAD_MAX) ? TRACE_PAYLOAD_MAX : len);
+}
+
+void traceInit(void)
+{
+#if INCLUDE_TRACE
+	memset(&trace_image.header, 0, sizeof(trace_image.header));
+	trace_image.header.magic = TRACE_MAGIC;
+	trace_image.header.version = TRACE_VERSION;
+	trace_image.header.record_header_size = TRACE_RECORD_HEADER_SIZE;
+	trace_image.header.ring_size = TRACE_RING_SIZE;
+	trace_image.header.tick_frequency = timebaseGetFrequency();
+	trace_image.header.boot_size = TRACE_BOOT_SIZE;
+#endif
+}
+
+void traceRecord(const struct gecko_cmd_packet *evt)
+{
+#if INCLUDE_TRACE
+	trace_header_t *header = &trace_image.header;
+	uint8_t *ring = &trace_image.ring[TRACE_BOOT_SIZE];
+	uint8_t record[TRACE_RECORD_HEADER_SIZE], bytes[TRACE_RECORD_HEADER_SIZE];
+	uint32_t size = traceRecordSize(evt->header);
+	uint32_t ticks = (uint32_t)timebaseGetTicks();
+	uint32_t offset, oldest;
+
+	record[0] = (uint8_t)ticks;
+	record[1] = (uint8_t)(ticks >> 8);
+	record[2] = (uint8_t)(ticks >> 16);
+	record[3] = (uint8_t)(ticks >> 24);
+	record[4] = (uint8_t)evt->header;
+	record[5] = (uint8_t)(evt->header >> 8);
+	record[6] = (uint8_t)(evt->header >> 16);
+	record[7] = (uint8_t)(evt->header >> 24);
+	record[8] = (GPIO_PinInGet(PB0_Port, PB0_Pin) ? TRACE_INPUT_PB0 : 0) |
+				(GPIO_PinInGet(PB1_Port, PB1_Pin) ? TRACE_INPUT_PB1 : 0) |
+				(GPIO_PinInGet(MOTION_PORT, MOTION_PIN) ? TRACE_INPUT_PIR : 0);
+
+	/* Boot records until the first one that does not fit, the ring after that */
+	if((header->used == 0) && ((TRACE_BOOT_SIZE - header->boot_used) >= size))
+	{
+		memcpy(&trace_image.ring[header->boot_used], record, TRACE_RECORD_HEADER_SIZE);
+		memcpy(&trace_image.ring[header->boot_used + TRACE_RECORD_HEADER_SIZE], &evt->data, size - TRACE_RECORD_HEADER_SIZE);
+		header->boot_used += size;
+		header->records++;
+		return;
+	}
+
+	/* Make room, the size of the oldest record is in its header */
+	while((TRACE_RING_SIZE - TRACE_BOOT_SIZE - header->used) < size)
+	{
+		oldest = (header->head + TRACE_RING_SIZE - TRACE_BOOT_SIZE - header->used) % (TRACE_RING_SIZE - TRACE_BOOT_SIZE);
+		traceRingRead(ring, TRACE_RING_SIZE - TRACE_BOOT_SIZE, oldest, bytes, TRACE_RECORD_HEADER_SIZE);
+		header->used -= traceRecordSize(bytes[4] | (bytes[5] << 8) | (bytes[6] << 16) | ((uint32_t)bytes[7] << 24));
+		header->records--;
+		header->dropped++;
+	}
+	offset = (header->head + TRACE_RECORD_HEADER_SIZE) % (TRACE_RING_SIZE - TRACE_BOOT_SIZE);
+	traceRingWrite(ring, TRACE_RING_SIZE - TRACE_BOOT_SIZE, header->head, record, TRACE_RECORD_HEADER_SIZE);
+	traceRingWrite(ring, TRACE_RING_SIZE - TRACE_BOOT_SIZE, offset, &evt->data, size - TRACE_RECORD_HEADER_SIZE);
+	header->head = (header->head + size) % (TRACE_RING_SIZE - TRACE_BOOT_SIZE);
+	header->used += size;
+	header->records++;
+#else
+	(void)evt;
+#endif
+}
+
+const trace_image_t *traceImage(void)
+{
+#if INCLUDE_TRACE
+	return &trace_image;
+#else
+	return NULL;
+#endif
+}
+
+bool traceRecordRead(const trace_header_t *header, const uint8_t *ring, uint32_t *position, trace_record_t *record)
+{
+	uint8_t bytes[TRACE_RECORD_HEADER_SIZE];
+	uint32_t size, offset, area, left;
+
+	if((header->boot_size > header->ring_size) || (header->boot_used > header->boot_size) ||
+	   (header->used > (header->ring_size - header->boot_size)))
+	{
+		return false;
+	}
+	if(*position < header->boot_used)
+	{
+		offset = *position;
+		area = header->boot_size;
+		left = header->boot_used - *position;
+	}
+	else
+	{
+		/* Offsets in the ring, which starts after the boot records */
+		if((*position - header->boot_used) >= header->used)
+		{
+			return false;
+		}
+		area = header->ring_size - header->boot_size;
+		left = header->used - (*position - header->boot_used);
+		ring += header->boot_size;
+		offset = (header->head + area - header->used + (*position - header->boot_used)) % area;
+	}
+	if(left < TRACE_RECORD_HEADER_SIZE)
+	{
+		return false;
+	}
+	traceRingRead(ring, area, offset, bytes, TRACE_RECORD_HEADER_SIZE);
+	record->ticks = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+	record->header = bytes[4] | (bytes[5] << 8) | (bytes[6] << 16) | ((uint32_t)bytes[7] << 24);
+	record->inputs = bytes[8];
+	size = traceRecordSize(record->header);
+	if(size > left)
+	{
+		return false;
+	}
+	record->len = (uint16_t)(size - TRACE_RECORD_HEADER_SIZE);
+	traceRingRead(ring, area, (offset + TRACE_RECORD_HEADER_SIZE) % area, record->data, record->len);
+	*position += size;
+	return true;
+}
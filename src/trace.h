@@ -0,0 +1,137 @@
+/*
+ * @filename	: trace.h
+ * @description	: This file contains header files for trace.c
+ * @author 		: Pavan Shiralagi
+ * @course      : Internet of Things Embedded Firmware
+ * 				  https://siliconlabs.github.io/Gecko_SDK_Doc/efr32bg13/html/index.html
+ *
+ * Event trace recorder.  main() passes every event it takes from the stack to
+ * traceRecord() before handling it.  The first TRACE_BOOT_SIZE bytes of events
+ * after boot are kept for good, they set up the state the later events depend
+ * on.  The events after them are kept in a RAM ring, the oldest dropped first.
+ * Both hold records of
+ *
+ * 		bytes 0-3	low 32 bits of timebaseGetTicks()
+ * 		bytes 4-7	BGAPI header of the event
+ * 		byte 8		TRACE_INPUT_ bits, input pins read by the handlers
+ * 		then		the event data, BGLIB_MSG_LEN() of the header bytes, at
+ * 					most TRACE_PAYLOAD_MAX
+ *
+ * All values are little endian.  trace_image is both areas with a header that
+ * describes them, the same bytes whether it is saved from RAM with a debugger
+ * (the address and size of trace_image are in the map file) or written by the
+ * host build.  host/ replays a saved image through the application with
+ * friend_sim -r.
+ */
+
+#ifndef SRC_TRACE_H_
+#define SRC_TRACE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "native_gecko.h"
+
+/*******************************************************************************
+ ********************************  DEFINES  ************************************
+ ******************************************************************************/
+
+#ifndef INCLUDE_TRACE
+#define INCLUDE_TRACE				1
+#endif
+/* RAM kept for records, about 200 events of typical size, of which the boot records take TRACE_BOOT_SIZE */
+#ifndef TRACE_RING_SIZE
+#define TRACE_RING_SIZE				4096
+#endif
+#ifndef TRACE_BOOT_SIZE
+#define TRACE_BOOT_SIZE				512
+#endif
+#define TRACE_MAGIC					0x45435254	//"TRCE"
+#define TRACE_VERSION				1
+#define TRACE_RECORD_HEADER_SIZE	9
+#define TRACE_PAYLOAD_MAX			255			//Longer event data is cut, no event of this application is longer
+
+/* Input pins of the record, sampled when the event is recorded */
+#define TRACE_INPUT_PB0				0x01
+#define TRACE_INPUT_PB1				0x02
+#define TRACE_INPUT_PIR				0x04
+
+typedef char trace_ring_size_check[((TRACE_RING_SIZE - TRACE_BOOT_SIZE) >= (4 * (TRACE_RECORD_HEADER_SIZE + TRACE_PAYLOAD_MAX))) ? 1 : -1];
+
+/* Start of trace_image */
+typedef struct
+{
+	uint32_t magic;				//TRACE_MAGIC
+	uint16_t version;			//TRACE_VERSION
+	uint16_t record_header_size;	//TRACE_RECORD_HEADER_SIZE
+	uint32_t ring_size;			//Bytes after this header, the boot records then the ring
+	uint32_t tick_frequency;	//timebaseGetFrequency() of the timestamps
+	uint32_t boot_size;			//Bytes for the boot records, at the start
+	uint32_t boot_used;			//Bytes of boot records
+	uint32_t head;				//Offset in the ring the next record is written at
+	uint32_t used;				//Bytes of records in the ring, the oldest starts used bytes before head
+	uint32_t records;			//Records kept, boot records included
+	uint32_t dropped;			//Oldest records of the ring dropped to make room
+}trace_header_t;
+
+typedef char trace_header_size_check[(sizeof(trace_header_t) == 40) ? 1 : -1];
+
+typedef struct
+{
+	trace_header_t header;
+	uint8_t ring[TRACE_RING_SIZE];
+}trace_image_t;
+
+/* A record read back with traceRecordRead() */
+typedef struct
+{
+	uint32_t ticks;
+	uint32_t header;
+	uint8_t inputs;
+	uint16_t len;				//Bytes in data, BGLIB_MSG_LEN(header) unless it was cut
+	uint8_t data[TRACE_PAYLOAD_MAX];
+}trace_record_t;
+
+/*******************************************************************************
+ **************************    FUNCTION PROTOTYPES    **************************
+ ******************************************************************************/
+
+/**************************************************************************//**
+ * @brief   Empty the boot records and the ring
+ *
+ * @detail  Call after timebaseInit() and gpioInit()
+ *
+ * @return  Void
+ *****************************************************************************/
+void traceInit(void);
+
+/**************************************************************************//**
+ * @brief   Add an event to the boot records, or to the ring once they are full
+ *
+ * @detail  Drops the oldest records of the ring until the event fits.  Called
+ * 			from the main loop only, not from interrupts
+ *
+ * @return  Void
+ *****************************************************************************/
+void traceRecord(const struct gecko_cmd_packet *evt);
+
+/**************************************************************************//**
+ * @brief   The records and their header, to save or dump them
+ *
+ * @return  Pointer to trace_image
+ *****************************************************************************/
+const trace_image_t *traceImage(void);
+
+/**************************************************************************//**
+ * @brief   Read a record of a trace image
+ *
+ * @detail  header and ring are a saved image, which need not have this build's
+ * 			TRACE_RING_SIZE.  *position is 0 for the first boot record and is
+ * 			moved past the record read.  The boot records come first, then the
+ * 			ring from its oldest record
+ *
+ * @return  true if a record was read, false after the newest record or if the
+ * 			record runs past the end of its area
+ *****************************************************************************/
+bool traceRecordRead(const trace_header_t *header, const uint8_t *ring, uint32_t *position, trace_record_t *record);
+
+#endif /* SRC_TRACE_H_ */
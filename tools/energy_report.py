@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""
+Report the energy mode residency from the energy lines of a log (see src/energy.h).
+
+Reads the text log, as printed by the node, decoded by log_decoder.py or
+written by friend_sim -p, from a file or stdin:
+
+    energy_report.py capture.txt
+    log_decoder.py firmware.axf /dev/ttyACM0 | energy_report.py
+    host/build/friend_sim -q -p host/scripts/ward.txt | energy_report.py
+
+The times of a report count from boot, the last report of the log is used.
+With two reports or more, --delta reports the interval between the last two.
+The currents default to those of src/energy.h, --battery and the --em0 to
+--radio options in nA override them, to check what another battery or a
+changed datasheet value does to the estimate.
+
+Each cause is ranked by the current it adds over sleeping in EM2 for the time
+it held the node: the I2C measurement and the log drain hold EM1, the display
+holds EM0, the radio runs at the radio current.  The first cause is the one
+to optimize first.
+"""
+
+import argparse
+import re
+import sys
+
+MODES = ('em0', 'em1', 'em2', 'em3')
+CAUSES = ('i2c', 'display', 'radio', 'log')
+LINE = re.compile(r'energy (modes|causes|estimate) (.*)')
+FIELD = re.compile(r'(\w+)=(\d+)')
+
+# src/energy.h, nA
+CURRENTS = {'em0': 3340000, 'em1': 1340000, 'em2': 1400, 'em3': 1100, 'radio': 8500000}
+BATTERY_MAH = 225
+
+
+def read_reports(stream):
+    """Return the reports of the log in order, each a dict of the fields of its modes and causes lines"""
+    reports = []
+    current = {}
+    for line in stream:
+        match = LINE.search(line)
+        if not match:
+            continue
+        kind, fields = match.groups()
+        values = {key: int(value) for key, value in FIELD.findall(fields)}
+        if kind == 'modes':
+            current = dict(values)
+        elif kind == 'causes' and current:
+            current.update(values)
+            if all(key in current for key in MODES + CAUSES):
+                reports.append(current)
+            current = {}
+    return reports
+
+
+def holding_current(cause, currents):
+    """nA a cause draws over sleeping in EM2 while it holds the node"""
+    if cause == 'display':
+        return currents['em0'] - currents['em2']
+    if cause == 'radio':
+        return currents['radio'] - currents['em2']
+    return currents['em1'] - currents['em2']
+
+
+def report(values, currents, battery_mah, output):
+    total = sum(values[mode] for mode in MODES)
+    if total == 0:
+        output.write('no time in the report\n')
+        return
+    radio = min(values['radio'], values['em1'])
+    charge = {
+        'em0': values['em0'] * currents['em0'],
+        'em1': (values['em1'] - radio) * currents['em1'] + radio * currents['radio'],
+        'em2': values['em2'] * currents['em2'],
+        'em3': values['em3'] * currents['em3'],
+    }
+    average = sum(charge.values()) / total
+
+    output.write('%-8s %12s %8s %12s\n' % ('mode', 'ms', 'time', 'avg uA'))
+    for mode in MODES:
+        output.write('%-8s %12d %7.3f%% %12.3f\n' % (mode.upper(), values[mode], 100.0 * values[mode] / total,
+                                                      charge[mode] / total / 1000.0))
+    output.write('%-8s %12d %8s %12.3f\n\n' % ('total', total, '', average / 1000.0))
+
+    output.write('%-8s %12s %8s %12s\n' % ('cause', 'ms held', 'time', 'adds uA'))
+    ranked = sorted(CAUSES, key=lambda cause: values[cause] * holding_current(cause, currents), reverse=True)
+    for cause in ranked:
+        output.write('%-8s %12d %7.3f%% %12.3f\n' % (cause, values[cause], 100.0 * values[cause] / total,
+                                                      values[cause] * holding_current(cause, currents) / total / 1000.0))
+
+    output.write('\naverage %.3f uA, %.0f h or %.1f days on %d mAh\n' % (average / 1000.0, battery_mah * 1e6 / average,
+                                                                        battery_mah * 1e6 / average / 24.0, battery_mah))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('log', nargs='?', help='text log, stdin if left out')
+    parser.add_argument('--delta', action='store_true', help='report the interval between the last two reports')
+    parser.add_argument('--battery', type=int, default=BATTERY_MAH, help='battery capacity in mAh')
+    for name in sorted(CURRENTS):
+        parser.add_argument('--' + name, type=int, default=CURRENTS[name], help='%s current in nA' % name)
+    args = parser.parse_args()
+
+    if args.log:
+        with open(args.log, errors='replace') as stream:
+            reports = read_reports(stream)
+    else:
+        reports = read_reports(sys.stdin)
+    if not reports:
+        sys.exit('no energy report in the log')
+    values = reports[-1]
+    if args.delta:
+        if len(reports) < 2:
+            sys.exit('--delta needs two reports')
+        values = {key: reports[-1][key] - reports[-2][key] for key in MODES + CAUSES}
+    currents = {name: getattr(args, name) for name in CURRENTS}
+    report(values, currents, args.battery, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+"""
+Decode tokenized log frames (LOG_TOKENIZED 1, see src/log.h) back into text.
+
+The format strings are read from the .log_strings section of the ELF file the
+firmware was built from.  Frames are read from a capture file or a serial port:
+
+    log_decoder.py firmware.axf capture.bin
+    log_decoder.py firmware.axf /dev/ttyACM0
+    cat /dev/ttyACM0 | log_decoder.py firmware.axf
+
+Serial ports must be set to 115200 8N1 raw beforehand, e.g.
+    stty -F /dev/ttyACM0 115200 raw -echo
+"""
+
+import re
+import struct
+import sys
+
+FRAME_SYNC = 0xA5
+MIN_PAYLOAD = 6                     # string id and timestamp
+MAX_PAYLOAD = 6 + 8 * (24 + 1)      # LOG_FRAME_STRING_MAX 24, 8 arguments
+CONVERSION = re.compile(r'%([-0]*)(\d*)(?:\.(\d+))?(hh|h|ll|l|z)?([diuxXcsp%])')
+
+
+def read_log_strings(elf_path):
+    """Return {offset: format string} from the .log_strings section of a 32 bit ELF file"""
+    with open(elf_path, 'rb') as f:
+        elf = f.read()
+    if elf[:4] != b'\x7fELF' or elf[4] != 1:
+        sys.exit('%s is not a 32 bit ELF file' % elf_path)
+    endian = '<' if elf[5] == 1 else '>'
+    shoff, = struct.unpack_from(endian + 'I', elf, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH', elf, 0x2E)
+
+    def section(index):
+        return struct.unpack_from(endian + 'IIIIIIIIII', elf, shoff + index * shentsize)
+
+    names = section(shstrndx)
+    for index in range(shnum):
+        sh_name, _, _, _, sh_offset, sh_size = section(index)[:6]
+        name_start = names[4] + sh_name
+        name = elf[name_start:elf.index(b'\0', name_start)].decode()
+        if name == '.log_strings':
+            data = elf[sh_offset:sh_offset + sh_size]
+            break
+    else:
+        sys.exit('%s has no .log_strings section, build with LOG_TOKENIZED 1' % elf_path)
+
+    strings = {}
+    offset = 0
+    while offset < len(data):
+        end = data.index(b'\0', offset)
+        strings[offset] = data[offset:end].decode('utf-8', 'replace')
+        offset = end + 1
+        while offset < len(data) and data[offset] == 0:
+            offset += 1     # alignment padding between objects
+    return strings
+
+
+def read_varint(payload, pos):
+    value = 0
+    shift = 0
+    while True:
+        byte = payload[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+
+def render(fmt, payload, pos):
+    """Substitute the encoded arguments into fmt, printf style"""
+    out = []
+    last = 0
+    for match in CONVERSION.finditer(fmt):
+        flags, width, precision, length, conv = match.groups()
+        out.append(fmt[last:match.start()])
+        last = match.end()
+        if conv == '%':
+            out.append('%')
+            continue
+        if conv == 's':
+            end = payload.index(0, pos)
+            text = payload[pos:end].decode('utf-8', 'replace')
+            pos = end + 1
+            out.append(('%' + flags + width + ('.' + precision if precision else '') + 's') % text)
+            continue
+        value, pos = read_varint(payload, pos)
+        bits = 64 if length == 'll' else 32
+        value &= (1 << bits) - 1
+        if conv in 'di' and value >> (bits - 1):
+            value -= 1 << bits
+        if conv == 'c':
+            out.append(('%' + flags + width + 'c') % chr(value & 0xFF))
+            continue
+        spec = {'d': 'd', 'i': 'd', 'u': 'd', 'x': 'x', 'X': 'X', 'p': 'x'}[conv]
+        text = ('%' + flags + width + ('.' + precision if precision else '') + spec) % value
+        out.append('0x' + text if conv == 'p' else text)
+    out.append(fmt[last:])
+    return ''.join(out)
+
+
+def decode(strings, stream, output):
+    buf = bytearray()
+    eof = False
+    while not eof:
+        chunk = stream.read(256)
+        eof = not chunk
+        buf.extend(chunk)
+        while True:
+            start = buf.find(bytes([FRAME_SYNC]))
+            if start < 0:
+                buf.clear()
+                break
+            del buf[:start]
+            if len(buf) >= 2 and not MIN_PAYLOAD <= buf[1] <= MAX_PAYLOAD:
+                del buf[:1]     # not a frame start, resynchronize on the next sync byte
+                continue
+            if len(buf) < 2 or len(buf) < buf[1] + 3:
+                if eof and buf:
+                    del buf[:1]     # a sync byte in a truncated frame may hide whole frames after it
+                    continue
+                break
+            length = buf[1]
+            payload = bytes(buf[2:2 + length])
+            checksum = 0
+            for byte in payload:
+                checksum ^= byte
+            if checksum != buf[2 + length]:
+                del buf[:1]
+                continue
+            del buf[:length + 3]
+            string_id, timestamp = struct.unpack_from('<HI', payload)
+            fmt = strings.get(string_id)
+            if fmt is None:
+                output.write('%5u:<unknown string id 0x%04x>\n' % (timestamp, string_id))
+                continue
+            try:
+                text = render(fmt, payload, 6)
+            except (IndexError, ValueError):
+                text = fmt + ' <bad arguments>'
+            output.write('%5u:%s\n' % (timestamp, text))
+            output.flush()
+
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        sys.exit(__doc__)
+    strings = read_log_strings(sys.argv[1])
+    if len(sys.argv) == 3:
+        with open(sys.argv[2], 'rb', buffering=0) as stream:
+            decode(strings, stream, sys.stdout)
+    else:
+        decode(strings, sys.stdin.buffer, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()